@@ -0,0 +1,64 @@
+#include <benchmark/benchmark.h>
+#include "audio_mixer.h"
+#include <vector>
+
+using Format = AudioDecoderBase::Format;
+
+// Samples per channel of one Decode call of a typical 4096 byte audio buffer
+constexpr int frames = 1024;
+
+static void BM_Mix(benchmark::State& state) {
+	const auto format = static_cast<Format>(state.range(0));
+	const int num_channels = static_cast<int>(state.range(1));
+
+	// Big enough for F32/S32 stereo, content does not matter for the timing
+	std::vector<uint8_t> src(frames * 2 * sizeof(float));
+	for (size_t i = 0; i < src.size(); ++i) {
+		src[i] = static_cast<uint8_t>(i * 31);
+	}
+	if (format == Format::F32) {
+		auto* f = reinterpret_cast<float*>(src.data());
+		for (int i = 0; i < frames * 2; ++i) {
+			f[i] = (i % 200) / 100.0f - 1.0f;
+		}
+	}
+
+	std::vector<float> mix(frames * 2);
+	std::vector<int16_t> out(frames * 2);
+
+	for (auto _: state) {
+		std::fill(mix.begin(), mix.end(), 0.0f);
+		for (int i = 0; i < num_channels; ++i) {
+			AudioMixer::Mix(mix.data(), src.data(), frames, format, 2, 0.5f);
+		}
+		AudioMixer::Compress(out.data(), mix.data(), frames * 2, num_channels * 0.5f);
+		benchmark::DoNotOptimize(out.data());
+	}
+}
+
+BENCHMARK(BM_Mix)->ArgsProduct({
+	{
+		static_cast<int>(Format::S8), static_cast<int>(Format::U8),
+		static_cast<int>(Format::S16), static_cast<int>(Format::U16),
+		static_cast<int>(Format::S32), static_cast<int>(Format::U32),
+		static_cast<int>(Format::F32)
+	},
+	{ 1, 8, 33 }
+});
+
+static void BM_MixMono(benchmark::State& state) {
+	std::vector<int16_t> src(frames);
+	for (int i = 0; i < frames; ++i) {
+		src[i] = static_cast<int16_t>(i * 97);
+	}
+	std::vector<float> mix(frames * 2);
+
+	for (auto _: state) {
+		AudioMixer::Mix(mix.data(), reinterpret_cast<const uint8_t*>(src.data()), frames, Format::S16, 1, 0.5f);
+		benchmark::DoNotOptimize(mix.data());
+	}
+}
+
+BENCHMARK(BM_MixMono);
+
+BENCHMARK_MAIN();
@@ -4,6 +4,8 @@
 #include <bitmap.h>
 #include <pixel_format.h>
 #include <transform.h>
+#include <bitmap_tone.h>
+#include <vector>
 
 constexpr auto opacity_100 = Opacity::Opaque();
 constexpr auto opacity_0 = Opacity(0);
@@ -264,6 +266,23 @@ static void BM_HueChangeBlit(benchmark::State& state) {
 
 BENCHMARK(BM_HueChangeBlit);
 
+static void BM_HueChangeBlitPalette(benchmark::State& state) {
+	Bitmap::SetFormat(format);
+	auto dest = Bitmap::Create(320, 240);
+	auto src = Bitmap::Create(320, 240);
+	// Charsets and battlers only use a few colors
+	for (int i = 0; i < 16; ++i) {
+		src->FillRect(Rect(i * 20, 0, 20, 240), Color(i * 16, 255 - i * 16, i * 8, 255));
+	}
+	auto rect = src->GetRect();
+	double hue = 90.0;
+	for (auto _: state) {
+		dest->HueChangeBlit(0, 0, *src, rect, hue);
+	}
+}
+
+BENCHMARK(BM_HueChangeBlitPalette);
+
 static void BM_ToneBlit(benchmark::State& state) {
 	Bitmap::SetFormat(format);
 	auto dest = Bitmap::Create(320, 240);
@@ -277,6 +296,136 @@ static void BM_ToneBlit(benchmark::State& state) {
 
 BENCHMARK(BM_ToneBlit);
 
+static void BM_ToneBlitSaturation(benchmark::State& state) {
+	Bitmap::SetFormat(format);
+	auto dest = Bitmap::Create(320, 240);
+	auto src = Bitmap::Create(320, 240);
+	auto rect = src->GetRect();
+	auto tone = Tone(128,128,128,0);
+	for (auto _: state) {
+		dest->ToneBlit(0, 0, *src, rect, tone, opacity);
+	}
+}
+
+BENCHMARK(BM_ToneBlitSaturation);
+
+static void BM_ToneBlitColorSaturation(benchmark::State& state) {
+	Bitmap::SetFormat(format);
+	auto dest = Bitmap::Create(320, 240);
+	auto src = Bitmap::Create(320, 240);
+	auto rect = src->GetRect();
+	auto tone = Tone(200,50,255,64);
+	for (auto _: state) {
+		dest->ToneBlit(0, 0, *src, rect, tone, opacity);
+	}
+}
+
+BENCHMARK(BM_ToneBlitColorSaturation);
+
+static void BM_ToneBlendFlipEffect(benchmark::State& state) {
+	Bitmap::SetFormat(format);
+	auto dest = Bitmap::Create(320, 240);
+	auto src = Bitmap::Create(320, 240);
+	auto rect = src->GetRect();
+	auto tone = Tone(200,50,255,64);
+	auto flash = Color(255,255,255,128);
+	for (auto _: state) {
+		// What Cache::SpriteEffect does when the effects change
+		auto effect = Bitmap::Create(rect.width, rect.height, true);
+		effect->ToneBlit(0, 0, *src, rect, tone, Opacity::Opaque());
+		effect->BlendBlit(0, 0, *effect, effect->GetRect(), flash, Opacity::Opaque());
+		effect->Flip(true, false);
+		dest->Blit(0, 0, *effect, effect->GetRect(), opacity);
+	}
+}
+
+BENCHMARK(BM_ToneBlendFlipEffect);
+
+static void BM_EffectsToneBlit(benchmark::State& state) {
+	Bitmap::SetFormat(format);
+	auto dest = Bitmap::Create(320, 240);
+	auto src = Bitmap::Create(320, 240);
+	auto rect = src->GetRect();
+	auto tone = Tone(200,50,255,64);
+	auto flash = Color(255,255,255,128);
+	BitmapRef scratch;
+	for (auto _: state) {
+		dest->EffectsToneBlit(0, 0, *src, rect, tone, flash, true, false, opacity, Bitmap::BlendMode::Default, scratch);
+	}
+}
+
+BENCHMARK(BM_EffectsToneBlit);
+
+static void BM_EffectsToneBlitPartial(benchmark::State& state) {
+	Bitmap::SetFormat(format);
+	auto dest = Bitmap::Create(320, 240);
+	auto src = Bitmap::Create(640, 480);
+	auto rect = src->GetRect();
+	auto tone = Tone(200,50,255,64);
+	auto flash = Color(255,255,255,128);
+	BitmapRef scratch;
+	for (auto _: state) {
+		// Only a quarter of the picture is on screen
+		dest->EffectsToneBlit(160, 120, *src, rect, tone, flash, true, false, opacity, Bitmap::BlendMode::Default, scratch);
+	}
+}
+
+BENCHMARK(BM_EffectsToneBlitPartial);
+
+static void BM_ToneRowKernel(benchmark::State& state) {
+	std::vector<uint32_t> pixels(320 * 240, 0x80604020);
+	auto tone = Tone(200,50,255,128);
+	auto fn = BitmapTone::GetRowFunction(format, ImageOpacity::Alpha_8Bit, tone);
+	if (!fn) {
+		state.SkipWithError("No vectorized kernel available");
+		return;
+	}
+	for (auto _: state) {
+		for (int y = 0; y < 240; ++y) {
+			fn(&pixels[y * 320], 320, tone);
+		}
+		benchmark::DoNotOptimize(pixels.data());
+	}
+}
+
+BENCHMARK(BM_ToneRowKernel);
+
+static void BM_ToneRowScalar(benchmark::State& state) {
+	std::vector<uint32_t> pixels(320 * 240, 0x80604020);
+	auto tone = Tone(200,50,255,128);
+
+	// The hard light table rows of Bitmap::ToneBlit
+	uint8_t table[3][256];
+	const int tones[3] = { tone.red, tone.green, tone.blue };
+	for (int c = 0; c < 3; ++c) {
+		for (int j = 0; j < 256; ++j) {
+			int i = tones[c];
+			int res = i <= 128 ? (2 * i * j) / 255 : 255 - 2 * (255 - i) * (255 - j) / 255;
+			table[c][j] = res > 255 ? 255 : res;
+		}
+	}
+
+	const int rs = format.r.shift;
+	const int gs = format.g.shift;
+	const int bs = format.b.shift;
+	const int as = format.a.shift;
+	for (auto _: state) {
+		for (auto& px: pixels) {
+			uint32_t a = (px >> as) & 0xFF;
+			if (a == 0) {
+				continue;
+			}
+			uint32_t r = table[0][(px >> rs) & 0xFF] * a / 255;
+			uint32_t g = table[1][(px >> gs) & 0xFF] * a / 255;
+			uint32_t b = table[2][(px >> bs) & 0xFF] * a / 255;
+			px = (r << rs) | (g << gs) | (b << bs) | (a << as);
+		}
+		benchmark::DoNotOptimize(pixels.data());
+	}
+}
+
+BENCHMARK(BM_ToneRowScalar);
+
 static void BM_BlendBlit(benchmark::State& state) {
 	Bitmap::SetFormat(format);
 	auto dest = Bitmap::Create(320, 240);
@@ -4,6 +4,7 @@
 #include <bitmap.h>
 #include <pixel_format.h>
 #include <cache.h>
+#include <text.h>
 
 const std::string text = "Alex landed a critical hit on Slime!";
 char32_t symbol = '\\';
@@ -30,6 +31,17 @@ static void BM_FontSizeChar(benchmark::State& state) {
 
 BENCHMARK(BM_FontSizeChar);
 
+static void BM_FontSizeCharMiss(benchmark::State& state) {
+	auto font = Font::Default();
+	for (auto _: state) {
+		font->ClearGlyphCache();
+		auto rect = font->GetSize(symbol);
+		(void)rect;
+	}
+}
+
+BENCHMARK(BM_FontSizeCharMiss);
+
 static void BM_vRender(benchmark::State& state) {
 	auto font = Font::Default();
 	for (auto _: state) {
@@ -53,4 +65,45 @@ static void BM_Render(benchmark::State& state) {
 
 BENCHMARK(BM_Render);
 
+static void BM_RenderMiss(benchmark::State& state) {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	auto surface = Bitmap::Create(width, height);
+	auto system = Cache::SystemOrBlack();
+
+	auto font = Font::Default();
+	for (auto _: state) {
+		font->ClearGlyphCache();
+		font->Render(*surface, 0, 0, *system, 0, symbol);
+	}
+}
+
+BENCHMARK(BM_RenderMiss);
+
+static void BM_RenderStr(benchmark::State& state) {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	auto surface = Bitmap::Create(width, height);
+	auto system = Cache::SystemOrBlack();
+
+	auto font = Font::Default();
+	for (auto _: state) {
+		Text::Draw(*surface, 0, 0, *font, *system, 0, text);
+	}
+}
+
+BENCHMARK(BM_RenderStr);
+
+static void BM_RenderStrMiss(benchmark::State& state) {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	auto surface = Bitmap::Create(width, height);
+	auto system = Cache::SystemOrBlack();
+
+	auto font = Font::Default();
+	for (auto _: state) {
+		font->ClearGlyphCache();
+		Text::Draw(*surface, 0, 0, *font, *system, 0, text);
+	}
+}
+
+BENCHMARK(BM_RenderStrMiss);
+
 BENCHMARK_MAIN();
@@ -0,0 +1,61 @@
+#include <benchmark/benchmark.h>
+#include "game_pictures.h"
+#include "player.h"
+
+// Maniac Patch games use thousands of pictures
+constexpr int num_pictures = 2000;
+
+static Game_Pictures MakePictures(int num_moving) {
+	Player::game_config.engine = Player::EngineRpg2k3 | Player::EngineEnglish;
+
+	Game_Pictures pictures;
+	for (int i = 1; i <= num_pictures; ++i) {
+		Game_Pictures::ShowParams params;
+		params.position_x = i % 320;
+		params.position_y = i % 240;
+		pictures.Show(i, params);
+	}
+
+	for (int i = 1; i <= num_moving; ++i) {
+		Game_Pictures::MoveParams params;
+		params.position_x = 320 - i % 320;
+		params.position_y = 240 - i % 240;
+		params.magnify = 200;
+		params.top_trans = 50;
+		params.red = 50;
+		// Long enough to never finish during the benchmark
+		params.duration = -1000000000;
+		pictures.Move(i, params);
+	}
+
+	return pictures;
+}
+
+static void BM_PicturesUpdateMoving(benchmark::State& state) {
+	auto pictures = MakePictures(num_pictures);
+	for (auto _: state) {
+		pictures.Update(false);
+	}
+}
+
+BENCHMARK(BM_PicturesUpdateMoving);
+
+static void BM_PicturesUpdateIdle(benchmark::State& state) {
+	auto pictures = MakePictures(0);
+	for (auto _: state) {
+		pictures.Update(false);
+	}
+}
+
+BENCHMARK(BM_PicturesUpdateIdle);
+
+static void BM_PicturesUpdateFewMoving(benchmark::State& state) {
+	auto pictures = MakePictures(num_pictures / 20);
+	for (auto _: state) {
+		pictures.Update(false);
+	}
+}
+
+BENCHMARK(BM_PicturesUpdateFewMoving);
+
+BENCHMARK_MAIN();
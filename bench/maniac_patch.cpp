@@ -0,0 +1,69 @@
+#include <benchmark/benchmark.h>
+#include <cstring>
+#include "maniac_patch.h"
+#include "game_interpreter.h"
+#include "game_switches.h"
+#include "game_variables.h"
+#include "main_data.h"
+#include <lcf/data.h>
+
+constexpr int max_vars = 1024;
+
+static void init() {
+	lcf::Data::variables.resize(max_vars);
+	lcf::Data::switches.resize(max_vars);
+	Main_Data::game_variables = std::make_unique<Game_Variables>(Game_Variables::min_2k3, Game_Variables::max_2k3);
+	Main_Data::game_variables->SetRange(1, max_vars, 3);
+	Main_Data::game_switches = std::make_unique<Game_Switches>();
+}
+
+// (v[1] + v[2] * 3) * (10 - 4) % max(v[3], 7)
+static std::vector<int32_t> make_expression() {
+	std::vector<uint8_t> bytes = {
+		52, // Mod
+			50, // Mul
+				48, 8, 1, 1, 50, 8, 1, 2, 1, 3, // v[1] + v[2] * 3
+				49, 1, 10, 1, 4, // 10 - 4
+			78, 13, 2, 8, 1, 3, 1, 7 // max(v[3], 7)
+	};
+	while (bytes.size() % 4 != 0) {
+		bytes.push_back(0);
+	}
+	std::vector<int32_t> ops(bytes.size() / 4);
+	std::memcpy(ops.data(), bytes.data(), bytes.size());
+	return ops;
+}
+
+static void BM_InterpretExpression(benchmark::State& state) {
+	init();
+	Game_Interpreter ip;
+	auto ops = make_expression();
+	for (auto _: state) {
+		benchmark::DoNotOptimize(ManiacPatch::InterpretExpression(MakeSpan(ops), ip));
+	}
+}
+
+BENCHMARK(BM_InterpretExpression);
+
+static void BM_ParseExpression(benchmark::State& state) {
+	init();
+	Game_Interpreter ip;
+	auto ops = make_expression();
+	for (auto _: state) {
+		benchmark::DoNotOptimize(ManiacPatch::ParseExpression(MakeSpan(ops), ip));
+	}
+	ManiacPatch::ClearExpressionCache();
+}
+
+BENCHMARK(BM_ParseExpression);
+
+static void BM_CompileExpression(benchmark::State& state) {
+	auto ops = make_expression();
+	for (auto _: state) {
+		benchmark::DoNotOptimize(ManiacPatch::CompileExpression(MakeSpan(ops)));
+	}
+}
+
+BENCHMARK(BM_CompileExpression);
+
+BENCHMARK_MAIN();
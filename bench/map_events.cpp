@@ -0,0 +1,84 @@
+#include <benchmark/benchmark.h>
+#include "event_spatial_index.h"
+#include <vector>
+
+// Typical large map with many NPCs
+constexpr int map_w = 100;
+constexpr int map_h = 100;
+constexpr int num_events = 500;
+
+struct Position {
+	int x;
+	int y;
+};
+
+static std::vector<Position> MakePositions() {
+	std::vector<Position> pos;
+	pos.reserve(num_events);
+	for (int i = 0; i < num_events; ++i) {
+		pos.push_back({ (i * 37) % map_w, (i * 53 + i / 7) % map_h });
+	}
+	return pos;
+}
+
+static EventSpatialIndex MakeIndex(const std::vector<Position>& pos) {
+	EventSpatialIndex index;
+	index.Reset(map_w, map_h, num_events);
+	for (int i = 0; i < num_events; ++i) {
+		index.Update(i, pos[i].x, pos[i].y);
+	}
+	return index;
+}
+
+// Baseline: every collision check visits all events
+static void BM_EventsXYLinear(benchmark::State& state) {
+	auto pos = MakePositions();
+	int i = 0;
+	for (auto _: state) {
+		const auto& target = pos[i];
+		int found = 0;
+		for (auto& p: pos) {
+			found += (p.x == target.x && p.y == target.y);
+		}
+		benchmark::DoNotOptimize(found);
+		i = (i + 1) % num_events;
+	}
+}
+
+BENCHMARK(BM_EventsXYLinear);
+
+static void BM_EventsXYIndex(benchmark::State& state) {
+	auto pos = MakePositions();
+	auto index = MakeIndex(pos);
+	int i = 0;
+	for (auto _: state) {
+		const auto& target = pos[i];
+		int found = 0;
+		for (int slot = index.GetNext(target.x, target.y, -1); slot >= 0; slot = index.GetNext(target.x, target.y, slot)) {
+			++found;
+		}
+		benchmark::DoNotOptimize(found);
+		i = (i + 1) % num_events;
+	}
+}
+
+BENCHMARK(BM_EventsXYIndex);
+
+// One frame where every event takes a step and checks the target tile
+static void BM_EventsStepFrame(benchmark::State& state) {
+	auto pos = MakePositions();
+	auto index = MakeIndex(pos);
+	for (auto _: state) {
+		for (int i = 0; i < num_events; ++i) {
+			auto& p = pos[i];
+			int to_x = (p.x + 1) % map_w;
+			benchmark::DoNotOptimize(index.GetNext(to_x, p.y, -1));
+			p.x = to_x;
+			index.Update(i, p.x, p.y);
+		}
+	}
+}
+
+BENCHMARK(BM_EventsStepFrame);
+
+BENCHMARK_MAIN();
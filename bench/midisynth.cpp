@@ -0,0 +1,116 @@
+#include <benchmark/benchmark.h>
+#include "system.h"
+
+#ifdef WANT_FMMIDI
+
+#include "decoder_fmmidi.h"
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+constexpr int rate = 44100;
+constexpr int song_seconds = 10;
+// Samples per channel of one Decode call of a typical 4096 byte audio buffer
+constexpr int frames = 1024;
+
+struct Event {
+	int frame;
+	uint32_t message;
+};
+
+uint32_t NoteOn(int channel, int key, int velocity) {
+	return 0x90 | channel | (key << 8) | (velocity << 16);
+}
+
+uint32_t NoteOff(int channel, int key) {
+	return 0x80 | channel | (key << 8) | (64 << 16);
+}
+
+uint32_t ProgramChange(int channel, int program) {
+	return 0xC0 | channel | (program << 8);
+}
+
+/**
+ * Generates a song in the style of typical RPG Maker BGMs.
+ *
+ * @param channels melodic channels that play chords
+ * @param notes_per_second chords per second on every channel
+ * @param hold_seconds how long a chord is held before the note off
+ */
+std::vector<Event> MakeSong(int channels, int notes_per_second, float hold_seconds) {
+	std::vector<Event> events;
+	const int programs[] = { 0, 48, 40, 33, 73, 19, 56, 24, 11, 52, 61, 71, 68, 42, 46 };
+
+	for (int ch = 0; ch < channels; ++ch) {
+		int midi_ch = ch < 9 ? ch : ch + 1;
+		events.push_back({ 0, ProgramChange(midi_ch, programs[ch % 15]) });
+	}
+
+	int step = rate / notes_per_second;
+	int hold = static_cast<int>(rate * hold_seconds);
+	for (int frame = 0, n = 0; frame < rate * song_seconds; frame += step, ++n) {
+		for (int ch = 0; ch < channels; ++ch) {
+			int midi_ch = ch < 9 ? ch : ch + 1;
+			int root = 48 + (n * 5 + ch * 7) % 24;
+			for (int key: { root, root + 4, root + 7 }) {
+				events.push_back({ frame, NoteOn(midi_ch, key, 90) });
+				events.push_back({ frame + hold, NoteOff(midi_ch, key) });
+			}
+		}
+		// Kick, snare and hihat
+		events.push_back({ frame, NoteOn(9, n % 2 ? 38 : 36, 110) });
+		events.push_back({ frame, NoteOn(9, 42, 80) });
+	}
+
+	std::stable_sort(events.begin(), events.end(), [](const Event& a, const Event& b) {
+		return a.frame < b.frame;
+	});
+	return events;
+}
+
+const std::vector<Event>& GetSong(int which) {
+	static const std::vector<Event> songs[] = {
+		// Calm town theme
+		MakeSong(2, 2, 0.4f),
+		// Battle theme
+		MakeSong(6, 8, 0.2f),
+		// Orchestral piece with long sustained chords
+		MakeSong(14, 4, 1.5f)
+	};
+	return songs[which];
+}
+
+}
+
+static void BM_FmMidiRender(benchmark::State& state) {
+	const auto& song = GetSong(static_cast<int>(state.range(0)));
+	const int voice_limit = static_cast<int>(state.range(1));
+
+	std::vector<uint8_t> buffer(frames * 2 * sizeof(int16_t));
+
+	for (auto _: state) {
+		FmMidiDecoder dec;
+		dec.SetFormat(rate, AudioDecoderBase::Format::S16, 2);
+		dec.synth->set_voice_limit(voice_limit);
+
+		auto it = song.begin();
+		for (int frame = 0; frame < rate * song_seconds; frame += frames) {
+			for (; it != song.end() && it->frame < frame + frames; ++it) {
+				dec.SendMidiMessage(it->message);
+			}
+			dec.FillBuffer(buffer.data(), static_cast<int>(buffer.size()));
+			benchmark::DoNotOptimize(buffer.data());
+		}
+	}
+
+	// Seconds of audio rendered per second: Above 1 is faster than real time
+	state.counters["realtime"] = benchmark::Counter(
+		static_cast<double>(song_seconds) * state.iterations(), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_FmMidiRender)->ArgsProduct({ { 0, 1, 2 }, { 32, 64, 128 } })->Unit(benchmark::kMillisecond);
+
+#endif
+
+BENCHMARK_MAIN();
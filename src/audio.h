@@ -122,6 +122,19 @@ struct AudioInterface {
 	 */
 	virtual void SE_Play(std::unique_ptr<AudioSeCache> se, int volume, int pitch) = 0;
 
+	/**
+	 * Prepares a sound effect for playback without playing it.
+	 * Backends that mix the sound effects themselves convert the sample to
+	 * their output format, otherwise this does nothing.
+	 *
+	 * @param se se to prepare.
+	 * @param pitch pitch the se will be played with.
+	 */
+	virtual void SE_Preload(std::unique_ptr<AudioSeCache> se, int pitch) {
+		(void)se;
+		(void)pitch;
+	}
+
 	/**
 	 * Stops the currently playing sound effect.
 	 */
@@ -17,13 +17,17 @@
 
 #include "system.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <cstring>
 #include <cassert>
 #include <memory>
 #include "audio_decoder_midi.h"
 #include "audio_generic.h"
 #include "audio_generic_midiout.h"
+#include "audio_mixer.h"
 #include "filefinder.h"
+#include "instrumentation.h"
 #include "output.h"
 
 GenericAudio::BgmChannel GenericAudio::BGM_Channels[nr_of_bgm_channels];
@@ -47,6 +51,7 @@ GenericAudio::GenericAudio(const Game_ConfigAudio& cfg) : AudioInterface(cfg) {
 	for (auto& SE_Channel : SE_Channels) {
 		SE_Channel.id = i++;
 		SE_Channel.decoder.reset();
+		SE_Channel.pcm.reset();
 	}
 	BGM_PlayedOnceIndicator = false;
 	midi_thread.reset();
@@ -190,7 +195,7 @@ void GenericAudio::SE_Play(std::unique_ptr<AudioSeCache> se, int volume, int pit
 	}
 
 	for (auto& SE_Channel : SE_Channels) {
-		if (!SE_Channel.decoder) {
+		if (!SE_Channel.IsUsed()) {
 			//If there is an unused se channel
 			PlayOnChannel(SE_Channel, std::move(se), volume, pitch);
 			return;
@@ -200,6 +205,14 @@ void GenericAudio::SE_Play(std::unique_ptr<AudioSeCache> se, int volume, int pit
 	Output::Debug("Couldn't play {} SE. No free channel available", se->GetName());
 }
 
+void GenericAudio::SE_Preload(std::unique_ptr<AudioSeCache> se, int pitch) {
+	if (!se) {
+		return;
+	}
+
+	se->GetConvertedSeData(pitch, output_format.frequency, output_format.format, output_format.channels);
+}
+
 void GenericAudio::SE_Stop() {
 	for (auto& SE_Channel : SE_Channels) {
 		SE_Channel.stopped = true; //Stop all running sound effects
@@ -287,15 +300,22 @@ bool GenericAudio::PlayOnChannel(SeChannel& chan, std::unique_ptr<AudioSeCache>
 	chan.paused = true; // Pause channel so the audio thread doesn't work on it
 	chan.stopped = false; // Unstop channel so the audio thread doesn't delete it
 
-	chan.decoder = se->CreateSeDecoder();
-	chan.decoder->SetPitch(pitch);
-	chan.decoder->SetFormat(output_format.frequency, output_format.format, output_format.channels);
-	chan.decoder->SetVolume(volume);
+	chan.pcm = se->GetConvertedSeData(pitch, output_format.frequency, output_format.format, output_format.channels);
+	chan.pcm_offset = 0;
+	chan.volume = volume;
+	if (!chan.pcm) {
+		chan.decoder = se->CreateSeDecoder();
+		chan.decoder->SetPitch(pitch);
+		chan.decoder->SetFormat(output_format.frequency, output_format.format, output_format.channels);
+		chan.decoder->SetVolume(volume);
+	}
 	chan.paused = false; // Unpause channel -> Play it.
 	return true;
 }
 
 void GenericAudio::Decode(uint8_t* output_buffer, int buffer_length) {
+	Instrumentation::Zone zone("Audio Decode");
+
 	bool channel_active = false;
 	float total_volume = 0;
 	int samples_per_frame = buffer_length / output_format.channels / 2;
@@ -312,7 +332,8 @@ void GenericAudio::Decode(uint8_t* output_buffer, int buffer_length) {
 	if (scrap_buffer.size() != scrap_buffer_size) {
 		scrap_buffer.resize(scrap_buffer_size);
 	}
-	memset(mixer_buffer.data(), '\0', mixer_buffer.size());
+	// All channels are accumulated, including the first
+	std::fill(mixer_buffer.begin(), mixer_buffer.end(), 0.0f);
 
 	for (unsigned i = 0; i < nr_of_bgm_channels + nr_of_se_channels; i++) {
 		int read_bytes = 0;
@@ -364,9 +385,39 @@ void GenericAudio::Decode(uint8_t* output_buffer, int buffer_length) {
 			SeChannel& currently_mixed_channel = SE_Channels[i - nr_of_bgm_channels];
 			float current_master_volume = cfg.sound_volume.Get() / 100.0f;
 
-			if (currently_mixed_channel.decoder && !currently_mixed_channel.paused) {
+			if (currently_mixed_channel.IsUsed() && !currently_mixed_channel.paused) {
 				if (currently_mixed_channel.stopped) {
 					currently_mixed_channel.decoder.reset();
+					currently_mixed_channel.pcm.reset();
+				} else if (currently_mixed_channel.pcm) {
+					// Already in the output format: Mix straight from the shared sample
+					const auto& pcm = currently_mixed_channel.pcm->buffer;
+					volume = current_master_volume * (currently_mixed_channel.volume / 100.0);
+					frequency = output_format.frequency;
+					sampleformat = output_format.format;
+					channels = output_format.channels;
+					samplesize = AudioDecoder::GetSamplesizeForFormat(sampleformat);
+
+					total_volume += volume;
+
+					size_t bytes_to_read = samplesize * channels * samples_per_frame;
+					size_t remaining = pcm.size() - std::min(pcm.size(), currently_mixed_channel.pcm_offset);
+					read_bytes = static_cast<int>(std::min(bytes_to_read, remaining));
+
+					if (read_bytes <= 0) {
+						currently_mixed_channel.pcm.reset();
+						continue;
+					}
+
+					AudioMixer::Mix(mixer_buffer.data(), pcm.data() + currently_mixed_channel.pcm_offset,
+						read_bytes / (samplesize * channels), sampleformat, channels, volume);
+					channel_active = true;
+
+					currently_mixed_channel.pcm_offset += read_bytes;
+					if (currently_mixed_channel.pcm_offset >= pcm.size()) {
+						// SE are only played once so free the se if finished
+						currently_mixed_channel.pcm.reset();
+					}
 				} else {
 					volume = current_master_volume * (currently_mixed_channel.decoder->GetVolume() / 100.0);
 					currently_mixed_channel.decoder->GetFormat(frequency, sampleformat, channels);
@@ -402,87 +453,20 @@ void GenericAudio::Decode(uint8_t* output_buffer, int buffer_length) {
 		//--------------------------------------------------------------------------------------------------------------------//
 
 		if (channel_used) {
-			for (unsigned ii = 0; ii < (unsigned)(read_bytes / (samplesize * channels)); ii++) {
-
-				float vall = volume;
-				float valr = vall;
-
-				// Convert to floating point
-				switch (sampleformat) {
-					case AudioDecoder::Format::S8:
-						vall *= (((int8_t *) scrap_buffer.data())[ii * channels] / 128.0);
-						valr *= (((int8_t *) scrap_buffer.data())[ii * channels + 1] / 128.0);
-						break;
-					case AudioDecoder::Format::U8:
-						vall *= (((uint8_t *) scrap_buffer.data())[ii * channels] / 128.0 - 1.0);
-						valr *= (((uint8_t *) scrap_buffer.data())[ii * channels + 1] / 128.0 - 1.0);
-						break;
-					case AudioDecoder::Format::S16:
-						vall *= (((int16_t *) scrap_buffer.data())[ii * channels] / 32768.0);
-						valr *= (((int16_t *) scrap_buffer.data())[ii * channels + 1] / 32768.0);
-						break;
-					case AudioDecoder::Format::U16:
-						vall *= (((uint16_t *) scrap_buffer.data())[ii * channels] / 32768.0 - 1.0);
-						valr *= (((uint16_t *) scrap_buffer.data())[ii * channels + 1] / 32768.0 - 1.0);
-						break;
-					case AudioDecoder::Format::S32:
-						vall *= (((int32_t *) scrap_buffer.data())[ii * channels] / 2147483648.0);
-						valr *= (((int32_t *) scrap_buffer.data())[ii * channels + 1] / 2147483648.0);
-						break;
-					case AudioDecoder::Format::U32:
-						vall *= (((uint32_t *) scrap_buffer.data())[ii * channels] / 2147483648.0 - 1.0);
-						valr *= (((uint32_t *) scrap_buffer.data())[ii * channels + 1] / 2147483648.0 - 1.0);
-						break;
-					case AudioDecoder::Format::F32:
-						vall *= (((float *) scrap_buffer.data())[ii * channels]);
-						valr *= (((float *) scrap_buffer.data())[ii * channels + 1]);
-						break;
-				}
-
-				if (!channel_active) {
-					// first channel
-					mixer_buffer[ii * output_format.channels] = vall;
-					if (channels > 1) {
-						mixer_buffer[ii * output_format.channels + 1] = valr;
-					} else {
-						mixer_buffer[ii * output_format.channels + 1] = mixer_buffer[ii * output_format.channels];
-					}
-				} else {
-					mixer_buffer[ii * output_format.channels] += vall;
-					if (channels > 1) {
-						mixer_buffer[ii * output_format.channels + 1] += valr;
-					} else {
-						mixer_buffer[ii * output_format.channels + 1] = mixer_buffer[ii * output_format.channels];
-					}
-				}
-
-			}
+			int frames = read_bytes / (samplesize * channels);
+			AudioMixer::Mix(mixer_buffer.data(), scrap_buffer.data(), frames, sampleformat, channels, volume);
 			channel_active = true;
 		}
 	}
 
 	if (channel_active) {
-		if (total_volume > 1.0) {
-			float threshold = 0.8;
-			for (unsigned i = 0; i < (unsigned)(samples_per_frame * 2); i++) {
-				float sample = mixer_buffer[i];
-				float sign = (sample < 0) ? -1.0 : 1.0;
-				sample /= sign;
-				//dynamic range compression
-				if (sample > threshold) {
-					sample_buffer[i] = sign * 32768.0 * (threshold + (1.0 - threshold) * (sample - threshold) / (total_volume - threshold));
-				} else {
-					sample_buffer[i] = sign * sample * 32768.0;
-				}
-			}
+		if (reinterpret_cast<uintptr_t>(output_buffer) % alignof(int16_t) == 0) {
+			// Convert directly into the output
+			AudioMixer::Compress(reinterpret_cast<int16_t*>(output_buffer), mixer_buffer.data(), samples_per_frame * 2, total_volume);
 		} else {
-			//No dynamic range compression necessary
-			for (unsigned i = 0; i < (unsigned)(samples_per_frame * 2); i++) {
-				sample_buffer[i] = mixer_buffer[i] * 32768.0;
-			}
+			AudioMixer::Compress(sample_buffer.data(), mixer_buffer.data(), samples_per_frame * 2, total_volume);
+			memcpy(output_buffer, sample_buffer.data(), buffer_length);
 		}
-
-		memcpy(output_buffer, sample_buffer.data(), buffer_length);
 	} else {
 		memset(output_buffer, '\0', buffer_length);
 	}
@@ -546,3 +530,7 @@ void GenericAudio::BgmChannel::SetPitch(int pitch) {
 bool GenericAudio::BgmChannel::IsUsed() const {
 	return decoder || midi_out_used;
 }
+
+bool GenericAudio::SeChannel::IsUsed() const {
+	return decoder || pcm;
+}
@@ -57,6 +57,7 @@ public:
 	std::string BGM_GetType() const override;
 
 	void SE_Play(std::unique_ptr<AudioSeCache> se, int volume, int pitch) override;
+	void SE_Preload(std::unique_ptr<AudioSeCache> se, int pitch) override;
 	void SE_Stop() override;
 	virtual void Update() override;
 
@@ -87,8 +88,13 @@ private:
 	struct SeChannel {
 		int id;
 		std::unique_ptr<AudioDecoderBase> decoder;
+		/** Sample in the output format, mixed directly instead of using a decoder */
+		AudioSeRef pcm;
+		size_t pcm_offset = 0;
+		int volume = 100;
 		bool paused;
 		bool stopped;
+		bool IsUsed() const;
 	};
 	struct Format {
 		int frequency;
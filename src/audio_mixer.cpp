@@ -0,0 +1,202 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include <cassert>
+#include <cstring>
+#include "audio_mixer.h"
+
+#if defined(__GNUC__) || defined(__clang__)
+#  define EP_MIXER_VECTOR
+#endif
+
+namespace {
+	/**
+	 * Scale and bias that convert a sample to the range -1.0 to 1.0:
+	 * value = sample * scale + bias
+	 */
+	template <typename T> struct SampleTraits;
+
+	template <> struct SampleTraits<int8_t> {
+		static constexpr float scale = 1.0f / 128.0f;
+		static constexpr float bias = 0.0f;
+	};
+	template <> struct SampleTraits<uint8_t> {
+		static constexpr float scale = 1.0f / 128.0f;
+		static constexpr float bias = -1.0f;
+	};
+	template <> struct SampleTraits<int16_t> {
+		static constexpr float scale = 1.0f / 32768.0f;
+		static constexpr float bias = 0.0f;
+	};
+	template <> struct SampleTraits<uint16_t> {
+		static constexpr float scale = 1.0f / 32768.0f;
+		static constexpr float bias = -1.0f;
+	};
+	template <> struct SampleTraits<int32_t> {
+		static constexpr float scale = 1.0f / 2147483648.0f;
+		static constexpr float bias = 0.0f;
+	};
+	template <> struct SampleTraits<uint32_t> {
+		static constexpr float scale = 1.0f / 2147483648.0f;
+		static constexpr float bias = -1.0f;
+	};
+	template <> struct SampleTraits<float> {
+		static constexpr float scale = 1.0f;
+		static constexpr float bias = 0.0f;
+	};
+
+#ifdef EP_MIXER_VECTOR
+	// 4 samples, one SSE2 or NEON register
+	using f32x4 = float __attribute__((vector_size(16)));
+	using i32x4 = int32_t __attribute__((vector_size(16)));
+	using i16x4 = int16_t __attribute__((vector_size(8)));
+
+	template <typename T> struct Vec4 {
+		typedef T type __attribute__((vector_size(4 * sizeof(T))));
+	};
+#endif
+
+	template <typename T>
+	void MixStereo(float* mix, const T* src, int frames, float gain, float bias) {
+		const int samples = frames * 2;
+		int i = 0;
+
+#ifdef EP_MIXER_VECTOR
+		for (; i + 4 <= samples; i += 4) {
+			typename Vec4<T>::type in;
+			std::memcpy(&in, src + i, sizeof(in));
+			f32x4 acc;
+			std::memcpy(&acc, mix + i, sizeof(acc));
+			acc += __builtin_convertvector(in, f32x4) * gain + bias;
+			std::memcpy(mix + i, &acc, sizeof(acc));
+		}
+#endif
+
+		for (; i < samples; ++i) {
+			mix[i] += src[i] * gain + bias;
+		}
+	}
+
+	template <typename T>
+	void MixMono(float* mix, const T* src, int frames, float gain, float bias) {
+		for (int i = 0; i < frames; ++i) {
+			const float value = src[i] * gain + bias;
+			mix[i * 2] += value;
+			mix[i * 2 + 1] += value;
+		}
+	}
+
+	template <typename T>
+	void MixStrided(float* mix, const T* src, int frames, int channels, float gain, float bias) {
+		for (int i = 0; i < frames; ++i) {
+			mix[i * 2] += src[i * channels] * gain + bias;
+			mix[i * 2 + 1] += src[i * channels + 1] * gain + bias;
+		}
+	}
+
+	template <typename T>
+	void MixFormat(float* mix, const uint8_t* src, int frames, int channels, float volume) {
+		const T* samples = reinterpret_cast<const T*>(src);
+		const float gain = volume * SampleTraits<T>::scale;
+		const float bias = volume * SampleTraits<T>::bias;
+
+		if (channels == 2) {
+			MixStereo<T>(mix, samples, frames, gain, bias);
+		} else if (channels == 1) {
+			MixMono<T>(mix, samples, frames, gain, bias);
+		} else {
+			MixStrided<T>(mix, samples, frames, channels, gain, bias);
+		}
+	}
+
+	inline int16_t ToSample(float value) {
+		value *= 32768.0f;
+		value = value > 32767.0f ? 32767.0f : value;
+		value = value < -32768.0f ? -32768.0f : value;
+		return static_cast<int16_t>(value);
+	}
+}
+
+void AudioMixer::Mix(float* mix, const uint8_t* src, int frames, AudioDecoderBase::Format format, int channels, float volume) {
+	assert(channels > 0);
+
+	using Format = AudioDecoderBase::Format;
+
+	switch (format) {
+		case Format::S8:
+			MixFormat<int8_t>(mix, src, frames, channels, volume);
+			break;
+		case Format::U8:
+			MixFormat<uint8_t>(mix, src, frames, channels, volume);
+			break;
+		case Format::S16:
+			MixFormat<int16_t>(mix, src, frames, channels, volume);
+			break;
+		case Format::U16:
+			MixFormat<uint16_t>(mix, src, frames, channels, volume);
+			break;
+		case Format::S32:
+			MixFormat<int32_t>(mix, src, frames, channels, volume);
+			break;
+		case Format::U32:
+			MixFormat<uint32_t>(mix, src, frames, channels, volume);
+			break;
+		case Format::F32:
+			MixFormat<float>(mix, src, frames, channels, volume);
+			break;
+	}
+}
+
+void AudioMixer::Compress(int16_t* dst, const float* mix, int samples, float total_volume) {
+	// Dynamic range compression of samples above the threshold when the channels
+	// can overload the output. Otherwise ratio is 1 and the samples are unchanged.
+	constexpr float threshold = 0.8f;
+	const float ratio = total_volume > 1.0f ? (1.0f - threshold) / (total_volume - threshold) : 1.0f;
+	int i = 0;
+
+#ifdef EP_MIXER_VECTOR
+	for (; i + 4 <= samples; i += 4) {
+		f32x4 sample;
+		std::memcpy(&sample, mix + i, sizeof(sample));
+
+		// Compress the magnitude, the sign bit is restored afterwards
+		const i32x4 sign = (i32x4)sample & (int32_t)0x80000000;
+		const f32x4 magnitude = (f32x4)((i32x4)sample & 0x7FFFFFFF);
+		const f32x4 compressed = threshold + (magnitude - threshold) * ratio;
+		const i32x4 above = magnitude > threshold;
+		f32x4 value = (f32x4)((((i32x4)compressed & above) | ((i32x4)magnitude & ~above)) | sign);
+
+		value *= 32768.0f;
+		const i32x4 over = value > 32767.0f;
+		const i32x4 under = value < -32768.0f;
+		i32x4 res = __builtin_convertvector(value, i32x4);
+		res = (res & ~over) | (over & 32767);
+		res = (res & ~under) | (under & -32768);
+
+		const i16x4 out = __builtin_convertvector(res, i16x4);
+		std::memcpy(dst + i, &out, sizeof(out));
+	}
+#endif
+
+	for (; i < samples; ++i) {
+		const float sample = mix[i];
+		const float magnitude = sample < 0.0f ? -sample : sample;
+		const float compressed = magnitude > threshold ? threshold + (magnitude - threshold) * ratio : magnitude;
+		dst[i] = ToSample(sample < 0.0f ? -compressed : compressed);
+	}
+}
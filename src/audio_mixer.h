@@ -0,0 +1,60 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_AUDIO_MIXER_H
+#define EP_AUDIO_MIXER_H
+
+// Headers
+#include <cstdint>
+#include "audio_decoder_base.h"
+
+/**
+ * Mixing kernels of GenericAudio.
+ *
+ * The mix buffer contains interleaved stereo float samples. The sample format
+ * is resolved once per channel, the per-sample loops only convert, scale and
+ * accumulate and are written to be vectorized by the compiler.
+ */
+namespace AudioMixer {
+	/**
+	 * Converts the frames of one channel to float and mixes them into the mix buffer.
+	 * Mono channels are mixed into both output channels, of channels with more
+	 * than 2 channels only the first two are used.
+	 *
+	 * @param mix stereo mix buffer, must hold 2 * frames samples
+	 * @param src decoded samples
+	 * @param frames amount of frames in src
+	 * @param format sample format of src
+	 * @param channels amount of channels in src
+	 * @param volume volume of the channel (1.0 = full volume)
+	 */
+	void Mix(float* mix, const uint8_t* src, int frames, AudioDecoderBase::Format format, int channels, float volume);
+
+	/**
+	 * Converts the mix buffer to signed 16 bit samples.
+	 * When the summed volume of the channels exceeds 1.0, dynamic range
+	 * compression is applied to samples above a threshold.
+	 *
+	 * @param dst output samples
+	 * @param mix mix buffer
+	 * @param samples amount of samples (frames * 2)
+	 * @param total_volume sum of the volumes of all mixed channels
+	 */
+	void Compress(int16_t* dst, const float* mix, int samples, float total_volume);
+}
+
+#endif
@@ -18,53 +18,125 @@
 // Headers
 #include <cassert>
 #include <cstring>
-#include <map>
+#include <list>
 #include <memory>
-#include <set>
+#include <unordered_map>
 #include "audio_resampler.h"
 #include "audio_secache.h"
 #include "game_clock.h"
 #include "filefinder.h"
 #include "output.h"
 
-using namespace std::chrono_literals;
-
 namespace {
-	typedef std::map<std::string, AudioSeRef> cache_type;
+	struct CacheItem {
+		std::string name;
+		/** Decoded sample in the format of the file */
+		AudioSeRef se;
+		/** Versions of the sample converted to an output format and pitch */
+		std::vector<AudioSeRef> converted;
+		size_t size = 0;
+
+		bool IsInUse() const {
+			if (se.use_count() > 1) {
+				return true;
+			}
+			for (auto& conv: converted) {
+				if (conv.use_count() > 1) {
+					return true;
+				}
+			}
+			return false;
+		}
+	};
+
+	/** LRU list of the sound effects, the front is the most recently used entry */
+	using list_type = std::list<CacheItem>;
 
-	cache_type cache;
+	list_type lru;
+	std::unordered_map<std::string, list_type::iterator> cache_index;
 
-	constexpr int cache_limit = 3 * 1024 * 1024;
-	int cache_size = 0;
+	constexpr size_t cache_limit = 8 * 1024 * 1024;
+	AudioSeCache::Stats stats;
 
+	/**
+	 * Frees unused sound effects, starting at the least recently used end,
+	 * until the cache is within the budget.
+	 */
 	void FreeCacheMemory() {
-		auto cur_time = Game_Clock::GetFrameTime();
+		auto it = lru.end();
+		while (it != lru.begin() && stats.bytes > cache_limit) {
+			--it;
 
-		for (auto it = cache.begin(); it != cache.end(); ) {
-			if (it->second.use_count() > 1) {
+			if (it->IsInUse()) {
 				// SE is currently playing
-				++it;
 				continue;
 			}
 
-			if (cache_size <= cache_limit && cur_time - it->second->last_access < 3s) {
-				// Below memory limit and last access < 3s
-				++it;
-				continue;
-			}
+#ifdef CACHE_DEBUG
+			Output::Debug("SE: Freeing memory of {}", it->name);
+#endif
+
+			stats.bytes -= it->size;
+			--stats.entries;
+			++stats.evictions;
+			cache_index.erase(it->name);
+			it = lru.erase(it);
+		}
 
 #ifdef CACHE_DEBUG
-			Output::Debug("SE: Freeing memory of {}", it->first);
+		Output::Debug("SE cache size: {}", stats.bytes / 1024.0 / 1024);
 #endif
+	}
 
-			cache_size -= it->second->buffer.size();
+	list_type::iterator Find(const std::string& name) {
+		auto it = cache_index.find(name);
+		if (it == cache_index.end()) {
+			return lru.end();
+		}
+		return it->second;
+	}
 
-			it = cache.erase(it);
+	/**
+	 * Returns the cache entry of the SE and marks it as most recently used.
+	 * When not cached yet the sample is decoded without any resampling.
+	 *
+	 * @param name Cache entry name
+	 * @param decoder Decoder of the file, only used when not cached
+	 * @return cache entry
+	 */
+	list_type::iterator Fetch(const std::string& name, AudioDecoderBase* decoder) {
+		auto it = Find(name);
+		if (it != lru.end()) {
+			++stats.hits;
+			it->se->last_access = Game_Clock::GetFrameTime();
+			lru.splice(lru.begin(), lru, it);
+			return it;
 		}
 
+		assert(decoder);
+
+		auto se = std::make_shared<AudioSeData>();
+		decoder->GetFormat(se->frequency, se->format, se->channels);
+		se->buffer = decoder->DecodeAll();
+		se->last_access = Game_Clock::GetFrameTime();
+
+		CacheItem item;
+		item.name = name;
+		item.size = se->buffer.size();
+		item.se = std::move(se);
+
+		++stats.misses;
+		++stats.entries;
+		stats.bytes += item.size;
+
+		lru.push_front(std::move(item));
+		cache_index.emplace(name, lru.begin());
+
 #ifdef CACHE_DEBUG
-		Output::Debug("SE cache size: {}", cache_size / 1024.0 / 1024);
+		Output::Debug("SE cache size (Add): {}", stats.bytes / 1024.0 / 1024.0);
 #endif
+
+		return lru.begin();
 	}
 }
 
@@ -72,8 +144,7 @@ std::unique_ptr<AudioSeCache> AudioSeCache::Create(Filesystem_Stream::InputStrea
 	auto se = std::make_unique<AudioSeCache>();
 	se->name = ToString(name);
 
-	auto const it = cache.find(ToString(name));
-	if (it == cache.end()) {
+	if (Find(se->name) == lru.end()) {
 		// Not in cache
 		if (!stream) {
 			return {};
@@ -111,8 +182,7 @@ std::unique_ptr<AudioSeCache> AudioSeCache::GetCachedSe(StringView name) {
 	auto se = std::make_unique<AudioSeCache>();
 	se->name = ToString(name);
 
-	auto const it = cache.find(se->name);
-	if (it == cache.end()) {
+	if (Find(se->name) == lru.end()) {
 		return {};
 	}
 
@@ -120,12 +190,12 @@ std::unique_ptr<AudioSeCache> AudioSeCache::GetCachedSe(StringView name) {
 }
 
 bool AudioSeCache::GetCachedFormat(int& frequency, AudioDecoder::Format& format, int& channels) const {
-	cache_type::const_iterator it = cache.find(name);
+	auto it = Find(name);
 
-	if (it != cache.end()) {
-		frequency = (*it).second->frequency;
-		format = (*it).second->format;
-		channels = (*it).second->channels;
+	if (it != lru.end()) {
+		frequency = it->se->frequency;
+		format = it->se->format;
+		channels = it->se->channels;
 
 		return true;
 	}
@@ -134,62 +204,88 @@ bool AudioSeCache::GetCachedFormat(int& frequency, AudioDecoder::Format& format,
 }
 
 std::unique_ptr<AudioDecoderBase> AudioSeCache::CreateSeDecoder() {
-	AudioSeRef se;
-
-	auto it = cache.find(name);
-	if (it != cache.end()) {
-		se = it->second;
-		se->last_access = Game_Clock::GetFrameTime();
+	AudioSeRef se = Fetch(name, audio_decoder.get())->se;
+	FreeCacheMemory();
 
-		std::unique_ptr<AudioDecoderBase> dec = std::make_unique<AudioSeDecoder>(se);
+	std::unique_ptr<AudioDecoderBase> dec = std::make_unique<AudioSeDecoder>(se);
 #ifdef USE_AUDIO_RESAMPLER
-		dec = std::make_unique<AudioResampler>(std::move(dec));
+	dec = std::make_unique<AudioResampler>(std::move(dec));
 #endif
-		Filesystem_Stream::InputStream is;
-		dec->Open(std::move(is));
-		return dec;
-	}
+	Filesystem_Stream::InputStream is;
+	dec->Open(std::move(is));
+	return dec;
+}
 
-	// Not cached yet: Decode the sample without any resampling
+AudioSeRef AudioSeCache::GetConvertedSeData(int pitch, int frequency, AudioDecoder::Format format, int channels) {
+#ifdef USE_AUDIO_RESAMPLER
+	auto it = Fetch(name, audio_decoder.get());
 
-	if (!se) {
-		se.reset(new AudioSeData());
+	for (auto& conv: it->converted) {
+		if (conv->pitch == pitch && conv->frequency == frequency && conv->format == format && conv->channels == channels) {
+			conv->last_access = Game_Clock::GetFrameTime();
+			return conv;
+		}
 	}
 
-	assert(audio_decoder);
-
-	audio_decoder->GetFormat(se->frequency, se->format, se->channels);
-	se->buffer = audio_decoder->DecodeAll();
+	// Run the resampler once over the whole sample
+	std::unique_ptr<AudioDecoderBase> dec = std::make_unique<AudioResampler>(std::make_unique<AudioSeDecoder>(it->se));
+	Filesystem_Stream::InputStream is;
+	dec->Open(std::move(is));
+	dec->SetPitch(pitch);
+	dec->SetFormat(frequency, format, channels);
 
-	cache.insert(std::make_pair(name, se));
+	auto conv = std::make_shared<AudioSeData>();
+	dec->GetFormat(conv->frequency, conv->format, conv->channels);
+	if (conv->frequency != frequency || conv->format != format || conv->channels != channels) {
+		return {};
+	}
 
-	cache_size += se->buffer.size();
+	conv->pitch = pitch;
+	conv->buffer = dec->DecodeAll();
+	conv->last_access = Game_Clock::GetFrameTime();
 
-#ifdef CACHE_DEBUG
-	Output::Debug("SE cache size (Add): {}", cache_size / 1024.0 / 1024.0);
-#endif
+	it->converted.push_back(conv);
+	it->size += conv->buffer.size();
+	stats.bytes += conv->buffer.size();
+	++stats.conversions;
 
 	FreeCacheMemory();
 
-	std::unique_ptr<AudioDecoderBase> dec = std::unique_ptr<AudioDecoderBase>(new AudioSeDecoder(se));
-#ifdef USE_AUDIO_RESAMPLER
-	dec = std::unique_ptr<AudioDecoderBase>(new AudioResampler(std::move(dec)));
+	return conv;
+#else
+	(void)pitch;
+	(void)frequency;
+	(void)format;
+	(void)channels;
+	return {};
 #endif
-	Filesystem_Stream::InputStream is;
-	dec->Open(std::move(is));
-	return dec;
 }
 
 AudioSeRef AudioSeCache::GetSeData() const {
-	auto it = cache.find(name);
-	assert(it != cache.end());
+	auto it = Find(name);
+	assert(it != lru.end());
 
-	return it->second;
+	return it->se;
 };
 
 void AudioSeCache::Clear() {
-	cache_size = 0;
-	cache.clear();
+	lru.clear();
+	cache_index.clear();
+	stats.entries = 0;
+	stats.bytes = 0;
+}
+
+AudioSeCache::Stats AudioSeCache::GetStats() {
+	Stats s = stats;
+	s.budget = cache_limit;
+	return s;
+}
+
+void AudioSeCache::DumpStats() {
+	auto s = GetStats();
+	Output::Debug("SE cache: {} hits, {} misses, {} conversions, {} evictions, {} entries, {:.2f}/{:.2f} MiB",
+		s.hits, s.misses, s.conversions, s.evictions, s.entries,
+		s.bytes / 1024.0 / 1024.0, s.budget / 1024.0 / 1024.0);
 }
 
 StringView AudioSeCache::GetName() const {
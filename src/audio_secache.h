@@ -40,6 +40,8 @@ public:
 	int frequency;
 	AudioDecoder::Format format;
 	int channels;
+	/** Pitch that was applied to the buffer, 100 for unconverted samples */
+	int pitch = 100;
 };
 
 typedef std::shared_ptr<AudioSeData> AudioSeRef;
@@ -70,12 +72,31 @@ private:
  * AudioSeCache provides an interface for accessing sound effects.
  * It also provides an automatic cache management, any SE is only decoded
  * once, otherwise returned from the cache.
- * The cache is flushed from recently (>10 seconds by default) unused
- * samples when it reaches the memory limit (5 MB by default).
+ * Besides the decoded sample the cache stores versions that are already
+ * converted to the output format of the mixer, one per pitch.
+ * When the memory budget (8 MB) is exceeded the least recently used samples
+ * that are not playing are freed.
  * Uses an internal AudioDecoder for handling the decoding.
  */
 class AudioSeCache {
 public:
+	struct Stats {
+		/** Lookups served from the cache */
+		uint32_t hits = 0;
+		/** Lookups that had to decode the file */
+		uint32_t misses = 0;
+		/** Samples converted to an output format and pitch */
+		uint32_t conversions = 0;
+		/** Entries removed to stay in the budget */
+		uint32_t evictions = 0;
+		/** Number of cached sound effects */
+		uint32_t entries = 0;
+		/** Size of all cached samples in bytes */
+		size_t bytes = 0;
+		/** Byte budget of the cache */
+		size_t budget = 0;
+	};
+
 	/**
 	 * Opens the passed filename with the internal audio decoder.
 	 *
@@ -125,6 +146,19 @@ public:
 	 */
 	std::unique_ptr<AudioDecoderBase> CreateSeDecoder();
 
+	/**
+	 * Returns the sample converted to the passed format with the pitch applied.
+	 * The conversion is done once per pitch and format, further calls return
+	 * the cached buffer which is shared by all playing instances of the SE.
+	 *
+	 * @param pitch Pitch to apply (100 is normal)
+	 * @param frequency Target frequency
+	 * @param format Target format
+	 * @param channels Target amount of channels
+	 * @return converted sample or nullptr when the conversion is not supported
+	 */
+	AudioSeRef GetConvertedSeData(int pitch, int frequency, AudioDecoder::Format format, int channels);
+
 	/**
 	 * Returns the SE sample data handled by this SeCache.
 	 *
@@ -138,6 +172,12 @@ public:
 	StringView GetName() const;
 
 	static void Clear();
+
+	/** @return Statistics about the cache usage */
+	static Stats GetStats();
+
+	/** Writes the statistics to the debug log */
+	static void DumpStats();
 private:
 	std::unique_ptr<AudioDecoderBase> audio_decoder;
 
@@ -144,3 +144,35 @@ void Background::Draw(Bitmap& dst) {
 		dst.ToneBlit(0, 0, dst, dst.GetRect(), tone_effect, Opacity::Opaque());
 	}
 }
+
+bool Background::GetDamage(Rect& damage) {
+	if (tone_effect != Tone()) {
+		// The tone is applied on the whole screen
+		return false;
+	}
+
+	DamageState state;
+	Rect bounds;
+
+	if (IsVisible() && (bg_bitmap || fg_bitmap)) {
+		if (bg_bitmap) {
+			state.bg_bitmap = bg_bitmap.get();
+			state.bg_revision = bg_bitmap->GetRevision();
+			state.bg_x = Scale(bg_x);
+			state.bg_y = Scale(bg_y);
+		}
+		if (fg_bitmap) {
+			state.fg_bitmap = fg_bitmap.get();
+			state.fg_revision = fg_bitmap->GetRevision();
+			state.fg_x = Scale(fg_x);
+			state.fg_y = Scale(fg_y);
+		}
+		state.shake_x = Main_Data::game_screen->GetShakeOffsetX();
+		state.shake_y = Main_Data::game_screen->GetShakeOffsetY();
+
+		bounds = Rect(0, 0, Player::screen_width, Player::screen_height);
+	}
+
+	damage = UpdateDamage(damage_state, state, damage_bounds, bounds);
+	return true;
+}
@@ -20,6 +20,7 @@
 
 // Headers
 #include <string>
+#include <tuple>
 #include "system.h"
 #include "drawable.h"
 #include "async_handler.h"
@@ -31,6 +32,7 @@ public:
 	Background(int terrain_id);
 
 	void Draw(Bitmap& dst) override;
+	bool GetDamage(Rect& damage) override;
 	void Update();
 	Tone GetTone() const;
 	void SetTone(Tone tone);
@@ -39,6 +41,31 @@ private:
 	static void Update(int& rate, int& value);
 	static int Scale(int x);
 
+	/** Everything that affects the output of Draw, for damage tracking */
+	struct DamageState {
+		const Bitmap* bg_bitmap = nullptr;
+		uint32_t bg_revision = 0;
+		int bg_x = 0;
+		int bg_y = 0;
+		const Bitmap* fg_bitmap = nullptr;
+		uint32_t fg_revision = 0;
+		int fg_x = 0;
+		int fg_y = 0;
+		int shake_x = 0;
+		int shake_y = 0;
+
+		auto Tie() const {
+			return std::tie(bg_bitmap, bg_revision, bg_x, bg_y, fg_bitmap, fg_revision, fg_x, fg_y, shake_x, shake_y);
+		}
+
+		bool operator==(const DamageState& other) const {
+			return Tie() == other.Tie();
+		}
+	};
+
+	DamageState damage_state;
+	Rect damage_bounds;
+
 	void OnBackgroundGraphicReady(FileRequestResult* result);
 	void OnForegroundFrameGraphicReady(FileRequestResult* result);
 
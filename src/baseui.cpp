@@ -68,6 +68,20 @@ void BaseUi::CleanDisplay() {
 	main_surface->Clear();
 }
 
+void BaseUi::SetDisplayDamage(Rect damage) {
+	display_damage = damage;
+	has_display_damage = true;
+}
+
+Rect BaseUi::TakeDisplayDamage() {
+	if (!has_display_damage) {
+		return main_surface->GetRect();
+	}
+
+	has_display_damage = false;
+	return display_damage;
+}
+
 void BaseUi::SetGameResolution(GameResolution resolution) {
 	vcfg.game_resolution.Set(resolution);
 }
@@ -190,6 +190,21 @@ public:
 	/** @return true if the display manages the framerate */
 	bool IsFrameRateSynchronized() const;
 
+	/** @return true if only the changed parts of the screen are redrawn */
+	bool IsRetainedRender() const;
+
+	/** @return true if frames are presented while the game logic runs on the simulation thread */
+	bool IsThreadedRender() const;
+
+	/**
+	 * Sets the part of the display surface that changed since the last frame.
+	 * Implementations of UpdateDisplay can use this to only upload the changed part.
+	 * When not set before UpdateDisplay the whole surface is considered changed.
+	 *
+	 * @param damage changed area, empty when nothing changed
+	 */
+	void SetDisplayDamage(Rect damage);
+
 	/** @return true if we should render the fps counter to the screen */
 	bool RenderFps() const;
 
@@ -253,6 +268,13 @@ protected:
 	virtual void vGetConfig(Game_ConfigVideo& cfg) const = 0;
 	virtual bool vChangeDisplaySurfaceResolution(int new_width, int new_height);
 
+	/**
+	 * Called by UpdateDisplay implementations.
+	 *
+	 * @return part of the display surface that changed, resets it to the whole surface
+	 */
+	Rect TakeDisplayDamage();
+
 	Game_ConfigVideo vcfg;
 
 	/**
@@ -276,6 +298,10 @@ protected:
 	/** Surface used for zoom. */
 	BitmapRef main_surface;
 
+	/** Part of main_surface that changed since the last UpdateDisplay. */
+	Rect display_damage;
+	bool has_display_damage = false;
+
 	/** Mouse position on screen relative to the window. */
 	Point mouse_pos;
 
@@ -369,6 +395,14 @@ inline std::array<Input::TouchInput, 5>& BaseUi::GetTouchInput() {
 	return touch_input;
 }
 
+inline bool BaseUi::IsRetainedRender() const {
+	return vcfg.retained_render.Get();
+}
+
+inline bool BaseUi::IsThreadedRender() const {
+	return vcfg.threaded_render.Get();
+}
+
 inline bool BaseUi::RenderFps() const {
 	return vcfg.show_fps.Get() && (IsFullscreen() || vcfg.fps_render_window.Get());
 }
@@ -234,6 +234,10 @@ BattleAnimationMap::BattleAnimationMap(const lcf::rpg::Animation& anim, Game_Cha
 {
 }
 
+bool BattleAnimation::GetDamage(Rect&) {
+	return false;
+}
+
 void BattleAnimationMap::Draw(Bitmap& dst) {
 	if (IsOnlySound()) {
 		return;
@@ -49,6 +49,9 @@ public:
 	/** @return the number of frames in the underlying animation **/
 	int GetRealFrames() const;
 
+	/** The drawing state is calculated in Draw, damage is not tracked */
+	bool GetDamage(Rect& damage) override;
+
 	/**
 	 * Set the current running frame
 	 *
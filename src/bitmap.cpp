@@ -20,12 +20,14 @@
 #include <cstdlib>
 #include <cstring>
 #include <algorithm>
+#include <array>
 #include <iostream>
 #include <unordered_map>
 
 #include "utils.h"
 #include "cache.h"
 #include "bitmap.h"
+#include "bitmap_tone.h"
 #include "filefinder.h"
 #include "options.h"
 #include <lcf/data.h>
@@ -300,6 +302,7 @@ Color Bitmap::GetColorAt(int x, int y) const {
 }
 
 void Bitmap::HueChangeBlit(int x, int y, Bitmap const& src, Rect const& src_rect_, double hue_) {
+	++revision;
 	Rect dst_rect(x, y, 0, 0), src_rect = src_rect_;
 
 	if (!Rect::AdjustRectangles(src_rect, dst_rect, src.GetRect()))
@@ -314,26 +317,44 @@ void Bitmap::HueChangeBlit(int x, int y, Bitmap const& src, Rect const& src_rect
 		hue -= (hue / 0x600) * 0x600;
 
 	DynamicFormat format(32,8,24,8,16,8,8,8,0,PF::Alpha);
-	std::vector<uint32_t> pixels;
-	pixels.resize(src_rect.width * src_rect.height);
+	// Reused between calls to avoid an allocation per blit
+	thread_local std::vector<uint32_t> pixels;
+	pixels.assign(src_rect.width * src_rect.height, 0);
 	Bitmap bmp(reinterpret_cast<void*>(&pixels.front()), src_rect.width, src_rect.height, src_rect.width * 4, format);
 	bmp.Blit(0, 0, src, src_rect, Opacity::Opaque());
 
-	for (std::vector<uint32_t>::iterator p = pixels.begin(); p != pixels.end(); ++p) {
-		uint32_t pixel = *p;
-		uint8_t r = (pixel>>24) & 0xFF;
-		uint8_t g = (pixel>>16) & 0xFF;
-		uint8_t b = (pixel>> 8) & 0xFF;
-		uint8_t a = pixel & 0xFF;
-		if (a > 0)
+	// RPG Maker graphics use few colors, the HSL conversion is cached per color.
+	// Key is the RGB part of the pixel, 0xFFFFFFFF marks an unused entry.
+	struct HueCacheEntry {
+		uint32_t key;
+		uint32_t rgb;
+	};
+	std::array<HueCacheEntry, 256> hue_cache;
+	hue_cache.fill({ 0xFFFFFFFF, 0 });
+
+	for (auto& pixel: pixels) {
+		const uint32_t a = pixel & 0xFF;
+		if (a == 0) {
+			continue;
+		}
+
+		const uint32_t key = pixel >> 8;
+		auto& entry = hue_cache[(key * 2654435761u) >> 24];
+		if (entry.key != key) {
+			uint8_t r = (pixel >> 24) & 0xFF;
+			uint8_t g = (pixel >> 16) & 0xFF;
+			uint8_t b = (pixel >> 8) & 0xFF;
 			RGB_adjust_HSL(r, g, b, hue);
-		*p = ((uint32_t) r << 24) | ((uint32_t) g << 16) | ((uint32_t) b << 8) | (uint32_t) a;
+			entry = { key, ((uint32_t) r << 16) | ((uint32_t) g << 8) | (uint32_t) b };
+		}
+		pixel = (entry.rgb << 8) | a;
 	}
 
 	Blit(dst_rect.x, dst_rect.y, bmp, bmp.GetRect(), Opacity::Opaque());
 }
 
 Point Bitmap::TextDraw(Rect const& rect, int color, StringView text, Text::Alignment align) {
+	++revision;
 	FontRef font = Font::Default();
 
 	switch (align) {
@@ -359,12 +380,14 @@ Point Bitmap::TextDraw(Rect const& rect, int color, StringView text, Text::Align
 }
 
 Point Bitmap::TextDraw(int x, int y, int color, StringView text, Text::Alignment align) {
+	++revision;
 	auto font = Font::Default();
 	auto system = Cache::SystemOrBlack();
 	return Text::Draw(*this, x, y, *font, *system, color, text, align);
 }
 
 Point Bitmap::TextDraw(Rect const& rect, Color color, StringView text, Text::Alignment align) {
+	++revision;
 	FontRef font = Font::Default();
 
 	switch (align) {
@@ -390,6 +413,7 @@ Point Bitmap::TextDraw(Rect const& rect, Color color, StringView text, Text::Ali
 }
 
 Point Bitmap::TextDraw(int x, int y, Color color, StringView text) {
+	++revision;
 	auto font = Font::Default();
 	return Text::Draw(*this, x, y, *font, color, text);
 }
@@ -556,6 +580,9 @@ void* Bitmap::pixels() {
 		return nullptr;
 	}
 
+	// The caller can modify the pixels
+	++revision;
+
 	return (void*) pixman_image_get_data(bitmap.get());
 }
 void const* Bitmap::pixels() const {
@@ -607,6 +634,7 @@ namespace {
 } // anonymous namespace
 
 void Bitmap::Blit(int x, int y, Bitmap const& src, Rect const& src_rect, Opacity const& opacity, Bitmap::BlendMode blend_mode) {
+	++revision;
 	if (opacity.IsTransparent()) {
 		return;
 	}
@@ -623,6 +651,7 @@ void Bitmap::Blit(int x, int y, Bitmap const& src, Rect const& src_rect, Opacity
 }
 
 void Bitmap::BlitFast(int x, int y, Bitmap const & src, Rect const & src_rect, Opacity const & opacity) {
+	++revision;
 	if (opacity.IsTransparent()) {
 		return;
 	}
@@ -643,10 +672,12 @@ PixmanImagePtr Bitmap::GetSubimage(Bitmap const& src, const Rect& src_rect) {
 }
 
 void Bitmap::TiledBlit(Rect const& src_rect, Bitmap const& src, Rect const& dst_rect, Opacity const& opacity, Bitmap::BlendMode blend_mode) {
+	++revision;
 	TiledBlit(0, 0, src_rect, src, dst_rect, opacity, blend_mode);
 }
 
 void Bitmap::TiledBlit(int ox, int oy, Rect const& src_rect, Bitmap const& src, Rect const& dst_rect, Opacity const& opacity, Bitmap::BlendMode blend_mode) {
+	++revision;
 	if (opacity.IsTransparent()) {
 		return;
 	}
@@ -671,10 +702,12 @@ void Bitmap::TiledBlit(int ox, int oy, Rect const& src_rect, Bitmap const& src,
 }
 
 void Bitmap::StretchBlit(Bitmap const&  src, Rect const& src_rect, Opacity const& opacity, Bitmap::BlendMode blend_mode) {
+	++revision;
 	StretchBlit(GetRect(), src, src_rect, opacity, blend_mode);
 }
 
 void Bitmap::StretchBlit(Rect const& dst_rect, Bitmap const& src, Rect const& src_rect, Opacity const& opacity, Bitmap::BlendMode blend_mode) {
+	++revision;
 	if (opacity.IsTransparent()) {
 		return;
 	}
@@ -699,6 +732,7 @@ void Bitmap::StretchBlit(Rect const& dst_rect, Bitmap const& src, Rect const& sr
 }
 
 void Bitmap::WaverBlit(int x, int y, double zoom_x, double zoom_y, Bitmap const& src, Rect const& src_rect, int depth, double phase, Opacity const& opacity, Bitmap::BlendMode blend_mode) {
+	++revision;
 	if (opacity.IsTransparent()) {
 		return;
 	}
@@ -744,6 +778,7 @@ static pixman_color_t PixmanColor(const Color &color) {
 }
 
 void Bitmap::Fill(const Color &color) {
+	++revision;
 	pixman_color_t pcolor = PixmanColor(color);
 
 	pixman_box32_t box = { 0, 0, width(), height() };
@@ -752,6 +787,7 @@ void Bitmap::Fill(const Color &color) {
 }
 
 void Bitmap::FillRect(Rect const& dst_rect, const Color &color) {
+	++revision;
 	pixman_color_t pcolor = PixmanColor(color);
 
 	auto timage = PixmanImagePtr{pixman_image_create_solid_fill(&pcolor)};
@@ -765,6 +801,11 @@ void Bitmap::FillRect(Rect const& dst_rect, const Color &color) {
 }
 
 void Bitmap::Clear() {
+	if (has_clip) {
+		ClearRect(clip_rect);
+		return;
+	}
+
 	if (!pixels()) {
 		// Happens when height or width of bitmap are 0
 		return;
@@ -774,6 +815,7 @@ void Bitmap::Clear() {
 }
 
 void Bitmap::ClearRect(Rect const& dst_rect) {
+	++revision;
 	pixman_color_t pcolor = {};
 	pixman_box32_t box = {
 		dst_rect.x,
@@ -851,7 +893,32 @@ static inline void color_tone_alpha(uint32_t &src_pixel, const Tone& tone, const
 	src_pixel = ((uint32_t)r << rs) | ((uint32_t)g << gs) | ((uint32_t)b << bs) | ((uint32_t)a << as);
 }
 
+void Bitmap::SetClipRect(Rect const& rect) {
+	clip_rect = rect;
+	clip_rect.Adjust(GetRect());
+	if (clip_rect.IsEmpty()) {
+		clip_rect = Rect();
+	}
+	has_clip = true;
+
+	pixman_region32_t region;
+	pixman_region32_init_rect(&region, clip_rect.x, clip_rect.y, clip_rect.width, clip_rect.height);
+	pixman_image_set_clip_region32(bitmap.get(), &region);
+	pixman_region32_fini(&region);
+}
+
+void Bitmap::ClearClipRect() {
+	if (!has_clip) {
+		return;
+	}
+
+	has_clip = false;
+	clip_rect = Rect();
+	pixman_image_set_clip_region32(bitmap.get(), nullptr);
+}
+
 void Bitmap::ToneBlit(int x, int y, Bitmap const& src, Rect const& src_rect, const Tone &tone, Opacity const& opacity) {
+	++revision;
 	if (opacity.IsTransparent()) {
 		return;
 	}
@@ -900,12 +967,21 @@ void Bitmap::ToneBlit(int x, int y, Bitmap const& src, Rect const& src_rect, con
 	const uint16_t limit_height = std::min<uint16_t>(src_rect.height, height());
 	const uint16_t limit_width = std::min<uint16_t>(src_rect.width, width());
 
+	auto row_function = BitmapTone::GetRowFunction(pixel_format, src_opacity, tone);
+	if (row_function) {
+		for (uint16_t i = 0; i < limit_height; ++i) {
+			pixels += next_row;
+			row_function(pixels, limit_width, tone);
+		}
+		return;
+	}
+
 	const bool apply_sat = tone.gray != 128;
 	const bool apply_tone = (tone.red != 128 || tone.green != 128 || tone.blue != 128);
 
 	// If Saturation + Color:
 	if (apply_sat && apply_tone) {
-		int sat = tone.gray > 128 ? 1024 + (tone.gray - 128) * 16 : tone.gray * 8;
+		int sat = BitmapTone::GetSaturation(tone);
 
 		if (src_opacity == ImageOpacity::Opaque) {
 			for (uint16_t i = 0; i < limit_height; ++i) {
@@ -945,7 +1021,7 @@ void Bitmap::ToneBlit(int x, int y, Bitmap const& src, Rect const& src_rect, con
 
 	// If Only Saturation:
 	else if (apply_sat) {
-		int sat = tone.gray > 128 ? 1024 + (tone.gray - 128) * 16 : tone.gray * 8;
+		int sat = BitmapTone::GetSaturation(tone);
 
 		if (src_opacity == ImageOpacity::Opaque) {
 			for (uint16_t i = 0; i < limit_height; ++i) {
@@ -1007,6 +1083,7 @@ void Bitmap::ToneBlit(int x, int y, Bitmap const& src, Rect const& src_rect, con
 }
 
 void Bitmap::BlendBlit(int x, int y, Bitmap const& src, Rect const& src_rect, const Color& color, Opacity const& opacity) {
+	++revision;
 	if (opacity.IsTransparent()) {
 		return;
 	}
@@ -1036,7 +1113,87 @@ void Bitmap::BlendBlit(int x, int y, Bitmap const& src, Rect const& src_rect, co
 							 src_rect.width, src_rect.height);
 }
 
+void Bitmap::EffectsToneBlit(int x, int y, Bitmap const& src, Rect const& src_rect,
+		const Tone& tone, const Color& flash, bool flip_x, bool flip_y,
+		Opacity const& opacity, Bitmap::BlendMode blend_mode, BitmapRef& scratch) {
+	++revision;
+	if (opacity.IsTransparent()) {
+		return;
+	}
+
+	const Rect dst_rect(x, y, src_rect.width, src_rect.height);
+	Rect visible = dst_rect;
+	visible.Adjust(has_clip ? clip_rect : GetRect());
+	if (visible.IsEmpty()) {
+		return;
+	}
+
+	// The source pixels of the visible area, mirrored when flipped
+	const int dx = visible.x - dst_rect.x;
+	const int dy = visible.y - dst_rect.y;
+	const Rect rect(
+		flip_x ? src_rect.x + src_rect.width - dx - visible.width : src_rect.x + dx,
+		flip_y ? src_rect.y + src_rect.height - dy - visible.height : src_rect.y + dy,
+		visible.width, visible.height);
+	const Rect scratch_rect(0, 0, rect.width, rect.height);
+
+	if (!scratch || scratch->width() < rect.width || scratch->height() < rect.height) {
+		const int w = std::max(rect.width, scratch ? scratch->width() : 0);
+		const int h = std::max(rect.height, scratch ? scratch->height() : 0);
+		scratch = Bitmap::Create(w, h, true);
+	}
+
+	auto* src_img = src.bitmap.get();
+	int src_x = rect.x;
+	int src_y = rect.y;
+
+	if (flip_x || flip_y) {
+		const auto img_w = src.GetWidth();
+		const auto img_h = src.GetHeight();
+
+		Transform xform = Transform::Scale(flip_x ? -1 : 1, flip_y ? -1 : 1);
+		xform *= Transform::Translation(flip_x ? -img_w : 0, flip_y ? -img_h : 0);
+		pixman_image_set_transform(src_img, &xform.matrix);
+
+		src_x = flip_x ? img_w - rect.x - rect.width : rect.x;
+		src_y = flip_y ? img_h - rect.y - rect.height : rect.y;
+	}
+
+	scratch->revision++;
+	pixman_image_composite32(PIXMAN_OP_SRC,
+							 src_img, nullptr, scratch->bitmap.get(),
+							 src_x, src_y,
+							 0, 0,
+							 0, 0,
+							 rect.width, rect.height);
+
+	if (flip_x || flip_y) {
+		pixman_image_set_transform(src_img, nullptr);
+	}
+
+	if (tone != Tone()) {
+		// Lets ToneBlit pick the kernel for the opacity of the source
+		scratch->image_opacity = src.GetImageOpacity();
+		scratch->ToneBlit(0, 0, *scratch, scratch_rect, tone, Opacity::Opaque());
+		scratch->image_opacity = ImageOpacity::Alpha_8Bit;
+	}
+
+	if (flash != Color()) {
+		scratch->BlendBlit(0, 0, *scratch, scratch_rect, flash, Opacity::Opaque());
+	}
+
+	// The bush depth counts from the bottom of the rect
+	Opacity visible_opacity = opacity;
+	if (opacity.IsSplit()) {
+		const int cropped_bottom = (dst_rect.y + dst_rect.height) - (visible.y + visible.height);
+		visible_opacity.split = Utils::Clamp(opacity.split - cropped_bottom, 0, visible.height);
+	}
+
+	Blit(visible.x, visible.y, *scratch, scratch_rect, visible_opacity, blend_mode);
+}
+
 void Bitmap::FlipBlit(int x, int y, Bitmap const& src, Rect const& src_rect, bool horizontal, bool vertical, Opacity const& opacity, Bitmap::BlendMode blend_mode) {
+	++revision;
 	if (opacity.IsTransparent()) {
 		return;
 	}
@@ -1065,6 +1222,7 @@ void Bitmap::FlipBlit(int x, int y, Bitmap const& src, Rect const& src_rect, boo
 }
 
 void Bitmap::Flip(bool horizontal, bool vertical) {
+	++revision;
 	if (!horizontal && !vertical) {
 		return;
 	}
@@ -1089,6 +1247,7 @@ void Bitmap::Flip(bool horizontal, bool vertical) {
 }
 
 void Bitmap::MaskedBlit(Rect const& dst_rect, Bitmap const& mask, int mx, int my, Color const& color) {
+	++revision;
 	pixman_color_t tcolor = {
 		static_cast<uint16_t>(color.red << 8),
 		static_cast<uint16_t>(color.green << 8),
@@ -1106,6 +1265,7 @@ void Bitmap::MaskedBlit(Rect const& dst_rect, Bitmap const& mask, int mx, int my
 }
 
 void Bitmap::MaskedBlit(Rect const& dst_rect, Bitmap const& mask, int mx, int my, Bitmap const& src, int sx, int sy) {
+	++revision;
 	pixman_image_composite32(PIXMAN_OP_OVER,
 							 src.bitmap.get(), mask.bitmap.get(), bitmap.get(),
 							 sx, sy,
@@ -1115,6 +1275,7 @@ void Bitmap::MaskedBlit(Rect const& dst_rect, Bitmap const& mask, int mx, int my
 }
 
 void Bitmap::Blit2x(Rect const& dst_rect, Bitmap const& src, Rect const& src_rect) {
+	++revision;
 	Transform xform = Transform::Scale(0.5, 0.5);
 
 	pixman_image_set_transform(src.bitmap.get(), &xform.matrix);
@@ -1134,6 +1295,7 @@ void Bitmap::EffectsBlit(int x, int y, int ox, int oy,
 						 Opacity const& opacity,
 						 double zoom_x, double zoom_y, double angle,
 						 int waver_depth, double waver_phase, Bitmap::BlendMode blend_mode) {
+	++revision;
 	if (opacity.IsTransparent()) {
 		return;
 	}
@@ -1161,6 +1323,7 @@ void Bitmap::RotateZoomOpacityBlit(int x, int y, int ox, int oy,
 		Bitmap const& src, Rect const& src_rect,
 		double angle, double zoom_x, double zoom_y, Opacity const& opacity, Bitmap::BlendMode blend_mode)
 {
+	++revision;
 	if (opacity.IsTransparent()) {
 		return;
 	}
@@ -1208,6 +1371,7 @@ void Bitmap::ZoomOpacityBlit(int x, int y, int ox, int oy,
 							 double zoom_x, double zoom_y,
 							 Opacity const& opacity, Bitmap::BlendMode blend_mode)
 {
+	++revision;
 	if (opacity.IsTransparent()) {
 		return;
 	}
@@ -1266,6 +1430,7 @@ pixman_op_t Bitmap::GetOperator(pixman_image_t* mask, Bitmap::BlendMode blend_mo
 }
 
 void Bitmap::EdgeMirrorBlit(int x, int y, Bitmap const& src, Rect const& src_rect, bool mirror_x, bool mirror_y, Opacity const& opacity) {
+	++revision;
 	if (opacity.IsTransparent())
 		return;
 
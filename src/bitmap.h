@@ -462,6 +462,28 @@ public:
 	 */
 	void ClearRect(Rect const& dst_rect);
 
+	/**
+	 * Restricts all following drawing operations on this bitmap to a rect.
+	 * ToneBlit and HueChangeBlit modify the destination pixels directly and
+	 * ignore the clip rect.
+	 *
+	 * @param rect clip rect.
+	 */
+	void SetClipRect(Rect const& rect);
+
+	/**
+	 * Removes the clip rect set by SetClipRect.
+	 */
+	void ClearClipRect();
+
+	/**
+	 * The revision is incremented whenever the pixels are modified through
+	 * this class. Used to detect changes without comparing the pixels.
+	 *
+	 * @return revision of the pixel data.
+	 */
+	uint32_t GetRevision() const;
+
 	/**
 	 * Rotates bitmap hue.
 	 *
@@ -497,6 +519,29 @@ public:
 	 */
 	void BlendBlit(int x, int y, Bitmap const& src, Rect const& src_rect, const Color &color, Opacity const& opacity);
 
+	/**
+	 * Blits source bitmap with tone, flash and flip applied.
+	 * Yields the same result as blitting the bitmap created by Cache::SpriteEffect
+	 * but only the part of src_rect that is visible in this bitmap is processed.
+	 * The effects are applied in scratch which avoids allocating a bitmap each
+	 * time the effects change.
+	 *
+	 * @param x x position.
+	 * @param y y position.
+	 * @param src source bitmap.
+	 * @param src_rect source bitmap rect.
+	 * @param tone tone to apply.
+	 * @param flash color to blend.
+	 * @param flip_x flip horizontally (mirror).
+	 * @param flip_y flip vertically.
+	 * @param opacity opacity for blending with bitmap.
+	 * @param blend_mode Blend mode to use.
+	 * @param scratch bitmap used for applying the effects, replaced when too small.
+	 */
+	void EffectsToneBlit(int x, int y, Bitmap const& src, Rect const& src_rect,
+		const Tone& tone, const Color& flash, bool flip_x, bool flip_y,
+		Opacity const& opacity, BlendMode blend_mode, BitmapRef& scratch);
+
 	/**
 	 * Flips the bitmap pixels.
 	 *
@@ -634,6 +679,10 @@ protected:
 	 */
 	pixman_op_t GetOperator(pixman_image_t* mask = nullptr, BlendMode blend_mode = BlendMode::Default) const;
 	bool read_only = false;
+
+	uint32_t revision = 0;
+	Rect clip_rect;
+	bool has_clip = false;
 };
 
 inline ImageOpacity Bitmap::GetImageOpacity() const {
@@ -644,6 +693,10 @@ inline ImageOpacity Bitmap::GetTileOpacity(int x, int y) const {
 	return tile_opacity.Get(x, y);
 }
 
+inline uint32_t Bitmap::GetRevision() const {
+	return revision;
+}
+
 inline Color Bitmap::GetBackgroundColor() const {
 	return bg_color;
 }
@@ -0,0 +1,222 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include <algorithm>
+#include <cstring>
+#include "bitmap_tone.h"
+
+#if defined(__GNUC__) || defined(__clang__)
+#  define EP_TONE_VECTOR
+#endif
+
+// Runtime selection of the AVX2 version, requires ifunc support
+#if defined(EP_TONE_VECTOR) && !defined(__clang__) && defined(__x86_64__) && defined(__linux__) && !defined(__ANDROID__)
+#  define EP_TONE_TARGETS __attribute__((target_clones("avx2", "default")))
+#else
+#  define EP_TONE_TARGETS
+#endif
+
+#ifdef EP_TONE_VECTOR
+
+namespace {
+	// 8 pixels, split into two registers by SSE2 and NEON
+	using u32x8 = uint32_t __attribute__((vector_size(32)));
+	using i32x8 = int32_t __attribute__((vector_size(32)));
+
+	// The helpers work in place, passing 32 byte vectors by value changes the ABI without AVX
+
+	/** x / 255 for 0 <= x <= 0xFF00 */
+	inline void Div255(u32x8& x) {
+		x = (x + 1 + (x >> 8)) >> 8;
+	}
+
+	/**
+	 * Hard light of one channel without the lookup table:
+	 * tone <= 128: 2 * tone * c / 255
+	 * tone > 128: 255 - 2 * (255 - tone) * (255 - c) / 255
+	 */
+	struct HardLight {
+		uint32_t factor;
+		uint32_t flip;
+
+		explicit HardLight(int tone) :
+			factor(tone <= 128 ? 2 * tone : 2 * (255 - tone)),
+			flip(tone <= 128 ? 0 : 0xFF) {}
+
+		void Apply(u32x8& c) const {
+			c = (c ^ flip) * factor;
+			Div255(c);
+			// Clamp 256 (tone 128, c 255) to 255
+			c -= c >> 8;
+			c ^= flip;
+		}
+	};
+
+	/** Saturation of one channel, see saturation_tone in bitmap.cpp */
+	inline void Saturate(u32x8& c, const u32x8& lum, int sat) {
+		i32x8 res = ((i32x8)lum * 1024 + ((i32x8)c - (i32x8)lum) * sat) >> 10;
+		res &= ~(res >> 31);
+		const i32x8 over = res > 255;
+		res = (res & ~over) | (over & 255);
+		c = (u32x8)res;
+	}
+
+	/**
+	 * Applies the tone to a row.
+	 *
+	 * @tparam RS, GS, BS, AS shifts of the color channels
+	 * @tparam Sat apply saturation
+	 * @tparam Color apply the color tone
+	 * @tparam Skip keep pixels with an alpha of 0
+	 * @tparam Premultiply multiply the color tone with the alpha
+	 */
+	template <int RS, int GS, int BS, int AS, bool Sat, bool Color, bool Skip, bool Premultiply>
+	EP_TONE_TARGETS
+	void ToneRow(uint32_t* pixels, int width, const Tone& tone) {
+		const int sat = BitmapTone::GetSaturation(tone);
+		const HardLight hl_r(tone.red);
+		const HardLight hl_g(tone.green);
+		const HardLight hl_b(tone.blue);
+
+		for (int x = 0; x < width; x += 8) {
+			const int n = std::min(width - x, 8);
+
+			u32x8 v = {};
+			if (n == 8) {
+				std::memcpy(&v, pixels + x, sizeof(v));
+			} else {
+				std::memcpy(&v, pixels + x, n * sizeof(uint32_t));
+			}
+
+			u32x8 r = (v >> RS) & 0xFF;
+			u32x8 g = (v >> GS) & 0xFF;
+			u32x8 b = (v >> BS) & 0xFF;
+			const u32x8 a = (v >> AS) & 0xFF;
+
+			if (Sat) {
+				// Y' = 0.299 R' + 0.587 G' + 0.114 B'
+				const u32x8 lum = (b * 7471 + g * 38470 + r * 19595) >> 16;
+				Saturate(r, lum, sat);
+				Saturate(g, lum, sat);
+				Saturate(b, lum, sat);
+			}
+
+			if (Color) {
+				hl_r.Apply(r);
+				hl_g.Apply(g);
+				hl_b.Apply(b);
+
+				if (Premultiply) {
+					r *= a;
+					g *= a;
+					b *= a;
+					Div255(r);
+					Div255(g);
+					Div255(b);
+				}
+			}
+
+			u32x8 res = (r << RS) | (g << GS) | (b << BS) | (a << AS);
+
+			if (Skip) {
+				const u32x8 keep = (u32x8)(a == 0);
+				res = (res & ~keep) | (v & keep);
+			}
+
+			if (n == 8) {
+				std::memcpy(pixels + x, &res, sizeof(res));
+			} else {
+				std::memcpy(pixels + x, &res, n * sizeof(uint32_t));
+			}
+		}
+	}
+
+	template <int RS, int GS, int BS, int AS>
+	BitmapTone::RowFunction SelectRowFunction(ImageOpacity opacity, bool apply_sat, bool apply_tone) {
+		const bool opaque = opacity == ImageOpacity::Opaque;
+		const bool alpha_8bit = opacity == ImageOpacity::Alpha_8Bit;
+
+		if (apply_sat && apply_tone) {
+			if (opaque) {
+				return &ToneRow<RS, GS, BS, AS, true, true, false, false>;
+			}
+			if (alpha_8bit) {
+				return &ToneRow<RS, GS, BS, AS, true, true, true, true>;
+			}
+			return &ToneRow<RS, GS, BS, AS, true, true, true, false>;
+		}
+
+		if (apply_sat) {
+			if (opaque) {
+				return &ToneRow<RS, GS, BS, AS, true, false, false, false>;
+			}
+			return &ToneRow<RS, GS, BS, AS, true, false, true, false>;
+		}
+
+		if (apply_tone) {
+			if (opaque) {
+				return &ToneRow<RS, GS, BS, AS, false, true, false, false>;
+			}
+			if (alpha_8bit) {
+				return &ToneRow<RS, GS, BS, AS, false, true, true, true>;
+			}
+			return &ToneRow<RS, GS, BS, AS, false, true, true, false>;
+		}
+
+		return nullptr;
+	}
+}
+
+BitmapTone::RowFunction BitmapTone::GetRowFunction(const DynamicFormat& format, ImageOpacity opacity, const Tone& tone) {
+	if (format.bits != 32 || format.r.bits != 8 || format.g.bits != 8 || format.b.bits != 8 || format.a.bits != 8) {
+		return nullptr;
+	}
+
+	const bool apply_sat = tone.gray != 128;
+	const bool apply_tone = (tone.red != 128 || tone.green != 128 || tone.blue != 128);
+
+	const int rs = format.r.shift;
+	const int gs = format.g.shift;
+	const int bs = format.b.shift;
+	const int as = format.a.shift;
+
+	// The formats picked by Bitmap::ChooseFormat
+	if (rs == 0 && gs == 8 && bs == 16 && as == 24) {
+		return SelectRowFunction<0, 8, 16, 24>(opacity, apply_sat, apply_tone);
+	}
+	if (rs == 16 && gs == 8 && bs == 0 && as == 24) {
+		return SelectRowFunction<16, 8, 0, 24>(opacity, apply_sat, apply_tone);
+	}
+	if (rs == 8 && gs == 16 && bs == 24 && as == 0) {
+		return SelectRowFunction<8, 16, 24, 0>(opacity, apply_sat, apply_tone);
+	}
+	if (rs == 24 && gs == 16 && bs == 8 && as == 0) {
+		return SelectRowFunction<24, 16, 8, 0>(opacity, apply_sat, apply_tone);
+	}
+
+	return nullptr;
+}
+
+#else
+
+BitmapTone::RowFunction BitmapTone::GetRowFunction(const DynamicFormat&, ImageOpacity, const Tone&) {
+	// Compiler without vector extensions, Bitmap::ToneBlit uses the scalar code
+	return nullptr;
+}
+
+#endif
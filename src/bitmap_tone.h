@@ -0,0 +1,62 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_BITMAP_TONE_H
+#define EP_BITMAP_TONE_H
+
+// Headers
+#include <cstdint>
+#include "opacity.h"
+#include "pixel_format.h"
+#include "tone.h"
+
+/**
+ * Vectorized kernels of Bitmap::ToneBlit.
+ *
+ * The kernels are specialized at compile time for the 32 bit formats with
+ * 8 bit channels used by the Player and produce the same result as the
+ * hard light table and saturation code of Bitmap::ToneBlit.
+ * They use the vector extensions of GCC and Clang (SSE2 on x86, NEON on ARM),
+ * on x86-64 Linux an AVX2 version is selected at runtime when supported.
+ */
+namespace BitmapTone {
+	/**
+	 * Applies a tone to a row of pixels in place.
+	 *
+	 * @param pixels first pixel of the row
+	 * @param width amount of pixels
+	 * @param tone tone to apply
+	 */
+	using RowFunction = void(*)(uint32_t* pixels, int width, const Tone& tone);
+
+	/**
+	 * Selects the kernel for a pixel format.
+	 *
+	 * @param format pixel format of the destination bitmap
+	 * @param opacity opacity of the source image
+	 * @param tone tone to apply
+	 * @return kernel or nullptr when no kernel is available for the format
+	 */
+	RowFunction GetRowFunction(const DynamicFormat& format, ImageOpacity opacity, const Tone& tone);
+
+	/** @return saturation factor of the tone (1024 = unchanged) */
+	constexpr int GetSaturation(const Tone& tone) {
+		return tone.gray > 128 ? 1024 + (tone.gray - 128) * 16 : tone.gray * 8;
+	}
+}
+
+#endif
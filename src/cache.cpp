@@ -20,10 +20,19 @@
 #  pragma warning(disable: 4003)
 #endif
 
+#include <algorithm>
+#include <array>
+#include <list>
 #include <map>
+#include <string_view>
 #include <tuple>
+#include <unordered_map>
 #include <chrono>
 #include <cassert>
+#ifdef HAVE_THREADS
+#  include <condition_variable>
+#  include <mutex>
+#endif
 
 #include "async_handler.h"
 #include "cache.h"
@@ -35,13 +44,12 @@
 #include "player.h"
 #include <lcf/data.h>
 #include "game_clock.h"
+#include "worker_pool.h"
 
 using namespace std::chrono_literals;
 
 namespace {
-	std::string MakeHashKey(StringView folder_name, StringView filename, bool transparent) {
-		return ToString(folder_name) + ":" + ToString(filename) + ":" + (transparent ? "T" : " ");
-	}
+	using Material = Cache::Material;
 
 	std::string MakeTileHashKey(StringView chipset_name, int id) {
 		std::string key;
@@ -69,13 +77,115 @@ namespace {
 		return key.data() + offset;
 	}
 
+	size_t MakeHashKey(StringView filename, bool transparent) {
+		size_t hash = std::hash<std::string_view>()(std::string_view(filename.data(), filename.size()));
+		return hash ^ static_cast<size_t>(transparent);
+	}
+
 	struct CacheItem {
+		std::string filename;
+		size_t hash;
+		bool transparent;
 		BitmapRef bitmap;
+		size_t size;
 		Game_Clock::time_point last_access;
 	};
 
-	using key_type = std::string;
-	std::unordered_map<key_type, CacheItem> cache;
+	/**
+	 * LRU list of one material. The front of the list is the most recently used entry.
+	 * The index is keyed by the precomputed hash, so lookups do not allocate.
+	 */
+	struct MaterialCache {
+		using list_type = std::list<CacheItem>;
+
+		list_type lru;
+		std::unordered_multimap<size_t, list_type::iterator> index;
+		Cache::Stats stats;
+
+		list_type::iterator Find(StringView filename, bool transparent, size_t hash) {
+			auto range = index.equal_range(hash);
+			for (auto it = range.first; it != range.second; ++it) {
+				auto& item = *it->second;
+				if (item.transparent == transparent && item.filename == filename) {
+					return it->second;
+				}
+			}
+			return lru.end();
+		}
+
+		BitmapRef Touch(list_type::iterator it) {
+			++stats.hits;
+			it->last_access = Game_Clock::GetFrameTime();
+			lru.splice(lru.begin(), lru, it);
+			return it->bitmap;
+		}
+
+		BitmapRef Add(StringView filename, bool transparent, size_t hash, BitmapRef bmp) {
+			size_t size = bmp ? bmp->GetSize() : 0;
+			lru.push_front({ ToString(filename), hash, transparent, std::move(bmp), size, Game_Clock::GetFrameTime() });
+			index.emplace(hash, lru.begin());
+
+			++stats.entries;
+			stats.bytes += size;
+#ifdef CACHE_DEBUG
+			Output::Debug("Bitmap cache size (Add): {}", stats.bytes / 1024.0 / 1024.0);
+#endif
+			return lru.front().bitmap;
+		}
+
+		list_type::iterator Erase(list_type::iterator it) {
+			auto range = index.equal_range(it->hash);
+			for (auto iit = range.first; iit != range.second; ++iit) {
+				if (iit->second == it) {
+					index.erase(iit);
+					break;
+				}
+			}
+
+#ifdef CACHE_DEBUG
+			Output::Debug("Freeing memory of {}", it->filename);
+#endif
+
+			--stats.entries;
+			stats.bytes -= it->size;
+			++stats.evictions;
+			return lru.erase(it);
+		}
+
+		void Clear() {
+			lru.clear();
+			index.clear();
+			stats.entries = 0;
+			stats.bytes = 0;
+		}
+	};
+
+	std::array<MaterialCache, Material::END> cache;
+
+	constexpr size_t MiB = 1024 * 1024;
+
+	constexpr size_t KiB = 1024;
+
+	// Byte budget per material, same order as Material::Type.
+	// The budgets add up to 10 MiB.
+	std::array<size_t, Material::END> cache_budget = {{
+		512 * KiB, // Backdrop
+		768 * KiB, // Battle
+		1 * MiB, // Charset
+		1 * MiB, // Chipset
+		512 * KiB, // Faceset
+		256 * KiB, // Gameover
+		512 * KiB, // Monster
+		1 * MiB, // Panorama
+		2 * MiB, // Picture
+		256 * KiB, // System
+		512 * KiB, // Title
+		256 * KiB, // System2
+		768 * KiB, // Battle2
+		256 * KiB, // Battlecharset
+		256 * KiB, // Battleweapon
+		256 * KiB, // Frame
+	}};
 
 	using tile_key_type = std::string;
 	std::unordered_map<tile_key_type, std::weak_ptr<Bitmap>> cache_tiles;
@@ -88,81 +198,108 @@ namespace {
 
 	std::string system2_name;
 
-	constexpr int cache_limit = 10 * 1024 * 1024;
-	size_t cache_size = 0;
+	/**
+	 * An image that is decoded by the worker pool.
+	 * The file is opened on the main thread, only the decoding runs in the background.
+	 * The result is published to the cache by Cache::Update or taken by LoadBitmap.
+	 */
+	struct DecodeJob {
+		Material::Type material;
+		std::string filename;
+		bool transparent;
+		size_t hash;
+		FileRequestBinding request_id;
+		Filesystem_Stream::InputStream stream;
+		BitmapRef bitmap;
+		bool started = false;
+		// Protected by decode_mutex
+		bool done = false;
+	};
 
-	void FreeBitmapMemory() {
+	std::vector<std::shared_ptr<DecodeJob>> decode_jobs;
+#ifdef HAVE_THREADS
+	std::mutex decode_mutex;
+	std::condition_variable decode_cv;
+#endif
+
+	bool IsDecodeDone(DecodeJob& job) {
+#ifdef HAVE_THREADS
+		std::lock_guard<std::mutex> lock(decode_mutex);
+#endif
+		return job.done;
+	}
+
+	void WaitForDecode(DecodeJob& job) {
+#ifdef HAVE_THREADS
+		std::unique_lock<std::mutex> lock(decode_mutex);
+		decode_cv.wait(lock, [&job]() { return job.done; });
+#else
+		assert(job.done);
+#endif
+	}
+
+	std::vector<std::shared_ptr<DecodeJob>>::iterator FindDecodeJob(Material::Type material, StringView filename, bool transparent) {
+		return std::find_if(decode_jobs.begin(), decode_jobs.end(), [&](const auto& job) {
+			return job->material == material && job->transparent == transparent && job->filename == filename;
+		});
+	}
+
+	uint32_t GetBitmapFlags(Material::Type material) {
+		return Bitmap::Flag_ReadOnly | (
+				material == Material::Chipset ? Bitmap::Flag_Chipset :
+				material == Material::System ? Bitmap::Flag_System : 0);
+	}
+
+	/** Entries visited per material by the eviction in Cache::Update */
+	constexpr int max_evict_scan = 8;
+
+	/**
+	 * Evicts unreferenced bitmaps, starting at the least recently used end.
+	 * Entries used during the last frames are always kept, entries that were not
+	 * used for a few seconds are evicted even when the budget is not exhausted.
+	 *
+	 * @param material material to evict from
+	 * @param max_scan maximum number of entries to visit
+	 */
+	void FreeBitmapMemory(Material::Type material, int max_scan) {
+		auto& mc = cache[material];
 		auto cur_ticks = Game_Clock::GetFrameTime();
 
-		for (auto it = cache.begin(); it != cache.end();) {
-			if (it->second.bitmap.use_count() != 1) {
-				// Bitmap is referenced
-				++it;
+		auto it = mc.lru.end();
+		while (it != mc.lru.begin() && max_scan-- > 0) {
+			--it;
+
+			if (it->bitmap.use_count() != 1) {
+				// Bitmap is referenced, so it is in use right now. Moving it to
+				// the front keeps the tail free for entries that can be evicted,
+				// otherwise referenced bitmaps would exhaust the scan limit.
+				auto next = std::next(it);
+				it->last_access = cur_ticks;
+				mc.lru.splice(mc.lru.begin(), mc.lru, it);
+				it = next;
 				continue;
 			}
 
-			auto last_access = cur_ticks - it->second.last_access;
-			bool cache_exhausted = cache_size > cache_limit;
+			auto last_access = cur_ticks - it->last_access;
+			bool cache_exhausted = mc.stats.bytes > cache_budget[material];
 			if (cache_exhausted) {
 				if (last_access <= 50ms) {
 					// Used during the last 3 frames, must be important, keep it.
-					++it;
-					continue;
+					// The remaining entries were used even more recently.
+					break;
 				}
 			} else if (last_access <= 3s) {
-				++it;
-				continue;
+				break;
 			}
 
-#ifdef CACHE_DEBUG
-			Output::Debug("Freeing memory of {}/{}", std::get<0>(i.first), std::get<1>(i.first));
-#endif
-
-			cache_size -= it->second.bitmap->GetSize();
-
-			it = cache.erase(it);
+			it = mc.Erase(it);
 		}
 
 #ifdef CACHE_DEBUG
-		Output::Debug("Bitmap cache size: {}", cache_size / 1024.0 / 1024);
-#endif
-	}
-
-	BitmapRef AddToCache(const std::string& key, BitmapRef bmp) {
-		if (bmp) {
-			cache_size += bmp->GetSize();
-#ifdef CACHE_DEBUG
-			Output::Debug("Bitmap cache size (Add): {}", cache_size / 1024.0 / 1024.0);
+		Output::Debug("Bitmap cache size: {}", mc.stats.bytes / 1024.0 / 1024);
 #endif
-		}
-
-		return (cache[key] = {bmp, Game_Clock::GetFrameTime()}).bitmap;
 	}
 
-	struct Material {
-		enum Type {
-			REND = -1,
-			Backdrop,
-			Battle,
-			Charset,
-			Chipset,
-			Faceset,
-			Gameover,
-			Monster,
-			Panorama,
-			Picture,
-			System,
-			Title,
-			System2,
-			Battle2,
-			Battlecharset,
-			Battleweapon,
-			Frame,
-			END
-		};
-
-	}; // struct Material
-
 	using DummyRenderer = BitmapRef(*)();
 
 	template<Material::Type T> BitmapRef DrawCheckerboard();
@@ -246,17 +383,37 @@ namespace {
 
 		BitmapRef bmp;
 
-		const auto key = MakeHashKey(s.directory, filename, transparent);
-		auto it = cache.find(key);
-		if (it == cache.end()) {
+		auto& mc = cache[T];
+		const auto key = MakeHashKey(filename, transparent);
+		auto it = mc.Find(filename, transparent, key);
+		if (it == mc.lru.end()) {
+			++mc.stats.misses;
+
 			if (filename == CACHE_DEFAULT_BITMAP) {
 				bmp = LoadDummyBitmap<T>(s.directory, filename, true);
 			}
 
+			if (!bmp) {
+				// Take the result of a prefetch instead of decoding the image again.
+				// A prefetch that still waits for its file is cancelled by unbinding
+				// the file request, the image is decoded below instead.
+				auto job_it = FindDecodeJob(T, filename, transparent);
+				if (job_it != decode_jobs.end()) {
+					auto job = *job_it;
+					decode_jobs.erase(job_it);
+					if (job->started) {
+						WaitForDecode(*job);
+						bmp = std::move(job->bitmap);
+					} else {
+						job->request_id.reset();
+					}
+				}
+			}
+
 			if (!bmp) {
 				auto is = FileFinder::OpenImage(s.directory, filename);
 
-				FreeBitmapMemory();
+				FreeBitmapMemory(T, max_evict_scan);
 
 				if (!is) {
 					if (s.warn_missing) {
@@ -266,10 +423,7 @@ namespace {
 						bmp = CreateEmpty<T>();
 					}
 				} else {
-					auto flags = Bitmap::Flag_ReadOnly | (
-							T == Material::Chipset ? Bitmap::Flag_Chipset :
-							T == Material::System ? Bitmap::Flag_System : 0);
-					bmp = Bitmap::Create(std::move(is), transparent, flags);
+					bmp = Bitmap::Create(std::move(is), transparent, GetBitmapFlags(T));
 					if (!bmp) {
 						Output::Warning("Invalid image: {}/{}", s.directory, filename);
 					}
@@ -281,10 +435,9 @@ namespace {
 				bmp = LoadDummyBitmap<T>(s.directory, filename, transparent);
 			}
 
-			bmp = AddToCache(key, bmp);
+			bmp = mc.Add(filename, transparent, key, std::move(bmp));
 		} else {
-			it->second.last_access = Game_Clock::GetFrameTime();
-			bmp = it->second.bitmap;
+			bmp = mc.Touch(it);
 		}
 
 		assert(bmp);
@@ -386,11 +539,16 @@ BitmapRef Cache::System(StringView file) {
 }
 
 BitmapRef Cache::Exfont() {
-	const auto key = MakeHashKey("ExFont", "ExFont", false);
+	// The ExFont is stored in the System cache with a name that is no valid filename
+	constexpr StringView exfont_name = "\x01" "ExFont";
+	auto& mc = cache[Material::System];
+	const auto key = MakeHashKey(exfont_name, false);
+
+	auto it = mc.Find(exfont_name, false, key);
 
-	auto it = cache.find(key);
+	if (it == mc.lru.end()) {
+		++mc.stats.misses;
 
-	if (it == cache.end()) {
 		// Allow overwriting of built-in exfont with a custom ExFont image file
 		// exfont_custom is filled by Player::CreateGameObjects
 		BitmapRef exfont_img;
@@ -402,10 +560,9 @@ BitmapRef Cache::Exfont() {
 			exfont_img = Bitmap::Create(exfont_h, sizeof(exfont_h), true);
 		}
 
-		return AddToCache(key, exfont_img);
+		return mc.Add(exfont_name, false, key, std::move(exfont_img));
 	} else {
-		it->second.last_access = Game_Clock::GetFrameTime();
-		return it->second.bitmap;
+		return mc.Touch(it);
 	}
 }
 
@@ -493,9 +650,13 @@ BitmapRef Cache::SpriteEffect(const BitmapRef& src_bitmap, const Rect& rect, boo
 }
 
 void Cache::Clear() {
+	// Running decodes keep their job alive, the results are discarded
+	decode_jobs.clear();
+
 	cache_effects.clear();
-	cache.clear();
-	cache_size = 0;
+	for (auto& mc : cache) {
+		mc.Clear();
+	}
 
 	for (auto& kv : cache_tiles) {
 		auto& key = kv.first;
@@ -516,6 +677,131 @@ void Cache::ClearAll() {
 	system2_name.clear();
 }
 
+void Cache::Prefetch(Material::Type material, StringView filename) {
+	assert(material > Material::REND && material < Material::END);
+
+	if (filename.empty() || filename == CACHE_DEFAULT_BITMAP) {
+		return;
+	}
+
+	const Spec& s = spec[material];
+	const bool transparent = s.transparent;
+	const auto key = MakeHashKey(filename, transparent);
+
+	auto& mc = cache[material];
+	if (mc.Find(filename, transparent, key) != mc.lru.end()
+			|| FindDecodeJob(material, filename, transparent) != decode_jobs.end()) {
+		return;
+	}
+
+	auto job = std::make_shared<DecodeJob>();
+	job->material = material;
+	job->filename = ToString(filename);
+	job->transparent = transparent;
+	job->hash = key;
+	decode_jobs.push_back(job);
+
+	// The decode starts when the file is available (immediately unless on Emscripten)
+	FileRequestAsync* request = AsyncHandler::RequestFile(s.directory, filename);
+	std::weak_ptr<DecodeJob> weak_job = job;
+	job->request_id = request->Bind([weak_job](FileRequestResult* result) {
+		auto job = weak_job.lock();
+		if (!job || job->started) {
+			return;
+		}
+
+		if (result->success) {
+			job->stream = FileFinder::OpenImage(spec[job->material].directory, job->filename);
+		}
+
+		if (!job->stream) {
+			// Errors are reported by LoadBitmap when the image is requested
+			auto it = std::find(decode_jobs.begin(), decode_jobs.end(), job);
+			if (it != decode_jobs.end()) {
+				decode_jobs.erase(it);
+			}
+			return;
+		}
+
+		job->started = true;
+		WorkerPool::Shared().Push([job]() {
+			auto bmp = Bitmap::Create(std::move(job->stream), job->transparent, GetBitmapFlags(job->material));
+			{
+#ifdef HAVE_THREADS
+				std::lock_guard<std::mutex> lock(decode_mutex);
+#endif
+				job->bitmap = std::move(bmp);
+				job->done = true;
+			}
+#ifdef HAVE_THREADS
+			decode_cv.notify_all();
+#endif
+		});
+	});
+	request->Start();
+}
+
+void Cache::Update() {
+	// Publish finished decodes
+	for (auto it = decode_jobs.begin(); it != decode_jobs.end();) {
+		auto& job = **it;
+		if (!job.started || !IsDecodeDone(job)) {
+			++it;
+			continue;
+		}
+
+		auto& mc = cache[job.material];
+		if (job.bitmap && mc.Find(job.filename, job.transparent, job.hash) == mc.lru.end()) {
+			mc.Add(job.filename, job.transparent, job.hash, std::move(job.bitmap));
+			++mc.stats.prefetches;
+		}
+		it = decode_jobs.erase(it);
+	}
+
+	for (int i = 0; i < Material::END; ++i) {
+		FreeBitmapMemory(static_cast<Material::Type>(i), max_evict_scan);
+	}
+}
+
+void Cache::SetBudget(Material::Type material, size_t bytes) {
+	assert(material > Material::REND && material < Material::END);
+	cache_budget[material] = bytes;
+}
+
+Cache::Stats Cache::GetStats(Material::Type material) {
+	assert(material > Material::REND && material < Material::END);
+	Stats stats = cache[material].stats;
+	stats.budget = cache_budget[material];
+	return stats;
+}
+
+StringView Cache::GetMaterialName(Material::Type material) {
+	assert(material > Material::REND && material < Material::END);
+	return spec[material].directory;
+}
+
+void Cache::DumpStats() {
+	Stats total;
+	for (int i = 0; i < Material::END; ++i) {
+		auto material = static_cast<Material::Type>(i);
+		auto stats = GetStats(material);
+		Output::Debug("Cache {}: {} hits, {} misses, {} prefetches, {} evictions, {} entries, {:.2f}/{:.2f} MiB",
+			GetMaterialName(material), stats.hits, stats.misses, stats.prefetches, stats.evictions, stats.entries,
+			stats.bytes / 1024.0 / 1024.0, stats.budget / 1024.0 / 1024.0);
+
+		total.hits += stats.hits;
+		total.misses += stats.misses;
+		total.prefetches += stats.prefetches;
+		total.evictions += stats.evictions;
+		total.entries += stats.entries;
+		total.bytes += stats.bytes;
+		total.budget += stats.budget;
+	}
+	Output::Debug("Cache total: {} hits, {} misses, {} prefetches, {} evictions, {} entries, {:.2f}/{:.2f} MiB",
+		total.hits, total.misses, total.prefetches, total.evictions, total.entries,
+		total.bytes / 1024.0 / 1024.0, total.budget / 1024.0 / 1024.0);
+}
+
 void Cache::SetSystemName(std::string filename) {
 	system_name = std::move(filename);
 }
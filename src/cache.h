@@ -37,6 +37,47 @@ class Tone;
  * Cache namespace.
  */
 namespace Cache {
+	struct Material {
+		enum Type {
+			REND = -1,
+			Backdrop,
+			Battle,
+			Charset,
+			Chipset,
+			Faceset,
+			Gameover,
+			Monster,
+			Panorama,
+			Picture,
+			System,
+			Title,
+			System2,
+			Battle2,
+			Battlecharset,
+			Battleweapon,
+			Frame,
+			END
+		};
+	}; // struct Material
+
+	/** Statistics of the bitmap cache of one material */
+	struct Stats {
+		/** Lookups served from the cache */
+		uint32_t hits = 0;
+		/** Lookups that had to load the image */
+		uint32_t misses = 0;
+		/** Images decoded in the background by Prefetch */
+		uint32_t prefetches = 0;
+		/** Entries removed to stay in the budget or because they were unused */
+		uint32_t evictions = 0;
+		/** Number of cached bitmaps */
+		uint32_t entries = 0;
+		/** Size of all cached bitmaps in bytes */
+		size_t bytes = 0;
+		/** Byte budget of the material */
+		size_t budget = 0;
+	};
+
 	BitmapRef Backdrop(StringView filename);
 	BitmapRef Battle(StringView filename);
 	BitmapRef Battle2(StringView filename);
@@ -61,6 +102,44 @@ namespace Cache {
 	void Clear();
 	void ClearAll();
 
+	/**
+	 * Starts decoding an image on a worker thread, so that the next Load of it does
+	 * not stall the main thread. The result is added to the cache by Update.
+	 * Does nothing when the image is already cached or being decoded.
+	 *
+	 * @param material material of the image
+	 * @param filename name of the image
+	 */
+	void Prefetch(Material::Type material, StringView filename);
+
+	/**
+	 * Publishes images decoded by Prefetch and evicts unused bitmaps that are
+	 * stale or exceed the budget of their material.
+	 * Only a limited amount of entries is visited per call. Called once per frame.
+	 */
+	void Update();
+
+	/**
+	 * Sets the byte budget of a material.
+	 * Bitmaps that are still referenced are never evicted, so the budget can be exceeded temporarily.
+	 *
+	 * @param material material to configure
+	 * @param bytes maximum size of unreferenced bitmaps kept in the cache
+	 */
+	void SetBudget(Material::Type material, size_t bytes);
+
+	/**
+	 * @param material material to query
+	 * @return statistics of the material
+	 */
+	Stats GetStats(Material::Type material);
+
+	/** @return name of the material (the image directory) */
+	StringView GetMaterialName(Material::Type material);
+
+	/** Writes the statistics of all materials to the debug log */
+	void DumpStats();
+
 	/** @return the configured system bitmap, or nullptr if there is no system */
 	BitmapRef System();
 
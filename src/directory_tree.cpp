@@ -21,7 +21,12 @@
 #include "output.h"
 #include "platform.h"
 #include "player.h"
+#include "utils.h"
 #include <lcf/reader_util.h>
+#include <algorithm>
+#include <ctime>
+#include <istream>
+#include <ostream>
 
 //#define EP_DEBUG_DIRECTORYTREE
 #ifdef EP_DEBUG_DIRECTORYTREE
@@ -38,6 +43,53 @@ namespace {
 	std::string make_key(StringView n) {
 		return lcf::ReaderUtil::Normalize(n);
 	};
+
+	constexpr char index_magic[8] = { 'E', 'P', 'D', 'I', 'R', 'I', 'D', 'X' };
+	constexpr uint32_t index_version = 2;
+	// Sanity limits to reject corrupted index files early
+	constexpr uint32_t index_max_string = 4096;
+	constexpr uint32_t index_max_entries = 1 << 20;
+
+	void WriteU32(std::ostream& os, uint32_t val) {
+		Utils::SwapByteOrder(val);
+		os.write(reinterpret_cast<const char*>(&val), sizeof(val));
+	}
+
+	void WriteI64(std::ostream& os, int64_t val) {
+		WriteU32(os, static_cast<uint32_t>(static_cast<uint64_t>(val) & 0xFFFFFFFF));
+		WriteU32(os, static_cast<uint32_t>(static_cast<uint64_t>(val) >> 32));
+	}
+
+	void WriteString(std::ostream& os, StringView str) {
+		WriteU32(os, static_cast<uint32_t>(str.size()));
+		os.write(str.data(), str.size());
+	}
+
+	bool ReadU32(std::istream& is, uint32_t& val) {
+		if (!is.read(reinterpret_cast<char*>(&val), sizeof(val))) {
+			return false;
+		}
+		Utils::SwapByteOrder(val);
+		return true;
+	}
+
+	bool ReadI64(std::istream& is, int64_t& val) {
+		uint32_t lo, hi;
+		if (!ReadU32(is, lo) || !ReadU32(is, hi)) {
+			return false;
+		}
+		val = static_cast<int64_t>((static_cast<uint64_t>(hi) << 32) | lo);
+		return true;
+	}
+
+	bool ReadString(std::istream& is, std::string& str) {
+		uint32_t size;
+		if (!ReadU32(is, size) || size > index_max_string) {
+			return false;
+		}
+		str.resize(size);
+		return static_cast<bool>(is.read(&str[0], size));
+	}
 }
 
 std::unique_ptr<DirectoryTree> DirectoryTree::Create() {
@@ -111,6 +163,10 @@ DirectoryTree::DirectoryListType* DirectoryTree::ListDirectory(StringView path)
 		}
 	}
 
+	// Taken before the listing: A modification during the listing must not
+	// be older than the listing.
+	const int64_t listed_at = static_cast<int64_t>(std::time(nullptr));
+
 	if (!fs->GetDirectoryContent(fs_path, entries)) {
 		DebugLog("ListDirectory GetDirectoryContent Failed: {}", fs_path);
 		dir_missing_cache.push_back(make_key(fs_path));
@@ -152,6 +208,7 @@ DirectoryTree::DirectoryListType* DirectoryTree::ListDirectory(StringView path)
 #endif
 
 	InsertSorted(fs_cache, dir_key, std::move(fs_cache_entry));
+	InsertSorted(listed_cache, dir_key, listed_at);
 
 	return &Find(fs_cache, dir_key)->second;
 }
@@ -163,6 +220,7 @@ void DirectoryTree::ClearCache(StringView path) const {
 		fs_cache.clear();
 		dir_cache.clear();
 		dir_missing_cache.clear();
+		listed_cache.clear();
 		return;
 	}
 
@@ -175,11 +233,125 @@ void DirectoryTree::ClearCache(StringView path) const {
 	if (dir_it != dir_cache.end()) {
 		dir_cache.erase(dir_it);
 	}
+	auto listed_it = Find(listed_cache, dir_key);
+	if (listed_it != listed_cache.end()) {
+		listed_cache.erase(listed_it);
+	}
 	dir_missing_cache.erase(std::remove_if(dir_missing_cache.begin(), dir_missing_cache.end(), [&path] (const auto& dir) {
 		return StringView(dir).starts_with(path);
 	}), dir_missing_cache.end());
 }
 
+int DirectoryTree::SaveIndex(std::ostream& os) const {
+	if (!fs) {
+		return -1;
+	}
+
+	struct IndexDir {
+		const dir_cache_pair* dir;
+		int64_t mtime;
+		int64_t listed_at;
+	};
+
+	std::vector<IndexDir> dirs;
+	for (const auto& dir : dir_cache) {
+		auto listed_it = Find(listed_cache, dir.first);
+		assert(listed_it != listed_cache.end());
+
+		// A modification in the same second as the listing is not detectable
+		// by comparing timestamps, such directories are not written.
+		int64_t mtime = fs->GetModificationTime(dir.second);
+		if (mtime < 0 || mtime >= listed_it->second - 1) {
+			DebugLog("SaveIndex Skip: {} ({})", dir.second, mtime);
+			continue;
+		}
+		dirs.push_back({ &dir, mtime, listed_it->second });
+	}
+
+	os.write(index_magic, sizeof(index_magic));
+	WriteU32(os, index_version);
+	WriteU32(os, static_cast<uint32_t>(dirs.size()));
+
+	for (const auto& dir : dirs) {
+		auto fs_it = Find(fs_cache, dir.dir->first);
+		assert(fs_it != fs_cache.end());
+
+		WriteString(os, dir.dir->first);
+		WriteString(os, dir.dir->second);
+		WriteI64(os, dir.mtime);
+		WriteI64(os, dir.listed_at);
+		WriteU32(os, static_cast<uint32_t>(fs_it->second.size()));
+		for (const auto& entry : fs_it->second) {
+			WriteString(os, entry.first);
+			WriteString(os, entry.second.name);
+			WriteU32(os, static_cast<uint32_t>(entry.second.type));
+		}
+	}
+
+	return os ? static_cast<int>(dirs.size()) : -1;
+}
+
+int DirectoryTree::LoadIndex(std::istream& is) const {
+	if (!fs) {
+		return -1;
+	}
+
+	char magic[sizeof(index_magic)];
+	uint32_t version;
+	uint32_t num_dirs;
+	if (!is.read(magic, sizeof(magic)) || !std::equal(std::begin(magic), std::end(magic), std::begin(index_magic)) ||
+			!ReadU32(is, version) || version != index_version || !ReadU32(is, num_dirs)) {
+		return -1;
+	}
+
+	int restored = 0;
+	std::string dir_key, fs_path, entry_key, entry_name;
+	for (uint32_t i = 0; i < num_dirs; ++i) {
+		int64_t mtime, listed_at;
+		uint32_t num_entries;
+		if (!ReadString(is, dir_key) || !ReadString(is, fs_path) || !ReadI64(is, mtime) || !ReadI64(is, listed_at) ||
+				!ReadU32(is, num_entries) || num_entries > index_max_entries) {
+			return -1;
+		}
+
+		DirectoryListType entries;
+		entries.reserve(num_entries);
+		for (uint32_t j = 0; j < num_entries; ++j) {
+			uint32_t type;
+			if (!ReadString(is, entry_key) || !ReadString(is, entry_name) || !ReadU32(is, type) ||
+					type > static_cast<uint32_t>(FileType::Other)) {
+				return -1;
+			}
+			entries.emplace_back(entry_key, Entry(entry_name, static_cast<FileType>(type)));
+		}
+
+		if (!std::is_sorted(entries.begin(), entries.end(), [](auto& left, auto& right) {
+			return left.first < right.first;
+		})) {
+			return -1;
+		}
+
+		if (Find(dir_cache, dir_key) != dir_cache.end()) {
+			// Listed during this session, is more recent
+			continue;
+		}
+
+		if (fs->GetModificationTime(fs_path) != mtime) {
+			DebugLog("LoadIndex Stale: {}", fs_path);
+			continue;
+		}
+
+		InsertSorted(fs_cache, dir_key, std::move(entries));
+		InsertSorted(dir_cache, dir_key, fs_path);
+		// Unmodified since the original listing, so it is still the listing time
+		InsertSorted(listed_cache, dir_key, listed_at);
+		dir_missing_cache.erase(std::remove(dir_missing_cache.begin(), dir_missing_cache.end(), dir_key), dir_missing_cache.end());
+		++restored;
+	}
+
+	return restored;
+}
+
 std::string DirectoryTree::FindFile(StringView filename, const Span<const StringView> exts) const {
 	return FindFile({ ToString(filename), exts });
 }
@@ -18,6 +18,7 @@
 #ifndef EP_DIRECTORY_TREE_H
 #define EP_DIRECTORY_TREE_H
 
+#include <iosfwd>
 #include <memory>
 #include <string>
 #include <vector>
@@ -128,6 +129,28 @@ public:
 
 	void ClearCache(StringView path) const;
 
+	/**
+	 * Writes the cached directory listings to a stream.
+	 * Together with each directory the modification time is stored.
+	 * Directories of filesystems that do not report modification times are
+	 * skipped, as are directories modified in the second of their listing
+	 * or later.
+	 *
+	 * @param os stream to write to
+	 * @return amount of written directories, -1 on error
+	 */
+	int SaveIndex(std::ostream& os) const;
+
+	/**
+	 * Restores directory listings written by SaveIndex.
+	 * Directories that were modified since the index was written, or that are
+	 * already cached, are skipped and listed again on first access.
+	 *
+	 * @param is stream to read from
+	 * @return amount of restored directories, -1 when the index is invalid
+	 */
+	int LoadIndex(std::istream& is) const;
+
 private:
 	Filesystem* fs = nullptr;
 
@@ -145,6 +168,10 @@ private:
 	/** lowered dir (full path from root) of missing directories */
 	mutable std::vector<std::string> dir_missing_cache;
 
+	/** lowered dir (full path from root) -> time of the listing (Unix time) */
+	using listed_cache_pair = std::pair<std::string, int64_t>;
+	mutable std::vector<listed_cache_pair> listed_cache;
+
 	template<class T>
 	auto Find(T& cache, StringView what) const {
 		auto it = std::lower_bound(cache.begin(), cache.end(), what, [](const auto& e, const auto& w) {
@@ -23,6 +23,10 @@ Drawable::~Drawable() {
 	DrawableMgr::Remove(this);
 }
 
+bool Drawable::GetDamage(Rect&) {
+	return false;
+}
+
 void Drawable::SetZ(Z_t nz) {
 	if (_z != nz) DrawableMgr::OnUpdateZ(this);
 	_z = nz;
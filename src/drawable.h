@@ -20,6 +20,7 @@
 
 #include <cstdint>
 #include <memory>
+#include "rect.h"
 
 class Bitmap;
 class Drawable;
@@ -57,6 +58,17 @@ public:
 
 	virtual void Draw(Bitmap& dst) = 0;
 
+	/**
+	 * Reports the screen area that changed since the last call.
+	 * Called once per frame by the retained renderer, also for invisible drawables.
+	 * Drawables that do not track their state return false and cause a redraw
+	 * of the whole screen while they are visible.
+	 *
+	 * @param damage receives the changed area, empty when nothing changed
+	 * @return whether the drawable tracks damage
+	 */
+	virtual bool GetDamage(Rect& damage);
+
 	Z_t GetZ() const;
 
 	void SetZ(Z_t z);
@@ -113,6 +125,21 @@ public:
 	 * @return Priority or 0 when not found
 	 */
 	static Z_t GetPriorityForBattleLayer(int which);
+
+protected:
+	/**
+	 * Helper for GetDamage implementations.
+	 * Compares the drawing state with the one of the previous frame and stores it.
+	 *
+	 * @param last state of the previous frame, replaced with state
+	 * @param state current drawing state, must be comparable with ==
+	 * @param last_bounds screen area of the previous frame, replaced with bounds
+	 * @param bounds screen area covered with the current state, empty when not drawn
+	 * @return union of both areas when the state changed, otherwise an empty rect
+	 */
+	template <typename T>
+	static Rect UpdateDamage(T& last, const T& state, Rect& last_bounds, const Rect& bounds);
+
 private:
 	Z_t _z = 0;
 	Flags _flags = Flags::Default;
@@ -142,6 +169,18 @@ inline Drawable::Drawable(Z_t z, Flags flags)
 {
 }
 
+template <typename T>
+inline Rect Drawable::UpdateDamage(T& last, const T& state, Rect& last_bounds, const Rect& bounds) {
+	if (last == state && last_bounds == bounds) {
+		return Rect();
+	}
+
+	Rect damage = last_bounds.GetUnion(bounds);
+	last = state;
+	last_bounds = bounds;
+	return damage;
+}
+
 inline Drawable::Z_t Drawable::GetZ() const {
 	return _z;
 }
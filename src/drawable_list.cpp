@@ -34,6 +34,7 @@ DrawableList::~DrawableList() {
 void DrawableList::Clear() {
 	_list.clear();
 	SetClean();
+	_changed = true;
 }
 
 bool DrawableList::IsSorted() const {
@@ -54,6 +55,7 @@ void DrawableList::Append(Drawable* ptr) {
 	const bool ordered = _list.empty() || !DrawCmp(ptr, _list.back());
 
 	_list.push_back(ptr);
+	_changed = true;
 
 	if (!ordered) {
 		SetDirty();
@@ -69,6 +71,7 @@ Drawable* DrawableList::Take(Drawable* ptr) {
 	auto ret = *iter;
 	// FIXME: Can we remove this O(N) operation here?
 	_list.erase(iter);
+	_changed = true;
 	return ret;
 
 	// Removing doesn't change sorted order, so not dirty flag.
@@ -88,6 +91,7 @@ void DrawableList::TakeFrom(DrawableList& other) noexcept {
 
 	SetDirty();
 	other.SetClean();
+	other._changed = true;
 }
 
 void DrawableList::Draw(Bitmap& dst, Drawable::Z_t min_z, Drawable::Z_t max_z) {
@@ -111,3 +115,26 @@ void DrawableList::Draw(Bitmap& dst, Drawable::Z_t min_z, Drawable::Z_t max_z) {
 	}
 }
 
+bool DrawableList::CollectDamage(Rect& damage) {
+	bool tracked = !_changed;
+	bool untracked_visible = false;
+
+	for (auto* drawable : _list) {
+		Rect drawable_damage;
+		if (drawable->GetDamage(drawable_damage)) {
+			damage = damage.GetUnion(drawable_damage);
+		} else if (drawable->IsVisible()) {
+			untracked_visible = true;
+		}
+	}
+
+	// The frame after an untracked drawable disappeared is a full redraw, too
+	if (untracked_visible || _untracked_visible) {
+		tracked = false;
+	}
+
+	_changed = false;
+	_untracked_visible = untracked_visible;
+
+	return tracked;
+}
@@ -131,9 +131,23 @@ class DrawableList {
 		 */
 		void Draw(Bitmap& dst, Drawable::Z_t min_z, Drawable::Z_t max_z);
 
+		/**
+		 * Queries the damage of all drawables. Used by the retained renderer
+		 * once per frame before drawing.
+		 *
+		 * @param damage receives the union of the changed areas
+		 * @return false when the whole screen must be redrawn because drawables were
+		 * added, removed or reordered, or a visible drawable does not track damage
+		 */
+		bool CollectDamage(Rect& damage);
+
 	private:
 		std::vector<Drawable*> _list;
 		bool _dirty = false;
+		/** Drawables were added, removed or reordered since the last CollectDamage */
+		bool _changed = true;
+		/** A visible drawable without damage tracking was drawn in the last frame */
+		bool _untracked_visible = false;
 
 		void SetClean();
 };
@@ -170,6 +184,7 @@ void DrawableList::TakeFrom(DrawableList& other, F&& cond) noexcept {
 	olist.resize(olist.size() - shift);
 
 	SetDirty();
+	other._changed = true;
 	if (olist.empty()) {
 		other.SetClean();
 	}
@@ -181,6 +196,7 @@ inline bool DrawableList::IsDirty() const {
 
 inline void DrawableList::SetDirty() {
 	_dirty = true;
+	_changed = true;
 }
 
 inline void DrawableList::SetClean() {
@@ -28,7 +28,9 @@
 
 #include <cstring>
 #include <fstream>
-#include <map>
+#include <iterator>
+#include <memory>
+#include <unordered_map>
 
 enum DynRpg_ParseMode {
 	ParseMode_Function,
@@ -38,9 +40,31 @@ enum DynRpg_ParseMode {
 	ParseMode_Token
 };
 
-typedef std::map<std::string, dynfunc> dyn_rpg_func;
+typedef std::unordered_map<std::string, dynfunc> dyn_rpg_func;
 
 namespace {
+	/** A token that references a variable or an actor, resolved on every call */
+	struct Token {
+		/** Index of the argument */
+		int index = 0;
+		/** Unmodified token, for warnings */
+		std::string text;
+		/** Lookups from right to left: V reads a variable, N the actor name */
+		std::string lookups;
+		int number = 0;
+	};
+
+	/** Result of parsing a DynRPG comment */
+	struct Command {
+		/** Lower case, empty when the comment is invalid */
+		std::string function_name;
+		/** nullptr when the function is not supported */
+		dynfunc function = nullptr;
+		/** Arguments, the entries of tokens are replaced when the command is invoked */
+		std::vector<std::string> args;
+		std::vector<Token> tokens;
+	};
+
 	bool init = false;
 
 	// Registered DynRpg Plugins
@@ -48,10 +72,18 @@ namespace {
 
 	// DynRpg Function table
 	dyn_rpg_func dyn_rpg_functions;
+
+	// Parsed commands by comment text, shared_ptr keeps a command alive when a
+	// function invokes another command that clears the cache
+	std::unordered_map<std::string, std::shared_ptr<Command>> command_cache;
+
+	// Limits the memory usage when the comments are generated by the game
+	constexpr size_t command_cache_limit = 1024;
 }
 
 void DynRpg::RegisterFunction(const std::string& name, dynfunc func) {
 	dyn_rpg_functions[name] = func;
+	command_cache.clear();
 }
 
 bool DynRpg::HasFunction(const std::string& name) {
@@ -112,74 +144,82 @@ std::string DynRpg::ParseVarArg(StringView func_name, dyn_arg_list args, int ind
 }
 
 
-static std::string ParseToken(const std::string& token, const std::string& function_name) {
-	std::string::iterator text_index, end;
-	std::string text = token;
-	text_index = text.begin();
-	end = text.end();
-
-	char chr = *text_index;
-
+// Splits a token of the form N?V*[0-9]+ into the lookups and the number.
+// Returns false for normal tokens, text is then the argument.
+static bool CompileToken(const std::string& token, std::string& text, Token& ref) {
 	bool first = true;
-
 	bool number_encountered = false;
 
-	std::stringstream var_part;
-	std::stringstream number_part;
+	std::string var_part;
+	std::string number_part;
 
-	for (;;) {
-		if (text_index != end) {
-			chr = *text_index;
+	for (char chr : token) {
+		if (number_encountered || (chr >= '0' && chr <= '9')) {
+			number_encountered = true;
+			number_part += chr;
+		} else if (chr == 'N' && first) {
+			var_part += chr;
+		} else if (chr == 'V') {
+			var_part += chr;
+		} else {
+			// Normal token
+			text = Utils::LowerCase(token);
+			return false;
 		}
 
-		if (text_index == end) {
-			// Variable reference
-			std::string tmp = number_part.str();
-			int number = atoi(tmp.c_str());
-			tmp = var_part.str();
-			if (tmp.empty()) {
-				return token;
-			}
+		first = false;
+	}
 
-			// Convert backwards
-			for (std::string::reverse_iterator it = tmp.rbegin(); it != tmp.rend(); ++it) {
-				if (*it == 'N') {
-					if (!Main_Data::game_actors->ActorExists(number)) {
-						Output::Warning("{}: Invalid actor id {} in {}", function_name, number, token);
-						return "";
-					}
+	if (var_part.empty()) {
+		// A number
+		text = token;
+		return false;
+	}
 
-					// N is last
-					return ToString(Main_Data::game_actors->GetActor(number)->GetName());
-				} else {
-					// Variable
-					number = Main_Data::game_variables->Get(number);
-				}
-			}
+	ref.text = token;
+	ref.lookups = std::move(var_part);
+	ref.number = atoi(number_part.c_str());
+	return true;
+}
 
-			number_part.str("");
-			number_part << number;
-			return number_part.str();
-		} else if (number_encountered || (chr >= '0' && chr <= '9')) {
-			number_encountered = true;
-			number_part << chr;
-		} else if (chr == 'N') {
-			if (!first) {
-				break;
+static std::string ResolveToken(const Token& token, const std::string& function_name) {
+	int number = token.number;
+
+	// Convert backwards
+	for (auto it = token.lookups.rbegin(); it != token.lookups.rend(); ++it) {
+		if (*it == 'N') {
+			if (!Main_Data::game_actors->ActorExists(number)) {
+				Output::Warning("{}: Invalid actor id {} in {}", function_name, number, token.text);
+				return "";
 			}
-			var_part << chr;
-		} else if (chr == 'V') {
-			var_part << chr;
+
+			// N is last
+			return ToString(Main_Data::game_actors->GetActor(number)->GetName());
 		} else {
-			break;
+			// Variable
+			number = Main_Data::game_variables->Get(number);
 		}
+	}
 
-		++text_index;
-		first = false;
+	return std::to_string(number);
+}
+
+static void AddToken(Command& cmd, const std::string& token) {
+	Token ref;
+	std::string text;
+	if (CompileToken(token, text, ref)) {
+		ref.index = static_cast<int>(cmd.args.size());
+		cmd.tokens.push_back(std::move(ref));
 	}
+	cmd.args.push_back(std::move(text));
+}
 
-	// Normal token
-	return Utils::LowerCase(token);
+static std::vector<std::string> ResolveArgs(const Command& cmd) {
+	std::vector<std::string> args = cmd.args;
+	for (const auto& token : cmd.tokens) {
+		args[token.index] = ResolveToken(token, cmd.function_name);
+	}
+	return args;
 }
 
 void create_all_plugins() {
@@ -192,7 +232,9 @@ void create_all_plugins() {
 	init = true;
 }
 
-std::string DynRpg::ParseCommand(const std::string& command, std::vector<std::string>& args) {
+static std::string Parse(const std::string& command, Command& cmd) {
+	auto& args = cmd.args;
+
 	if (command.empty()) {
 		// Not a DynRPG function (empty comment)
 		return "";
@@ -212,7 +254,6 @@ std::string DynRpg::ParseCommand(const std::string& command, std::vector<std::st
 
 	DynRpg_ParseMode mode = ParseMode_Function;
 	std::string function_name;
-	std::string tmp;
 	std::stringstream token;
 
 	++text_index;
@@ -222,6 +263,7 @@ std::string DynRpg::ParseCommand(const std::string& command, std::vector<std::st
 	// Number is a valid float number
 	// Tokens are Strings without "" and with Whitespace stripped o_O
 	// If a token is (regex) N?V+[0-9]+ it is resolved to a var or an actor
+	// when the command is invoked
 
 	// All arguments are passed as string to the DynRpg functions and are
 	// converted to int or float on demand.
@@ -256,8 +298,7 @@ std::string DynRpg::ParseCommand(const std::string& command, std::vector<std::st
 					args.emplace_back(token.str());
 					break;
 				case ParseMode_Token:
-					tmp = ParseToken(token.str(), function_name);
-					args.emplace_back(tmp);
+					AddToken(cmd, token.str());
 					break;
 			}
 
@@ -313,8 +354,7 @@ std::string DynRpg::ParseCommand(const std::string& command, std::vector<std::st
 					token << chr;
 					break;
 				case ParseMode_Token:
-					tmp = ParseToken(token.str(), function_name);
-					args.emplace_back(tmp);
+					AddToken(cmd, token.str());
 					// already on a comma
 					mode = ParseMode_WaitForArg;
 					token.str("");
@@ -371,19 +411,58 @@ std::string DynRpg::ParseCommand(const std::string& command, std::vector<std::st
 	return function_name;
 }
 
+std::string DynRpg::ParseCommand(const std::string& command, std::vector<std::string>& args) {
+	Command cmd;
+	cmd.function_name = Parse(command, cmd);
+
+	auto resolved = ResolveArgs(cmd);
+	args.insert(args.end(), std::make_move_iterator(resolved.begin()), std::make_move_iterator(resolved.end()));
+
+	return cmd.function_name;
+}
+
 bool DynRpg::Invoke(const std::string& command) {
 	if (!init) {
 		create_all_plugins();
 	}
 
-	std::vector<std::string> args;
-	std::string function_name = ParseCommand(command, args);
+	std::shared_ptr<Command> cmd;
+
+	auto it = command_cache.find(command);
+	if (it != command_cache.end()) {
+		cmd = it->second;
+	} else {
+		cmd = std::make_shared<Command>();
+		cmd->function_name = Parse(command, *cmd);
+
+		auto func_it = dyn_rpg_functions.find(cmd->function_name);
+		if (func_it != dyn_rpg_functions.end()) {
+			cmd->function = func_it->second;
+		}
+
+		if (command_cache.size() >= command_cache_limit) {
+			command_cache.clear();
+		}
+		command_cache.emplace(command, cmd);
+	}
+
+	if (cmd->function_name.empty()) {
+		return true;
+	}
 
-	if (function_name.empty()) {
+	if (!cmd->function) {
+		// Not a supported function
+		Output::Warning("Unsupported DynRPG function: {}", cmd->function_name);
 		return true;
 	}
 
-	return Invoke(function_name, args);
+	if (cmd->tokens.empty()) {
+		// The functions only read their arguments, the cached ones are passed directly
+		return cmd->function(cmd->args);
+	}
+
+	auto args = ResolveArgs(*cmd);
+	return cmd->function(args);
 }
 
 bool DynRpg::Invoke(const std::string& func, dyn_arg_list args) {
@@ -391,13 +470,14 @@ bool DynRpg::Invoke(const std::string& func, dyn_arg_list args) {
 		create_all_plugins();
 	}
 
-	if (!DynRpg::HasFunction(func)) {
+	auto it = dyn_rpg_functions.find(func);
+	if (it == dyn_rpg_functions.end()) {
 		// Not a supported function
 		Output::Warning("Unsupported DynRPG function: {}", func);
 		return true;
 	}
 
-	return dyn_rpg_functions[func](args);
+	return it->second(args);
 }
 
 std::string get_filename(int slot) {
@@ -530,5 +610,6 @@ void DynRpg::Update() {
 void DynRpg::Reset() {
 	init = false;
 	dyn_rpg_functions.clear();
+	command_cache.clear();
 	plugins.clear();
 }
@@ -0,0 +1,89 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "event_spatial_index.h"
+
+void EventSpatialIndex::Reset(int width, int height, int num_slots) {
+	this->width = width;
+	this->height = height;
+
+	heads.assign(width * height, -1);
+	next.assign(num_slots, -1);
+	tiles.assign(num_slots, -1);
+}
+
+void EventSpatialIndex::Clear() {
+	Reset(0, 0, 0);
+}
+
+void EventSpatialIndex::Update(int slot, int x, int y) {
+	if (slot < 0 || slot >= GetSlotCount()) {
+		return;
+	}
+
+	int tile = IsInGrid(x, y) ? x + y * width : -1;
+	if (tiles[slot] == tile) {
+		return;
+	}
+
+	Unlink(slot);
+	Link(slot, tile);
+}
+
+int EventSpatialIndex::GetNext(int x, int y, int slot) const {
+	if (!IsInGrid(x, y)) {
+		return -1;
+	}
+
+	int cur = heads[x + y * width];
+	while (cur >= 0 && cur <= slot) {
+		cur = next[cur];
+	}
+	return cur;
+}
+
+void EventSpatialIndex::Unlink(int slot) {
+	int tile = tiles[slot];
+	if (tile < 0) {
+		return;
+	}
+
+	int* link = &heads[tile];
+	while (*link != slot) {
+		link = &next[*link];
+	}
+	*link = next[slot];
+
+	next[slot] = -1;
+	tiles[slot] = -1;
+}
+
+void EventSpatialIndex::Link(int slot, int tile) {
+	tiles[slot] = tile;
+	if (tile < 0) {
+		return;
+	}
+
+	// Keep the list sorted by slot
+	int* link = &heads[tile];
+	while (*link >= 0 && *link < slot) {
+		link = &next[*link];
+	}
+	next[slot] = *link;
+	*link = slot;
+}
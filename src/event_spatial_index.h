@@ -0,0 +1,99 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_EVENT_SPATIAL_INDEX_H
+#define EP_EVENT_SPATIAL_INDEX_H
+
+// Headers
+#include <vector>
+
+/**
+ * Tile grid that maps positions to the events standing on them.
+ *
+ * Events are identified by their slot (index in the event list of the map).
+ * Every tile holds a singly linked list of slots sorted in ascending order,
+ * so iterating a tile visits the events in the same order as a scan over the
+ * whole event list would.
+ * Positions outside of the grid are tracked but not linked into any tile.
+ */
+class EventSpatialIndex {
+public:
+	/**
+	 * Resizes the grid and unlinks all slots.
+	 *
+	 * @param width width of the map in tiles
+	 * @param height height of the map in tiles
+	 * @param num_slots amount of events
+	 */
+	void Reset(int width, int height, int num_slots);
+
+	/** Removes all tiles and slots */
+	void Clear();
+
+	/**
+	 * Moves a slot to a new position.
+	 *
+	 * @param slot index of the event
+	 * @param x new x position
+	 * @param y new y position
+	 */
+	void Update(int slot, int x, int y);
+
+	/**
+	 * Returns the next slot at a tile.
+	 *
+	 * @param x x position, must be inside of the grid
+	 * @param y y position, must be inside of the grid
+	 * @param slot slot to continue after, -1 to start at the beginning
+	 * @return next slot with an index greater than slot, or -1 when none is left
+	 */
+	int GetNext(int x, int y, int slot) const;
+
+	/**
+	 * @param x x position
+	 * @param y y position
+	 * @return Whether (x,y) is inside of the grid
+	 */
+	bool IsInGrid(int x, int y) const;
+
+	/** @return amount of slots */
+	int GetSlotCount() const;
+
+private:
+	void Unlink(int slot);
+	void Link(int slot, int tile);
+
+	int width = 0;
+	int height = 0;
+
+	/** First slot of every tile, -1 when empty */
+	std::vector<int> heads;
+	/** Following slot in the tile list, -1 at the end */
+	std::vector<int> next;
+	/** Tile of every slot, -1 when outside of the grid */
+	std::vector<int> tiles;
+};
+
+inline bool EventSpatialIndex::IsInGrid(int x, int y) const {
+	return x >= 0 && x < width && y >= 0 && y < height;
+}
+
+inline int EventSpatialIndex::GetSlotCount() const {
+	return static_cast<int>(tiles.size());
+}
+
+#endif
@@ -40,6 +40,7 @@
 #include "filesystem.h"
 #include "filesystem_root.h"
 #include "fileext_guesser.h"
+#include "game_clock.h"
 #include "output.h"
 #include "player.h"
 #include "registry.h"
@@ -455,6 +456,53 @@ std::string FileFinder::GetFullFilesystemPath(FilesystemView fs) {
 	return full_path;
 }
 
+bool FileFinder::LoadAssetIndex() {
+	auto start = Game_Clock::now();
+
+	auto is = Save().OpenInputStream(Save().FindFile(ASSET_INDEX_NAME));
+	if (!is) {
+		return false;
+	}
+
+	// The index is only valid for the game it was created for
+	std::string game_path;
+	if (!Utils::ReadLine(is, game_path) || game_path != GetFullFilesystemPath(Game())) {
+		Output::Debug("Asset index: Ignored, created for a different game");
+		return false;
+	}
+
+	int restored = Game().GetOwner().LoadIndex(is);
+	if (restored < 0) {
+		Output::Warning("Asset index: {} is corrupted", ASSET_INDEX_NAME);
+		return false;
+	}
+
+	using ms = std::chrono::duration<double, std::milli>;
+	Output::Debug("Asset index: Restored {} directories in {:.1f} ms", restored, ms(Game_Clock::now() - start).count());
+	return true;
+}
+
+bool FileFinder::SaveAssetIndex() {
+	if (!Save().IsFeatureSupported(Filesystem::Feature::Write)) {
+		return false;
+	}
+
+	auto os = Save().OpenOutputStream(ASSET_INDEX_NAME, std::ios_base::binary | std::ios_base::out | std::ios_base::trunc);
+	if (!os) {
+		return false;
+	}
+
+	os << GetFullFilesystemPath(Game()) << "\n";
+	int written = Game().GetOwner().SaveIndex(os);
+	if (written < 0) {
+		Output::Warning("Asset index: Writing {} failed", ASSET_INDEX_NAME);
+		return false;
+	}
+
+	Output::Debug("Asset index: Saved {} directories", written);
+	return true;
+}
+
 void FileFinder::DumpFilesystem(FilesystemView fs) {
 	FilesystemView cur_fs = fs;
 	int i = 1;
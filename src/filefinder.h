@@ -300,6 +300,24 @@ namespace FileFinder {
 	 * @param fs Filesystem to use
 	 */
 	void DumpFilesystem(FilesystemView fs);
+
+	/**
+	 * Restores the directory listings of the game filesystem from the asset
+	 * index in the save directory. This avoids the directory scans of the asset
+	 * lookups after the game was detected.
+	 * Listings of modified directories are ignored.
+	 *
+	 * @return true when an index was loaded
+	 */
+	bool LoadAssetIndex();
+
+	/**
+	 * Writes the directory listings of the game filesystem to the asset index
+	 * in the save directory.
+	 *
+	 * @return true on success
+	 */
+	bool SaveAssetIndex();
 } // namespace FileFinder
 
 template<typename T>
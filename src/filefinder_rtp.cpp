@@ -32,9 +32,33 @@
 #endif
 
 FileFinder_RTP::FileFinder_RTP(bool no_rtp, bool no_rtp_warnings, std::string rtp_path) {
+	Init(no_rtp, no_rtp_warnings);
+	if (disable_rtp) {
+		return;
+	}
+
+	int version = Player::EngineVersion();
+	for (StringView p : FindSearchPaths(rtp_path)) {
+		AddSearchPath(DetectSearchPath(FileFinder::Root(), p, version));
+	}
+}
+
+FileFinder_RTP::FileFinder_RTP(bool no_rtp, bool no_rtp_warnings, std::vector<SearchPath> search_paths) {
+	Init(no_rtp, no_rtp_warnings);
+	if (disable_rtp) {
+		return;
+	}
+
+	for (auto& sp : search_paths) {
+		AddSearchPath(std::move(sp));
+	}
+}
+
+void FileFinder_RTP::Init(bool no_rtp, bool no_rtp_warnings) {
 #ifdef EMSCRIPTEN
 	// No RTP support for emscripten at the moment.
 	disable_rtp = true;
+	(void)no_rtp;
 #else
 	disable_rtp = no_rtp;
 #endif
@@ -42,32 +66,40 @@ FileFinder_RTP::FileFinder_RTP(bool no_rtp, bool no_rtp_warnings, std::string rt
 
 	if (disable_rtp) {
 		Output::Debug("RTP support is disabled.");
-		return;
 	}
+}
+
+std::vector<std::string> FileFinder_RTP::FindSearchPaths(StringView rtp_path) {
+	std::vector<std::string> paths;
+
+#ifdef EMSCRIPTEN
+	(void)rtp_path;
+	return paths;
+#endif
 
 	std::string const version_str =	Player::GetEngineVersion();
 	assert(!version_str.empty());
 
 #ifdef GEKKO
-	AddPath("sd:/data/rtp/" + version_str);
-	AddPath("usb:/data/rtp/" + version_str);
+	paths.push_back("sd:/data/rtp/" + version_str);
+	paths.push_back("usb:/data/rtp/" + version_str);
 #elif defined(__SWITCH__)
-	AddPath("./rtp/" + version_str);
-	AddPath("/switch/easyrpg-player/rtp/" + version_str);
+	paths.push_back("./rtp/" + version_str);
+	paths.push_back("/switch/easyrpg-player/rtp/" + version_str);
 #elif defined(__3DS__)
-	AddPath("romfs:/data/rtp/" + version_str);
-	AddPath("sdmc:/data/rtp/" + version_str);
+	paths.push_back("romfs:/data/rtp/" + version_str);
+	paths.push_back("sdmc:/data/rtp/" + version_str);
 #elif defined(__vita__)
-	AddPath("ux0:/data/easyrpg-player/rtp/" + version_str);
+	paths.push_back("ux0:/data/easyrpg-player/rtp/" + version_str);
 #elif defined(__MORPHOS__)
-	AddPath("PROGDIR:rtp/" + version_str);
+	paths.push_back("PROGDIR:rtp/" + version_str);
 #elif defined(USE_LIBRETRO)
 	const char* dir = nullptr;
 	if (LibretroUi::environ_cb(RETRO_ENVIRONMENT_GET_CORE_ASSETS_DIRECTORY, &dir) && dir) {
-		AddPath(std::string(dir) + "/rtp/" + version_str);
+		paths.push_back(std::string(dir) + "/rtp/" + version_str);
 	}
 	if (LibretroUi::environ_cb(RETRO_ENVIRONMENT_GET_SYSTEM_DIRECTORY, &dir) && dir) {
-		AddPath(std::string(dir) + "/rtp/" + version_str);
+		paths.push_back(std::string(dir) + "/rtp/" + version_str);
 	}
 #elif defined(__ANDROID__)
 	// Invoke "String getRtpPath()" in EasyRPG Activity via JNI
@@ -83,39 +115,39 @@ FileFinder_RTP::FileFinder_RTP(bool no_rtp, bool no_rtp_warnings, std::string rt
 	env->ReleaseStringUTFChars(return_string, js);
 	env->DeleteLocalRef(sdl_activity);
 	env->DeleteLocalRef(cls);
-	AddPath(cs + "/" + version_str);
+	paths.push_back(cs + "/" + version_str);
 #elif defined(USE_WINE_REGISTRY) || defined(_WIN32)
 	std::string const product = "RPG" + version_str;
 	if (Player::IsRPG2k()) {
 		// Prefer original 2000 RTP over Kadokawa, because there is no
 		// reliable way to detect this engine and much more 2k games
 		// use the non-English version
-		ReadRegistry("ASCII", product, "RuntimePackagePath");
-		ReadRegistry("KADOKAWA", product, "RuntimePackagePath");
+		ReadRegistry(paths, "ASCII", product, "RuntimePackagePath");
+		ReadRegistry(paths, "KADOKAWA", product, "RuntimePackagePath");
 	}
 	else if (Player::IsRPG2k3E()) {
 		// Prefer Kadokawa RTP over Enterbrain for new RPG2k3
-		ReadRegistry("KADOKAWA", product, "RuntimePackagePath");
-		ReadRegistry("Enterbrain", product, "RUNTIMEPACKAGEPATH");
+		ReadRegistry(paths, "KADOKAWA", product, "RuntimePackagePath");
+		ReadRegistry(paths, "Enterbrain", product, "RUNTIMEPACKAGEPATH");
 	}
 	else if (Player::IsRPG2k3()) {
 		// Original 2003 RTP installer registry key is upper case
 		// and Wine registry is case insensitive but new 2k3v1.10 installer is not
 		// Prefer Enterbrain RTP over Kadokawa for old RPG2k3 (search order)
-		ReadRegistry("Enterbrain", product, "RUNTIMEPACKAGEPATH");
-		ReadRegistry("KADOKAWA", product, "RuntimePackagePath");
+		ReadRegistry(paths, "Enterbrain", product, "RUNTIMEPACKAGEPATH");
+		ReadRegistry(paths, "KADOKAWA", product, "RuntimePackagePath");
 	}
 
 	// Our RTP is for all engines
-	ReadRegistry("EasyRPG", "RTP", "path");
+	ReadRegistry(paths, "EasyRPG", "RTP", "path");
 #else
 	// Fallback for unknown platforms
-	AddPath("/data/rtp/" + version_str);
+	paths.push_back("/data/rtp/" + version_str);
 #endif
 
 #if (defined(PLAYER_NINTENDO) || defined(__vita__) || defined(__ANDROID__))
 	// skip environment paths
-	return;
+	return paths;
 #endif
 
 	std::vector<std::string> env_paths;
@@ -169,60 +201,75 @@ FileFinder_RTP::FileFinder_RTP(bool no_rtp, bool no_rtp_warnings, std::string rt
 #endif
 
 	// Add all found paths from the environment
-	for (StringView p : env_paths) {
-		AddPath(p);
+	paths.insert(paths.end(), env_paths.begin(), env_paths.end());
+
+	return paths;
+}
+
+FileFinder_RTP::SearchPath FileFinder_RTP::DetectSearchPath(const FilesystemView& root, StringView path, int version) {
+	SearchPath sp;
+	sp.path = ToString(path);
+	sp.fs = root.Create(FileFinder::MakeCanonical(path));
+	if (!sp.fs) {
+		return sp;
+	}
+
+	auto files = sp.fs.ListDirectory();
+	if (files->size() == 0) {
+		sp.empty = true;
+		return sp;
 	}
+
+	sp.hit_info = RTP::Detect(sp.fs, version);
+	return sp;
 }
 
-void FileFinder_RTP::AddPath(StringView p) {
-	using namespace FileFinder;
-	auto fs = FileFinder::Root().Create(FileFinder::MakeCanonical(p));
-	if (fs) {
-		auto files = fs.ListDirectory();
-		if (files->size() == 0) {
-			Output::Debug("RTP path {} is empty, not adding", p);
-			return;
-		}
+void FileFinder_RTP::AddSearchPath(SearchPath sp) {
+	if (!sp.fs) {
+		Output::Debug("RTP path {} is invalid, not adding", sp.path);
+		return;
+	}
 
-		Output::Debug("Adding {} to RTP path", p);
+	if (sp.empty) {
+		Output::Debug("RTP path {} is empty, not adding", sp.path);
+		return;
+	}
 
-		auto hit_info = RTP::Detect(fs, Player::EngineVersion());
+	Output::Debug("Adding {} to RTP path", sp.path);
 
-		search_paths.push_back(fs);
+	search_paths.push_back(sp.fs);
 
-		if (hit_info.empty()) {
-			Output::Debug("The folder does not contain a known RTP!");
-		}
+	if (sp.hit_info.empty()) {
+		Output::Debug("The folder does not contain a known RTP!");
+	}
 
-		// Only consider the best RTP hits (usually 100% if properly installed)
-		float best = 0.0;
-		for (const auto& hit : hit_info) {
-			float rate = static_cast<float>(hit.hits) / hit.max;
-			if (rate >= best) {
-				Output::Debug("RTP is \"{}\" ({}/{})", hit.name, hit.hits, hit.max);
-				detected_rtp.emplace_back(hit);
-				best = rate;
-			}
+	// Only consider the best RTP hits (usually 100% if properly installed)
+	float best = 0.0;
+	for (auto& hit : sp.hit_info) {
+		float rate = static_cast<float>(hit.hits) / hit.max;
+		if (rate >= best) {
+			Output::Debug("RTP is \"{}\" ({}/{})", hit.name, hit.hits, hit.max);
+			best = rate;
+			detected_rtp.emplace_back(std::move(hit));
 		}
-	} else {
-		Output::Debug("RTP path {} is invalid, not adding", p);
 	}
 }
 
-void FileFinder_RTP::ReadRegistry(StringView company, StringView product, StringView key) {
+void FileFinder_RTP::ReadRegistry(std::vector<std::string>& paths, StringView company, StringView product, StringView key) {
 #if defined(USE_WINE_REGISTRY) || defined(_WIN32)
 	std::string rtp_path = Registry::ReadStrValue(
 			HKEY_CURRENT_USER, "Software\\" + ToString(company) + "\\" + ToString(product), key, KEY32);
 	if (!rtp_path.empty()) {
-		AddPath(rtp_path);
+		paths.push_back(rtp_path);
 	}
 
 	rtp_path = Registry::ReadStrValue(
 			HKEY_LOCAL_MACHINE, "Software\\" + ToString(company) + "\\" + ToString(product), key, KEY32);
 	if (!rtp_path.empty()) {
-		AddPath(rtp_path);
+		paths.push_back(rtp_path);
 	}
 #else
+	(void)paths;
 	(void)company;
 	(void)product;
 	(void)key;
@@ -24,6 +24,18 @@
 
 class FileFinder_RTP {
 public:
+	/** Result of scanning a RTP search path */
+	struct SearchPath {
+		/** path as passed to DetectSearchPath */
+		std::string path;
+		/** filesystem of the path, invalid when the path does not exist */
+		FilesystemView fs;
+		/** path exists but has no content */
+		bool empty = false;
+		/** detected RTP, sorted from best to worst hit */
+		std::vector<RTP::RtpHitInfo> hit_info;
+	};
+
 	/**
 	 * Manages RTP folders.
 	 *
@@ -33,6 +45,36 @@ public:
 	 */
 	FileFinder_RTP(bool no_rtp, bool no_rtp_warnings, std::string rtp_path);
 
+	/**
+	 * Manages RTP folders that were already scanned with DetectSearchPath.
+	 *
+	 * @param no_rtp If true disables RTP support completely
+	 * @param no_rtp_warnings If true disables warnings when a RTP asset is used
+	 * @param search_paths scanned paths, in order of precedence
+	 */
+	FileFinder_RTP(bool no_rtp, bool no_rtp_warnings, std::vector<SearchPath> search_paths);
+
+	/**
+	 * Collects the directories that may contain a RTP for the current engine.
+	 * Queries the registry and platform APIs, must be called by the main thread.
+	 *
+	 * @param rtp_path Custom RTP path to use
+	 * @return candidate paths, in order of precedence
+	 */
+	static std::vector<std::string> FindSearchPaths(StringView rtp_path);
+
+	/**
+	 * Scans a path for the installed RTP.
+	 * Only uses the passed filesystem, so a private RootFilesystem allows
+	 * calling this from a worker thread.
+	 *
+	 * @param root filesystem the path is resolved in
+	 * @param path path to scan
+	 * @param version RTP version (2000 or 2003)
+	 * @return scan result
+	 */
+	static SearchPath DetectSearchPath(const FilesystemView& root, StringView path, int version);
+
 	/**
 	 * Looks up a file in the list of RTPs
 	 *
@@ -44,8 +86,9 @@ public:
 	 Filesystem_Stream::InputStream Lookup(StringView dir, StringView name, const Span<const StringView> exts) const;
 
 private:
-	void AddPath(StringView p);
-	void ReadRegistry(StringView company, StringView product, StringView key);
+	void Init(bool no_rtp, bool no_rtp_warnings);
+	void AddSearchPath(SearchPath sp);
+	static void ReadRegistry(std::vector<std::string>& paths, StringView company, StringView product, StringView key);
 	Filesystem_Stream::InputStream LookupInternal(StringView dir, StringView name, const Span<const StringView> exts, bool& is_rtp_asset) const;
 
 	using search_path_list = std::vector<FilesystemView>;
@@ -208,6 +208,24 @@ public:
 	 */
 	Filesystem_Stream::InputStream OpenFile(const DirectoryTree::Args& args) const;
 
+	/**
+	 * Writes the cached directory listings to a stream.
+	 *
+	 * @see DirectoryTree::SaveIndex
+	 * @param os stream to write to
+	 * @return amount of written directories, -1 on error
+	 */
+	int SaveIndex(std::ostream& os) const;
+
+	/**
+	 * Restores directory listings written by SaveIndex.
+	 *
+	 * @see DirectoryTree::LoadIndex
+	 * @param is stream to read from
+	 * @return amount of restored directories, -1 when the index is invalid
+	 */
+	int LoadIndex(std::istream& is) const;
+
 	/** Implicit conversion to FilesystemView */
 	operator FilesystemView();
 
@@ -219,6 +237,7 @@ public:
 	virtual bool IsDirectory(StringView path, bool follow_symlinks) const = 0;
 	virtual bool Exists(StringView path) const = 0;
 	virtual int64_t GetFilesize(StringView path) const = 0;
+	virtual int64_t GetModificationTime(StringView path) const;
 	virtual bool MakeDirectory(StringView dir, bool follow_symlinks) const;
 	virtual bool IsFeatureSupported(Feature f) const;
 	virtual std::string Describe() const = 0;
@@ -501,6 +520,10 @@ inline FilesystemView Filesystem::GetParent() const {
 	return *parent_fs;
 }
 
+inline int64_t Filesystem::GetModificationTime(StringView) const {
+	return -1;
+}
+
 inline bool Filesystem::IsFeatureSupported(Filesystem::Feature) const {
 	return false;
 }
@@ -514,6 +537,14 @@ inline DirectoryTree::DirectoryListType* Filesystem::ListDirectory(StringView pa
 	return tree->ListDirectory(path);
 }
 
+inline int Filesystem::SaveIndex(std::ostream& os) const {
+	return tree->SaveIndex(os);
+}
+
+inline int Filesystem::LoadIndex(std::istream& is) const {
+	return tree->LoadIndex(is);
+}
+
 inline Filesystem::operator FilesystemView() { return Subtree(""); }
 
 #endif
@@ -20,14 +20,33 @@
 #include <cstdlib>
 #include <cstring>
 #include <fstream>
+#include <memory>
 #include <string>
 #include <vector>
 #include <fmt/core.h>
 
 #include "system.h"
+#include "filesystem_stream.h"
 #include "output.h"
 #include "platform.h"
 
+namespace {
+	/** Files smaller than this are read through a filebuf, mapping them is not worth it */
+	constexpr int64_t mmap_threshold = 16 * 1024;
+
+	/** Streambuf over a memory mapped file. Takes ownership of the mapping. */
+	class MappedFileStreamBuf : public Filesystem_Stream::InputMemoryStreamBufView {
+	public:
+		explicit MappedFileStreamBuf(std::unique_ptr<Platform::MappedFile> file) :
+			Filesystem_Stream::InputMemoryStreamBufView(Span<uint8_t>(const_cast<uint8_t*>(file->GetData()), file->GetSize())),
+			file(std::move(file)) {
+		}
+
+	private:
+		std::unique_ptr<Platform::MappedFile> file;
+	};
+}
+
 NativeFilesystem::NativeFilesystem(std::string base_path, FilesystemView parent_fs) : Filesystem(std::move(base_path), parent_fs) {
 }
 
@@ -47,7 +66,20 @@ int64_t NativeFilesystem::GetFilesize(StringView path) const {
 	return Platform::File(ToString(path)).GetSize();
 }
 
+int64_t NativeFilesystem::GetModificationTime(StringView path) const {
+	return Platform::File(ToString(path)).GetModificationTime();
+}
+
 std::streambuf* NativeFilesystem::CreateInputStreambuffer(StringView path, std::ios_base::openmode mode) const {
+	if (Platform::MappedFile::IsSupported() && (mode & (std::ios_base::out | std::ios_base::binary)) == std::ios_base::binary &&
+			GetFilesize(path) >= mmap_threshold) {
+		// Read-only binary access: Map the file, consumers can access the data without copying
+		auto file = std::make_unique<Platform::MappedFile>(ToString(path));
+		if (*file) {
+			return new MappedFileStreamBuf(std::move(file));
+		}
+	}
+
 	auto* buf = new std::filebuf();
 	buf->open(
 #ifdef _MSC_VER
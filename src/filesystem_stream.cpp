@@ -50,6 +50,16 @@ void Filesystem_Stream::InputStream::Close() {
 	set_rdbuf(nullptr);
 }
 
+Span<const uint8_t> Filesystem_Stream::InputStream::GetData() const {
+#if defined(__cpp_rtti) || defined(__GXX_RTTI) || defined(_CPPRTTI)
+	if (auto* view = dynamic_cast<InputMemoryStreamBufView*>(rdbuf())) {
+		return view->GetData();
+	}
+#endif
+	// Without RTTI the stream is always read through the streambuf
+	return {};
+}
+
 Filesystem_Stream::OutputStream::OutputStream(std::streambuf* sb, FilesystemView fs, std::string name) :
 	std::ostream(sb), fs(std::move(fs)), name(std::move(name)) {};
 
@@ -90,6 +100,10 @@ Filesystem_Stream::InputMemoryStreamBufView::InputMemoryStreamBufView(Span<uint8
 	setg(cbuffer, cbuffer, cbuffer + buffer_view.size());
 }
 
+Span<const uint8_t> Filesystem_Stream::InputMemoryStreamBufView::GetData() const {
+	return Span<const uint8_t>(buffer_view.data(), buffer_view.size());
+}
+
 std::streambuf::pos_type Filesystem_Stream::InputMemoryStreamBufView::seekoff(std::streambuf::off_type offset, std::ios_base::seekdir dir, std::ios_base::openmode mode) {
 	std::streambuf::pos_type off;
 	if (dir == std::ios_base::beg) {
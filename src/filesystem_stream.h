@@ -39,6 +39,17 @@ namespace Filesystem_Stream {
 		StringView GetName() const;
 		void Close();
 
+		/**
+		 * Provides direct access to the content when the stream is backed by
+		 * memory (memory mapped file, uncompressed archive entry, ...), so the
+		 * caller can avoid copying the data through the stream.
+		 * The span covers the whole content independent of the read position
+		 * and is valid until the stream is closed.
+		 *
+		 * @return content of the stream or an empty span when not memory backed
+		 */
+		Span<const uint8_t> GetData() const;
+
 		template <typename T>
 		bool ReadIntoObj(T& obj);
 
@@ -74,6 +85,9 @@ namespace Filesystem_Stream {
 		InputMemoryStreamBufView(InputMemoryStreamBufView const& other) = delete;
 		InputMemoryStreamBufView const& operator=(InputMemoryStreamBufView const& other) = delete;
 
+		/** @return the viewed buffer */
+		Span<const uint8_t> GetData() const;
+
 	protected:
 		std::streambuf::pos_type seekoff(std::streambuf::off_type offset, std::ios_base::seekdir dir, std::ios_base::openmode mode) override;
 		std::streambuf::pos_type seekpos(std::streambuf::pos_type pos, std::ios_base::openmode mode) override;
@@ -36,6 +36,290 @@ constexpr uint32_t central_directory_entry = 0x02014b50;
 constexpr uint32_t local_header = 0x04034b50;
 constexpr uint32_t local_header_size = 30;
 
+// Entries up to this size are decompressed into memory, larger ones are streamed
+constexpr uint32_t stream_threshold = 512 * 1024;
+
+namespace {
+
+/**
+ * Streambuf that decompresses a zip entry on demand.
+ * Only small buffers are kept in memory. Seeking forward decompresses and
+ * discards data, for seeking backward the state of the decompressor is
+ * recorded at checkpoints every few hundred kilobytes, so a seek never has
+ * to restart at the beginning of a large entry.
+ * Stored (uncompressed) entries are read directly from the archive.
+ */
+class ZipStreamBuf : public std::streambuf {
+public:
+	ZipStreamBuf(Filesystem_Stream::InputStream zip_file, std::streamoff data_offset,
+			uint32_t compressed_size, uint32_t uncompressed_size, bool deflate, std::string name);
+	~ZipStreamBuf() override;
+
+	ZipStreamBuf(const ZipStreamBuf&) = delete;
+	ZipStreamBuf& operator=(const ZipStreamBuf&) = delete;
+
+protected:
+	int_type underflow() override;
+	pos_type seekoff(off_type offset, std::ios_base::seekdir dir, std::ios_base::openmode mode) override;
+	pos_type seekpos(pos_type pos, std::ios_base::openmode mode) override;
+
+private:
+	struct Checkpoint {
+		/** Uncompressed position */
+		uint32_t out;
+		/** Compressed position, including a partially consumed byte */
+		uint32_t in;
+		/** Bits of the byte before in that belong to the next block */
+		int bits;
+		/** Last 32 KiB of uncompressed data */
+		std::vector<Bytef> window;
+	};
+
+	static constexpr size_t in_buffer_size = 16 * 1024;
+	static constexpr size_t out_buffer_size = 32 * 1024;
+	static constexpr uint32_t checkpoint_span = 512 * 1024;
+
+	bool Fill();
+	bool FillPlain();
+	bool FillDeflate();
+	bool Restore(const Checkpoint& point);
+	pos_type SeekTo(uint32_t target);
+	uint32_t BufferEnd() const;
+
+	Filesystem_Stream::InputStream zip_file;
+	std::streamoff data_offset;
+	uint32_t compressed_size;
+	uint32_t uncompressed_size;
+	bool deflate;
+	std::string name;
+
+	z_stream zlib_stream = {};
+	bool zlib_failed = false;
+	/** Compressed bytes read from the archive */
+	uint32_t in_pos = 0;
+	/** Uncompressed position of eback() */
+	uint32_t buffer_pos = 0;
+	std::vector<Bytef> in_buffer;
+	std::vector<char> out_buffer;
+	std::vector<Checkpoint> checkpoints;
+};
+
+ZipStreamBuf::ZipStreamBuf(Filesystem_Stream::InputStream zip_file, std::streamoff data_offset,
+		uint32_t compressed_size, uint32_t uncompressed_size, bool deflate, std::string name) :
+		zip_file(std::move(zip_file)), data_offset(data_offset), compressed_size(compressed_size),
+		uncompressed_size(uncompressed_size), deflate(deflate), name(std::move(name)),
+		out_buffer(out_buffer_size) {
+	if (deflate) {
+		in_buffer.resize(in_buffer_size);
+		inflateInit2(&zlib_stream, -MAX_WBITS);
+		checkpoints.push_back({0, 0, 0, {}});
+	}
+	setg(out_buffer.data(), out_buffer.data(), out_buffer.data());
+}
+
+ZipStreamBuf::~ZipStreamBuf() {
+	if (deflate) {
+		inflateEnd(&zlib_stream);
+	}
+}
+
+uint32_t ZipStreamBuf::BufferEnd() const {
+	return buffer_pos + static_cast<uint32_t>(egptr() - eback());
+}
+
+ZipStreamBuf::int_type ZipStreamBuf::underflow() {
+	if (gptr() < egptr()) {
+		return traits_type::to_int_type(*gptr());
+	}
+
+	if (!Fill()) {
+		return traits_type::eof();
+	}
+	return traits_type::to_int_type(*gptr());
+}
+
+bool ZipStreamBuf::Fill() {
+	buffer_pos = BufferEnd();
+	setg(out_buffer.data(), out_buffer.data(), out_buffer.data());
+
+	if (buffer_pos >= uncompressed_size) {
+		return false;
+	}
+
+	return deflate ? FillDeflate() : FillPlain();
+}
+
+bool ZipStreamBuf::FillPlain() {
+	auto size = std::min<uint32_t>(out_buffer.size(), uncompressed_size - buffer_pos);
+	zip_file.clear();
+	zip_file.seekg(data_offset + buffer_pos);
+	zip_file.read(out_buffer.data(), size);
+	auto read = zip_file.gcount();
+	setg(out_buffer.data(), out_buffer.data(), out_buffer.data() + read);
+	return read > 0;
+}
+
+bool ZipStreamBuf::FillDeflate() {
+	if (zlib_failed) {
+		return false;
+	}
+
+	zlib_stream.next_out = reinterpret_cast<Bytef*>(out_buffer.data());
+	zlib_stream.avail_out = static_cast<uInt>(out_buffer.size());
+
+	auto out_pos = [&]() {
+		return buffer_pos + static_cast<uint32_t>(out_buffer.size() - zlib_stream.avail_out);
+	};
+
+	while (zlib_stream.avail_out > 0 && out_pos() < uncompressed_size) {
+		if (zlib_stream.avail_in == 0) {
+			auto size = std::min<uint32_t>(in_buffer.size(), compressed_size - in_pos);
+			if (size == 0) {
+				Output::Warning("ZipFS: zlib failed for {}: Unexpected end of data (Archive corrupted?)", name);
+				zlib_failed = true;
+				break;
+			}
+			zip_file.clear();
+			zip_file.seekg(data_offset + in_pos);
+			zip_file.read(reinterpret_cast<char*>(in_buffer.data()), size);
+			if (zip_file.gcount() != static_cast<std::streamsize>(size)) {
+				Output::Warning("ZipFS: Read error in {}", name);
+				zlib_failed = true;
+				break;
+			}
+			in_pos += size;
+			zlib_stream.next_in = in_buffer.data();
+			zlib_stream.avail_in = size;
+		}
+
+		// Z_BLOCK stops at block boundaries where checkpoints can be created
+		int zlib_error = inflate(&zlib_stream, Z_BLOCK);
+		if (zlib_error == Z_STREAM_END) {
+			break;
+		} else if (zlib_error != Z_OK) {
+			Output::Warning("ZipFS: zlib failed for {}: {} ({})", name, zlib_error, zlib_stream.msg ? zlib_stream.msg : "No error message");
+			zlib_failed = true;
+			break;
+		}
+
+		bool end_of_block = (zlib_stream.data_type & 128) && !(zlib_stream.data_type & 64);
+		uint32_t out = out_pos();
+		if (end_of_block && out >= checkpoints.back().out + checkpoint_span) {
+			Checkpoint point;
+			point.out = out;
+			point.in = in_pos - zlib_stream.avail_in;
+			point.bits = zlib_stream.data_type & 7;
+			point.window.resize(32 * 1024);
+			uInt window_size = static_cast<uInt>(point.window.size());
+			if (inflateGetDictionary(&zlib_stream, point.window.data(), &window_size) == Z_OK) {
+				point.window.resize(window_size);
+				checkpoints.push_back(std::move(point));
+			}
+		}
+	}
+
+	auto produced = out_buffer.size() - zlib_stream.avail_out;
+	setg(out_buffer.data(), out_buffer.data(), out_buffer.data() + produced);
+	return produced > 0;
+}
+
+bool ZipStreamBuf::Restore(const Checkpoint& point) {
+	inflateReset(&zlib_stream);
+	zlib_failed = false;
+	zlib_stream.avail_in = 0;
+	in_pos = point.in;
+
+	if (point.bits) {
+		// The block starts inside the previous byte
+		zip_file.clear();
+		zip_file.seekg(data_offset + point.in - 1);
+		int byte = zip_file.get();
+		if (byte == EOF) {
+			return false;
+		}
+		inflatePrime(&zlib_stream, point.bits, byte >> (8 - point.bits));
+	}
+	if (!point.window.empty()) {
+		inflateSetDictionary(&zlib_stream, point.window.data(), static_cast<uInt>(point.window.size()));
+	}
+
+	buffer_pos = point.out;
+	setg(out_buffer.data(), out_buffer.data(), out_buffer.data());
+	return true;
+}
+
+ZipStreamBuf::pos_type ZipStreamBuf::SeekTo(uint32_t target) {
+	if (target < buffer_pos || target > BufferEnd()) {
+		if (!deflate) {
+			buffer_pos = target;
+			setg(out_buffer.data(), out_buffer.data(), out_buffer.data());
+			return target;
+		}
+
+		// Continue from the closest checkpoint when it is ahead of the current position
+		auto it = std::upper_bound(checkpoints.begin(), checkpoints.end(), target, [](uint32_t pos, const Checkpoint& point) {
+			return pos < point.out;
+		});
+		const auto& point = *(it - 1);
+		if (target < buffer_pos || point.out > BufferEnd()) {
+			if (!Restore(point)) {
+				return pos_type(off_type(-1));
+			}
+		}
+
+		while (target > BufferEnd()) {
+			if (!Fill()) {
+				break;
+			}
+		}
+
+		if (target < buffer_pos || target > BufferEnd()) {
+			return pos_type(off_type(-1));
+		}
+	}
+
+	setg(eback(), eback() + (target - buffer_pos), egptr());
+	return target;
+}
+
+ZipStreamBuf::pos_type ZipStreamBuf::seekoff(off_type offset, std::ios_base::seekdir dir, std::ios_base::openmode) {
+	off_type target;
+	if (dir == std::ios_base::beg) {
+		target = offset;
+	} else if (dir == std::ios_base::cur) {
+		target = buffer_pos + (gptr() - eback()) + offset;
+	} else {
+		target = uncompressed_size + offset;
+	}
+
+	if (target < 0 || target > uncompressed_size) {
+		return pos_type(off_type(-1));
+	}
+
+	return SeekTo(static_cast<uint32_t>(target));
+}
+
+ZipStreamBuf::pos_type ZipStreamBuf::seekpos(pos_type pos, std::ios_base::openmode mode) {
+	return seekoff(off_type(pos), std::ios_base::beg, mode);
+}
+
+/**
+ * Streambuf over a stored entry of a memory backed (mapped) archive.
+ * Keeps the archive stream open, the data is not copied.
+ */
+class ZipViewStreamBuf : public Filesystem_Stream::InputMemoryStreamBufView {
+public:
+	ZipViewStreamBuf(Filesystem_Stream::InputStream zip_file, Span<const uint8_t> data) :
+		Filesystem_Stream::InputMemoryStreamBufView(Span<uint8_t>(const_cast<uint8_t*>(data.data()), data.size())),
+		zip_file(std::move(zip_file)) {
+	}
+
+private:
+	Filesystem_Stream::InputStream zip_file;
+};
+
+} // anonymous namespace
+
 static std::string normalize_path(StringView path) {
 	if (path == "." || path == "/" || path == "") {
 		return "";
@@ -367,19 +651,41 @@ std::streambuf* ZipFilesystem::CreateInputStreambuffer(StringView path, std::ios
 				return nullptr;
 			}
 
-			zip_file.seekg(central_entry->fileoffset + local_entry.fileoffset);
+			std::streamoff data_offset = central_entry->fileoffset + local_entry.fileoffset;
+
+			// When the archive is memory mapped the entry data can be used in place
+			auto archive_data = zip_file.GetData();
+			bool in_archive_data = static_cast<size_t>(data_offset) + local_entry.compressed_size <= archive_data.size();
+			if (method == StorageMethod::Plain && in_archive_data && local_entry.compressed_size == local_entry.uncompressed_size) {
+				auto entry_data = archive_data.subspan(data_offset, local_entry.uncompressed_size);
+				return new ZipViewStreamBuf(std::move(zip_file), entry_data);
+			}
+
+			if (local_entry.uncompressed_size > stream_threshold && (method == StorageMethod::Plain || method == StorageMethod::Deflate)) {
+				// Large files (usually music) are decompressed on demand
+				return new ZipStreamBuf(std::move(zip_file), data_offset, local_entry.compressed_size,
+					local_entry.uncompressed_size, method == StorageMethod::Deflate, path_normalized);
+			}
+
+			zip_file.seekg(data_offset);
 			if (method == StorageMethod::Plain) {
 				auto data = std::vector<uint8_t>(local_entry.uncompressed_size);
 				zip_file.read(reinterpret_cast<char*>(data.data()), data.size());
 				return new Filesystem_Stream::InputMemoryStreamBuf(std::move(data));
 			} else if (method == StorageMethod::Deflate) {
 				std::vector<uint8_t> comp_buf;
-				comp_buf.resize(local_entry.compressed_size);
-				zip_file.read(reinterpret_cast<char*>(comp_buf.data()), comp_buf.size());
+				const uint8_t* comp_data;
+				if (in_archive_data) {
+					comp_data = archive_data.data() + data_offset;
+				} else {
+					comp_buf.resize(local_entry.compressed_size);
+					zip_file.read(reinterpret_cast<char*>(comp_buf.data()), comp_buf.size());
+					comp_data = comp_buf.data();
+				}
 				auto dec_buf = std::vector<uint8_t>(local_entry.uncompressed_size);
 				z_stream zlib_stream = {};
-				zlib_stream.next_in = reinterpret_cast<Bytef*>(comp_buf.data());
-				zlib_stream.avail_in = static_cast<uInt>(comp_buf.size());
+				zlib_stream.next_in = const_cast<Bytef*>(comp_data);
+				zlib_stream.avail_in = static_cast<uInt>(local_entry.compressed_size);
 				zlib_stream.next_out = reinterpret_cast<Bytef*>(dec_buf.data());
 				zlib_stream.avail_out = static_cast<uInt>(dec_buf.size());
 				inflateInit2(&zlib_stream, -MAX_WBITS);
@@ -44,6 +44,7 @@
 #include "filefinder.h"
 #include "output.h"
 #include "font.h"
+#include "glyph_atlas.h"
 #include "bitmap.h"
 #include "utils.h"
 #include "cache.h"
@@ -178,6 +179,10 @@ namespace {
 	FontRef default_gothic;
 	FontRef default_mincho;
 
+	/** Glyph atlas sizes, 256 fits 441 glyphs of the builtin fonts */
+	constexpr int bitmap_font_atlas_size = 256;
+	constexpr int ft_font_atlas_size = 512;
+
 	struct ExFont final : public Font {
 		public:
 			enum { HEIGHT = 12, WIDTH = 12 };
@@ -235,7 +240,9 @@ namespace {
 
 BitmapFont::BitmapFont(StringView name, function_type func)
 	: Font(name, HEIGHT, false, false), func(func)
-{}
+{
+	EnableGlyphCache(bitmap_font_atlas_size);
+}
 
 Rect BitmapFont::vGetSize(char32_t glyph) const {
 	auto bm_glyph = func(glyph);
@@ -306,6 +313,8 @@ FTFont::FTFont(Filesystem_Stream::InputStream is, int size, bool bold, bool ital
 		// Workaround for bad kerning in RM2000 and RMG2000 fonts
 		rm2000_workaround = true;
 	}
+
+	EnableGlyphCache(ft_font_atlas_size);
 }
 
 FTFont::~FTFont() {
@@ -594,6 +603,11 @@ FontRef Font::CreateFtFont(Filesystem_Stream::InputStream is, int size, bool bol
 void Font::ResetDefault() {
 	SetDefault(nullptr, true);
 	SetDefault(nullptr, false);
+
+	// The glyph lookup of the builtin fonts depends on the encoding of the game
+	for (auto& font : { gothic, mincho, rmg2000, ttyp0 }) {
+		font->ClearGlyphCache();
+	}
 }
 
 void Font::Dispose() {
@@ -617,6 +631,41 @@ Font::Font(StringView name, int size, bool bold, bool italic)
 	current_style = original_style;
 }
 
+Font::~Font() = default;
+
+void Font::EnableGlyphCache(int atlas_size) {
+	glyph_atlas = std::make_unique<GlyphAtlas>(atlas_size, atlas_size);
+}
+
+void Font::ClearGlyphCache() {
+	if (glyph_atlas) {
+		glyph_atlas->Clear();
+	}
+}
+
+Font::GlyphRet Font::RenderGlyph(char32_t glyph, bool shaped) const {
+	GlyphRet gret;
+
+	if (!glyph_atlas) {
+		gret = shaped ? vRenderShaped(glyph) : vRender(glyph);
+		gret.rect = gret.bitmap->GetRect();
+		return gret;
+	}
+
+	const auto key = GlyphAtlas::MakeKey(glyph, shaped, current_style.size);
+	if (glyph_atlas->Find(key, gret)) {
+		return gret;
+	}
+
+	gret = shaped ? vRenderShaped(glyph) : vRender(glyph);
+	if (!glyph_atlas->Insert(key, gret)) {
+		// Larger than the atlas
+		gret.rect = gret.bitmap->GetRect();
+	}
+
+	return gret;
+}
+
 Rect Font::GetSize(char32_t glyph) const {
 	if (EP_UNLIKELY(Utils::IsControlCharacter(glyph))) {
 		if (glyph == '\n') {
@@ -626,7 +675,17 @@ Rect Font::GetSize(char32_t glyph) const {
 		return {};
 	}
 
-	Rect size = vGetSize(glyph);
+	Rect size;
+	if (glyph_atlas) {
+		const auto key = GlyphAtlas::MakeKey(glyph, false, current_style.size);
+		if (!glyph_atlas->FindSize(key, size)) {
+			size = vGetSize(glyph);
+			glyph_atlas->InsertSize(key, size);
+		}
+	} else {
+		size = vGetSize(glyph);
+	}
+
 	size.width += current_style.letter_spacing;
 	size.height = current_style.size;
 
@@ -644,9 +703,9 @@ Point Font::Render(Bitmap& dest, int const x, int const y, const Bitmap& sys, in
 		return {};
 	}
 
-	auto gret = vRender(glyph);
+	auto gret = RenderGlyph(glyph, false);
 
-	auto rect = Rect(x, y, gret.bitmap->width(), gret.bitmap->height());
+	auto rect = Rect(x, y, gret.rect.width, gret.rect.height);
 	if (EP_UNLIKELY(rect.width == 0)) {
 		return {};
 	}
@@ -660,7 +719,7 @@ Point Font::Render(Bitmap& dest, int const x, int const y, const Bitmap& sys, in
 	if (color != ColorShadow) {
 		if (!gret.has_color && current_style.draw_shadow) {
 			auto shadow_rect = Rect(rect.x + 1, rect.y + 1, rect.width, rect.height);
-			dest.MaskedBlit(shadow_rect, *gret.bitmap, 0, 0, sys, 16, 32);
+			dest.MaskedBlit(shadow_rect, *gret.bitmap, gret.rect.x, gret.rect.y, sys, 16, 32);
 		}
 
 		src_x = color % 10 * 16 + 2;
@@ -674,19 +733,19 @@ Point Font::Render(Bitmap& dest, int const x, int const y, const Bitmap& sys, in
 		if (current_style.draw_gradient) {
 			// When the glyph is large the system graphic color mask will be outside the rectangle
 			// Move the mask slightly up to avoid this
-			int offset = gret.bitmap->height() - gret.offset.y;
+			int offset = gret.rect.height - gret.offset.y;
 			if (offset > 12) {
 				src_y -= offset - 12;
 			}
 
-			dest.MaskedBlit(rect, *gret.bitmap, 0, 0, sys, src_x, src_y);
+			dest.MaskedBlit(rect, *gret.bitmap, gret.rect.x, gret.rect.y, sys, src_x, src_y);
 		} else {
 			auto col = sys.GetColorAt(current_style.color_offset.x + src_x, current_style.color_offset.y + src_y);
-			auto col_bm = Bitmap::Create(gret.bitmap->width(), gret.bitmap->height(), col);
-			dest.MaskedBlit(rect, *gret.bitmap, 0, 0, *col_bm, 0, 0);
+			auto col_bm = Bitmap::Create(gret.rect.width, gret.rect.height, col);
+			dest.MaskedBlit(rect, *gret.bitmap, gret.rect.x, gret.rect.y, *col_bm, 0, 0);
 		}
 	} else {
-		dest.Blit(rect.x, rect.y, *gret.bitmap, gret.bitmap->GetRect(), Opacity::Opaque());
+		dest.Blit(rect.x, rect.y, *gret.bitmap, gret.rect, Opacity::Opaque());
 	}
 
 	gret.advance.x += current_style.letter_spacing;
@@ -699,9 +758,9 @@ Point Font::Render(Bitmap& dest, int const x, int const y, const Bitmap& sys, in
 		return Render(dest, x, y, sys, color, shape.code);
 	}
 
-	auto gret = vRenderShaped(shape.code);
+	auto gret = RenderGlyph(shape.code, true);
 
-	auto rect = Rect(x, y, gret.bitmap->width(), gret.bitmap->height());
+	auto rect = Rect(x, y, gret.rect.width, gret.rect.height);
 	if (EP_UNLIKELY(rect.width == 0)) {
 		return {};
 	}
@@ -715,7 +774,7 @@ Point Font::Render(Bitmap& dest, int const x, int const y, const Bitmap& sys, in
 	if (color != ColorShadow) {
 		if (!gret.has_color && current_style.draw_shadow) {
 			auto shadow_rect = Rect(rect.x + 1, rect.y + 1, rect.width, rect.height);
-			dest.MaskedBlit(shadow_rect, *gret.bitmap, 0, 0, sys, 16, 32);
+			dest.MaskedBlit(shadow_rect, *gret.bitmap, gret.rect.x, gret.rect.y, sys, 16, 32);
 		}
 
 		src_x = color % 10 * 16 + 2;
@@ -723,7 +782,7 @@ Point Font::Render(Bitmap& dest, int const x, int const y, const Bitmap& sys, in
 
 		// When the glyph is large the system graphic color mask will be outside the rectangle
 		// Move the mask slightly up to avoid this
-		int offset = gret.bitmap->height() - shape.offset.y - gret.offset.y;
+		int offset = gret.rect.height - shape.offset.y - gret.offset.y;
 		if (offset > 12) {
 			src_y -= offset - 12;
 		}
@@ -733,9 +792,9 @@ Point Font::Render(Bitmap& dest, int const x, int const y, const Bitmap& sys, in
 	}
 
 	if (!gret.has_color) {
-		dest.MaskedBlit(rect, *gret.bitmap, 0, 0, sys, src_x, src_y);
+		dest.MaskedBlit(rect, *gret.bitmap, gret.rect.x, gret.rect.y, sys, src_x, src_y);
 	} else {
-		dest.Blit(rect.x, rect.y, *gret.bitmap, gret.bitmap->GetRect(), Opacity::Opaque());
+		dest.Blit(rect.x, rect.y, *gret.bitmap, gret.rect, Opacity::Opaque());
 	}
 
 	Point advance = { shape.advance.x + current_style.letter_spacing, shape.advance.y };
@@ -747,10 +806,10 @@ Point Font::Render(Bitmap& dest, int x, int y, Color const& color, char32_t glyp
 		return {};
 	}
 
-	auto gret = vRender(glyph);
+	auto gret = RenderGlyph(glyph, false);
 
-	auto rect = Rect(x, y, gret.bitmap->width(), gret.bitmap->height());
-	dest.MaskedBlit(rect, *gret.bitmap, 0, 0, color);
+	auto rect = Rect(x, y, gret.rect.width, gret.rect.height);
+	dest.MaskedBlit(rect, *gret.bitmap, gret.rect.x, gret.rect.y, color);
 
 	gret.advance.x += current_style.letter_spacing;
 
@@ -769,6 +828,9 @@ std::vector<Font::ShapeRet> Font::Shape(U32StringView text) const {
 
 void Font::SetFallbackFont(FontRef fallback_font) {
 	this->fallback_font = fallback_font;
+
+	// Glyphs missing in this font were rendered by the old fallback
+	ClearGlyphCache();
 }
 
 bool Font::IsStyleApplied() const {
@@ -25,11 +25,12 @@
 #include "memory_management.h"
 #include "rect.h"
 #include "string_view.h"
+#include <memory>
 #include <string>
 #include <lcf/scope_guard.h>
 
 class Color;
-class Rect;
+class GlyphAtlas;
 
 /**
  * Font class.
@@ -55,6 +56,11 @@ class Font {
 		Point offset;
 		/** When enabled the glyph is colored and not masked with the system graphic */
 		bool has_color = false;
+		/**
+		 * Area of bitmap containing the glyph pixels.
+		 * Only set by the glyph cache, the v-functions render into a bitmap of their own.
+		 */
+		Rect rect;
 	};
 
 	/** Contains metrics of a glyph shaped by Harfbuzz */
@@ -96,7 +102,7 @@ class Font {
 		int letter_spacing = 0;
 	};
 
-	virtual ~Font() = default;
+	virtual ~Font();
 
 	/**
 	 * Determines the size of a bitmap required to render a single character.
@@ -190,6 +196,12 @@ class Font {
 	 */
 	void SetFallbackFont(FontRef fallback_font);
 
+	/**
+	 * Removes all glyphs rendered by this font from the glyph cache.
+	 * Must be called when the glyphs returned by the v-functions change.
+	 */
+	void ClearGlyphCache();
+
 	using StyleScopeGuard = lcf::ScopeGuard<std::function<void()>>;
 
 	/**
@@ -252,11 +264,32 @@ class Font {
  protected:
 	Font(StringView name, int size, bool bold, bool italic);
 
+	/**
+	 * Enables caching of rendered glyphs and glyph sizes.
+	 * Only useful when rendering a glyph is more expensive than copying it.
+	 *
+	 * @param atlas_size width and height of the glyph atlas
+	 */
+	void EnableGlyphCache(int atlas_size);
+
 	std::string name;
 	bool style_applied = false;
 	Style original_style;
 	Style current_style;
 	FontRef fallback_font;
+
+ private:
+	/**
+	 * Renders a glyph or fetches it from the glyph cache.
+	 *
+	 * @param glyph codepoint, or glyph index when shaped
+	 * @param shaped whether to call vRenderShaped or vRender
+	 * @return glyph, rect is always set
+	 */
+	GlyphRet RenderGlyph(char32_t glyph, bool shaped) const;
+
+	/** nullptr when glyph caching is disabled */
+	std::unique_ptr<GlyphAtlas> glyph_atlas;
 };
 
 #endif
@@ -15,6 +15,7 @@
  * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <sstream>
 
 #include "fps_overlay.h"
@@ -24,6 +25,8 @@
 #include "input.h"
 #include "font.h"
 #include "drawable_mgr.h"
+#include "instrumentation.h"
+#include "player.h"
 
 using namespace std::chrono_literals;
 
@@ -41,6 +44,19 @@ void FpsOverlay::UpdateText() {
 	auto fps = Utils::RoundTo<int>(Game_Clock::GetFPS());
 	text = "FPS: " + std::to_string(fps);
 	fps_dirty = true;
+
+	profile_lines.clear();
+	profile_rect = {};
+	if (Instrumentation::IsProfilerEnabled()) {
+		for (auto& zone: Instrumentation::GetProfilerSummary(fps > 0 ? fps : 60)) {
+			profile_lines.push_back(fmt::format("{}{}: {:.2f}ms", std::string(zone.depth * 2, ' '), zone.name, zone.ms));
+
+			Rect rect = Text::GetSize(*Font::DefaultBitmapFont(), profile_lines.back());
+			profile_rect.width = std::max(profile_rect.width, rect.width + 1);
+			profile_rect.height += rect.height;
+		}
+	}
+	profile_dirty = true;
 }
 
 bool FpsOverlay::Update() {
@@ -62,6 +78,31 @@ bool FpsOverlay::Update() {
 	return true;
 }
 
+bool FpsOverlay::GetDamage(Rect& damage) {
+	std::pair<std::string, int> state = { "", 1 };
+	if (IsVisible()) {
+		state = { draw_fps ? text : std::string(), last_speed_mod };
+		if (draw_fps) {
+			for (auto& line: profile_lines) {
+				state.first += "\n" + line;
+			}
+		}
+	}
+
+	Rect bounds;
+	if (!state.first.empty() || state.second > 1) {
+		// Both texts are drawn in a single line at the top of the screen
+		bounds = Rect(0, 0, Player::screen_width, 16);
+		if (draw_fps && !profile_lines.empty()) {
+			// Profiler breakdown below the FPS
+			bounds.height += profile_rect.height + 2;
+		}
+	}
+
+	damage = UpdateDamage(damage_state, state, damage_bounds, bounds);
+	return true;
+}
+
 void FpsOverlay::Draw(Bitmap& dst) {
 	if (draw_fps) {
 		if (fps_dirty) {
@@ -82,6 +123,26 @@ void FpsOverlay::Draw(Bitmap& dst) {
 		}
 
 		dst.Blit(1, 2, *fps_bitmap, fps_rect, 255);
+
+		if (!profile_lines.empty()) {
+			if (profile_dirty) {
+				if (!profile_bitmap || profile_bitmap->GetWidth() < profile_rect.width || profile_bitmap->GetHeight() < profile_rect.height) {
+					profile_bitmap = Bitmap::Create(profile_rect.width, profile_rect.height, true);
+				}
+				profile_bitmap->Clear();
+				profile_bitmap->FillRect(profile_rect, Color(0, 0, 0, 128));
+
+				int y = 0;
+				for (auto& line: profile_lines) {
+					Text::Draw(*profile_bitmap, 1, y, *Font::DefaultBitmapFont(), Color(255, 255, 255, 255), line);
+					y += Text::GetSize(*Font::DefaultBitmapFont(), line).height;
+				}
+
+				profile_dirty = false;
+			}
+
+			dst.Blit(1, 2 + fps_rect.height + 1, *profile_bitmap, profile_rect, 255);
+		}
 	}
 
 	// Always drawn when speedup is on independent of FPS
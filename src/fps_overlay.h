@@ -20,6 +20,8 @@
 
 #include <deque>
 #include <string>
+#include <utility>
+#include <vector>
 #include "drawable.h"
 #include "memory_management.h"
 #include "rect.h"
@@ -28,6 +30,7 @@
 /**
  * FpsOverlay class.
  * Shows current FPS and the speedup indicator.
+ * When the frame profiler is enabled the time per zone is listed below the FPS.
  */
 class FpsOverlay : public Drawable {
 public:
@@ -35,6 +38,8 @@ public:
 
 	void Draw(Bitmap& dst) override;
 
+	bool GetDamage(Rect& damage) override;
+
 	/**
 	 * Update the fps overlay.
 	 *
@@ -69,9 +74,20 @@ private:
 
 	std::string text;
 
+	/** Profiler breakdown, one line per zone */
+	std::vector<std::string> profile_lines;
+	BitmapRef profile_bitmap;
+	Rect profile_rect;
+
 	int last_speed_mod = 1;
+
+	/** Drawn fps text and speed modifier of the last frame, for damage tracking */
+	std::pair<std::string, int> damage_state = { "", 1 };
+	Rect damage_bounds;
+
 	bool speedup_dirty = true;
 	bool fps_dirty = true;
+	bool profile_dirty = true;
 	bool draw_fps = true;
 };
 
@@ -47,6 +47,19 @@ void Frame::Draw(Bitmap& dst) {
 	}
 }
 
+bool Frame::GetDamage(Rect& damage) {
+	std::pair<const Bitmap*, uint32_t> state = { nullptr, 0 };
+	Rect bounds;
+
+	if (IsVisible() && frame_bitmap) {
+		state = { frame_bitmap.get(), frame_bitmap->GetRevision() };
+		bounds = frame_bitmap->GetRect();
+	}
+
+	damage = UpdateDamage(damage_state, state, damage_bounds, bounds);
+	return true;
+}
+
 void Frame::OnFrameGraphicReady(FileRequestResult* result) {
 	frame_bitmap = Cache::Frame(result->file);
 }
@@ -20,6 +20,7 @@
 
 // Headers
 #include <string>
+#include <utility>
 #include "drawable.h"
 #include "system.h"
 #include "async_handler.h"
@@ -32,6 +33,7 @@ public:
 	Frame();
 
 	void Draw(Bitmap& dst) override;
+	bool GetDamage(Rect& damage) override;
 	void Update();
 
 private:
@@ -39,6 +41,10 @@ private:
 
 	BitmapRef frame_bitmap;
 
+	/** Drawn bitmap and its revision of the last frame, for damage tracking */
+	std::pair<const Bitmap*, uint32_t> damage_state = { nullptr, 0 };
+	Rect damage_bounds;
+
 	FileRequestBinding request_id;
 };
 
@@ -814,6 +814,10 @@ int Game_Character::GetSpriteY() const {
 	return y;
 }
 
+void Game_Character::OnEventPositionChanged() {
+	Game_Map::UpdateEventPosition(*this);
+}
+
 bool Game_Character::IsInPosition(int x, int y) const {
 	return ((GetX() == x) && (GetY() == y));
 }
@@ -884,6 +884,9 @@ protected:
 	lcf::rpg::SaveMapEventBase* data();
 	const lcf::rpg::SaveMapEventBase* data() const;
 
+	/** Notifies the map that the position of this event changed */
+	void OnEventPositionChanged();
+
 	int original_move_frequency = 2;
 	// contains if any movement (<= step_forward) of a forced move route was successful
 
@@ -937,6 +940,9 @@ inline int Game_Character::GetX() const {
 
 inline void Game_Character::SetX(int new_x) {
 	data()->position_x = new_x;
+	if (_type == Event) {
+		OnEventPositionChanged();
+	}
 }
 
 inline int Game_Character::GetY() const {
@@ -945,6 +951,9 @@ inline int Game_Character::GetY() const {
 
 inline void Game_Character::SetY(int new_y) {
 	data()->position_y = new_y;
+	if (_type == Event) {
+		OnEventPositionChanged();
+	}
 }
 
 inline int Game_Character::GetMapId() const {
@@ -57,6 +57,8 @@ void Game_ConfigVideo::Hide() {
 	scaling_mode.SetOptionVisible(false);
 	stretch.SetOptionVisible(false);
 	touch_ui.SetOptionVisible(false);
+	retained_render.SetOptionVisible(false);
+	threaded_render.SetOptionVisible(false);
 	game_resolution.SetOptionVisible(false);
 }
 
@@ -296,6 +298,22 @@ void Game_Config::LoadFromArgs(CmdlineParser& cp) {
 			video.stretch.Set(false);
 			continue;
 		}
+		if (cp.ParseNext(arg, 0, "--retained-render")) {
+			video.retained_render.Set(true);
+			continue;
+		}
+		if (cp.ParseNext(arg, 0, "--no-retained-render")) {
+			video.retained_render.Set(false);
+			continue;
+		}
+		if (cp.ParseNext(arg, 0, "--threaded-render")) {
+			video.threaded_render.Set(true);
+			continue;
+		}
+		if (cp.ParseNext(arg, 0, "--no-threaded-render")) {
+			video.threaded_render.Set(false);
+			continue;
+		}
 		if (cp.ParseNext(arg, 1, "--scaling")) {
 			if (arg.ParseValue(0, str_value)) {
 				video.scaling_mode.SetFromString(str_value);
@@ -357,6 +375,8 @@ void Game_Config::LoadFromStream(Filesystem_Stream::InputStream& is) {
 	video.scaling_mode.FromIni(ini);
 	video.stretch.FromIni(ini);
 	video.touch_ui.FromIni(ini);
+	video.retained_render.FromIni(ini);
+	video.threaded_render.FromIni(ini);
 	video.game_resolution.FromIni(ini);
 
 	if (ini.HasValue("Video", "WindowX") && ini.HasValue("Video", "WindowY") && ini.HasValue("Video", "WindowWidth") && ini.HasValue("Video", "WindowHeight")) {
@@ -438,6 +458,8 @@ void Game_Config::WriteToStream(Filesystem_Stream::OutputStream& os) const {
 	video.scaling_mode.ToIni(os);
 	video.stretch.ToIni(os);
 	video.touch_ui.ToIni(os);
+	video.retained_render.ToIni(os);
+	video.threaded_render.ToIni(os);
 	video.game_resolution.ToIni(os);
 
 	// only preserve when toggling between window and fullscreen is supported
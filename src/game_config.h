@@ -75,6 +75,8 @@ struct Game_ConfigVideo {
 		Utils::MakeSvArray("Scale to screen size (Causes scaling artifacts)", "Scale to multiple of the game resolution", "Like Nearest, but output is blurred to avoid artifacts")};
 	BoolConfigParam stretch{ "Stretch", "Stretch to the width of the window/screen", "Video", "Stretch", false };
 	BoolConfigParam touch_ui{ "Touch Ui", "Display the touch ui", "Video", "TouchUi", true };
+	BoolConfigParam retained_render{ "Retained rendering", "Only redraw changed parts of the screen. Saves power on static scenes", "Video", "RetainedRender", false };
+	BoolConfigParam threaded_render{ "Threaded rendering", "Present the screen while the next frames are simulated on a separate thread", "Video", "ThreadedRender", false };
 	EnumConfigParam<GameResolution, 3> game_resolution{ "Resolution", "Game resolution. Changes require a restart.", "Video", "GameResolution", GameResolution::Original,
 		Utils::MakeSvArray("Original (Recommended)", "Widescreen (Experimental)", "Ultrawide (Experimental)"),
 		Utils::MakeSvArray("original", "widescreen", "ultrawide"),
@@ -72,6 +72,22 @@ void Game_ConfigGame::LoadFromArgs(CmdlineParser& cp) {
 			new_game.Set(false);
 			continue;
 		}
+		if (cp.ParseNext(arg, 0, "--asset-index")) {
+			asset_index.Set(true);
+			continue;
+		}
+		if (cp.ParseNext(arg, 0, "--no-asset-index")) {
+			asset_index.Set(false);
+			continue;
+		}
+		if (cp.ParseNext(arg, 0, "--map-prefetch")) {
+			map_prefetch.Set(true);
+			continue;
+		}
+		if (cp.ParseNext(arg, 0, "--no-map-prefetch")) {
+			map_prefetch.Set(false);
+			continue;
+		}
 		if (cp.ParseNext(arg, 1, "--engine")) {
 			if (arg.NumValues() > 0) {
 				const auto& v = arg.Value(0);
@@ -127,6 +143,8 @@ void Game_ConfigGame::LoadFromStream(Filesystem_Stream::InputStream& is) {
 	new_game.FromIni(ini);
 	engine_str.FromIni(ini);
 	fake_resolution.FromIni(ini);
+	asset_index.FromIni(ini);
+	map_prefetch.FromIni(ini);
 
 	if (patch_dynrpg.FromIni(ini)) {
 		patch_override = true;
@@ -38,6 +38,8 @@ struct Game_ConfigGame {
 	BoolConfigParam new_game{ "Start new game", "Skips the title screen and starts a new game directly", "Game", "NewGame", false };
 	StringConfigParam engine_str{ "Engine", "", "Game", "Engine", std::string() };
 	BoolConfigParam fake_resolution{ "Fake Metrics", "Makes games run on higher resolutions (with some success)", "Game", "FakeResolution", false };
+	BoolConfigParam asset_index{ "Asset index", "Remember the directory listings in the save directory to speed up the next start", "Game", "AssetIndex", false };
+	BoolConfigParam map_prefetch{ "Map prefetch", "Parses the maps reachable by teleports of the current map in the background", "Game", "MapPrefetch", true };
 	BoolConfigParam patch_dynrpg{ "DynRPG", "", "Patch", "DynRPG", false };
 	BoolConfigParam patch_maniac{ "Maniac Patch", "", "Patch", "Maniac", false };
 	BoolConfigParam patch_common_this_event{ "Common This Event", "Support \"This Event\" in Common Events", "Patch", "CommonThisEvent", false };
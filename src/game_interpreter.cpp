@@ -38,18 +38,22 @@
 #include "game_actors.h"
 #include "game_system.h"
 #include "game_message.h"
+#include "instrumentation.h"
 #include "game_pictures.h"
 #include "game_screen.h"
 #include "game_interpreter_control_variables.h"
 #include "game_windows.h"
 #include "maniac_patch.h"
+#include "map_cache.h"
 #include "spriteset_map.h"
 #include "sprite_character.h"
+#include "save_header.h"
 #include "scene_gameover.h"
 #include "scene_map.h"
 #include "scene_save.h"
 #include "scene_settings.h"
 #include "scene.h"
+#include "simulation_thread.h"
 #include "game_clock.h"
 #include "input.h"
 #include "main_data.h"
@@ -89,6 +93,7 @@ void Game_Interpreter::Clear() {
 	_state = {};
 	_keyinput = {};
 	_async_op = {};
+	jump_tables.clear();
 }
 
 // Is interpreter running.
@@ -123,6 +128,7 @@ void Game_Interpreter::Push(
 		Main_Data::game_player->SetEncounterCalling(false);
 	}
 
+	TrimJumpTables();
 	_state.stack.push_back(std::move(frame));
 }
 
@@ -350,6 +356,8 @@ int Game_Interpreter::GetSubcommandIndex(int indent) const {
 
 // Update
 void Game_Interpreter::Update(bool reset_loop_count) {
+	Instrumentation::Zone zone("Interpreter");
+
 	if (reset_loop_count) {
 		loop_count = 0;
 	}
@@ -550,14 +558,28 @@ void Game_Interpreter::SkipToNextConditional(std::initializer_list<Cmd> codes, i
 		return;
 	}
 
-	for (++index; index < static_cast<int>(list.size()); ++index) {
-		const auto& com = list[index];
-		if (com.indent > indent) {
-			continue;
-		}
-		if (std::find(codes.begin(), codes.end(), static_cast<Cmd>(com.code)) != codes.end()) {
-			break;
-		}
+	index = GetJumpTable().FindNext(index, codes, indent);
+}
+
+const Game_Interpreter_JumpTable& Game_Interpreter::GetJumpTable() {
+	const auto& frame = GetFrame();
+	const size_t frame_idx = _state.stack.size() - 1;
+
+	if (jump_tables.size() <= frame_idx) {
+		jump_tables.resize(frame_idx + 1);
+	}
+
+	auto& table = jump_tables[frame_idx];
+	if (!table) {
+		table = std::make_unique<Game_Interpreter_JumpTable>(frame.commands);
+	}
+
+	return *table;
+}
+
+void Game_Interpreter::TrimJumpTables() {
+	if (jump_tables.size() > _state.stack.size()) {
+		jump_tables.resize(_state.stack.size());
 	}
 }
 
@@ -851,6 +873,7 @@ bool Game_Interpreter::OnFinishStackFrame() {
 	} else {
 		// If a called frame, or base frame of foreground interpreter, pop the stack.
 		_state.stack.pop_back();
+		TrimJumpTables();
 	}
 
 	return !is_base_frame;
@@ -3615,18 +3638,13 @@ bool Game_Interpreter::CommandEndBranch(lcf::rpg::EventCommand const& /* com */)
 
 bool Game_Interpreter::CommandJumpToLabel(lcf::rpg::EventCommand const& com) { // code 12120
 	auto& frame = GetFrame();
-	const auto& list = frame.commands;
 	auto& index = frame.current_command;
 
 	int label_id = com.parameters[0];
 
-	for (int idx = 0; (size_t)idx < list.size(); idx++) {
-		if (static_cast<Cmd>(list[idx].code) != Cmd::Label)
-			continue;
-		if (list[idx].parameters[0] != label_id)
-			continue;
+	int idx = GetJumpTable().FindLabel(label_id);
+	if (idx >= 0) {
 		index = idx;
-		break;
 	}
 
 	return true;
@@ -3710,12 +3728,9 @@ bool Game_Interpreter::CommandBreakLoop(lcf::rpg::EventCommand const& /* com */)
 
 	// This emulates an RPG_RT bug where break loop ignores scopes and
 	// unconditionally jumps to the next EndLoop command.
-	auto pcode = static_cast<Cmd>(list[index].code);
-	for (++index; index < (int)list.size(); ++index) {
-		if (pcode == Cmd::EndLoop) {
-			break;
-		}
-		pcode = static_cast<Cmd>(list[index].code);
+	index = GetJumpTable().FindNextEndLoop(index);
+	if (index < (int)list.size()) {
+		++index;
 	}
 
 	return true;
@@ -3780,15 +3795,12 @@ bool Game_Interpreter::CommandEndLoop(lcf::rpg::EventCommand const& com) { // co
 	}
 
 	// Restart the loop
-	for (int idx = index; idx >= 0; idx--) {
-		if (list[idx].indent > indent)
-			continue;
-		if (list[idx].indent < indent)
+	int idx = GetJumpTable().FindPrev(index, Cmd::Loop, indent);
+	if (idx >= 0) {
+		if (list[idx].indent < indent) {
 			return false;
-		if (static_cast<Cmd>(list[idx].code) != Cmd::Loop)
-			continue;
+		}
 		index = idx;
-		break;
 	}
 
 	// Jump past the Cmd::Loop to the first command.
@@ -3970,7 +3982,7 @@ bool Game_Interpreter::CommandToggleFullscreen(lcf::rpg::EventCommand const& /*
 		return true;
 	}
 
-	DisplayUi->ToggleFullscreen();
+	SimulationThread::RunOnMainThread([]() { DisplayUi->ToggleFullscreen(); });
 	return true;
 }
 
@@ -4025,25 +4037,25 @@ bool Game_Interpreter::CommandManiacGetSaveInfo(lcf::rpg::EventCommand const& co
 		return true;
 	}
 
-	auto save = lcf::LSD_Reader::Load(save_stream, Player::encoding);
-	if (!save) {
+	auto title = SaveHeader::ReadTitle(save_stream, Player::encoding);
+	if (!title) {
 		Output::Debug("ManiacGetSaveInfo: Save corrupted {}", save_number);
 		// Maniac Patch writes this for whatever reason
 		Main_Data::game_variables->Set(com.parameters[2], 8991230);
 		return true;
 	}
 
-	std::time_t t = lcf::LSD_Reader::ToUnixTimestamp(save->title.timestamp);
+	std::time_t t = lcf::LSD_Reader::ToUnixTimestamp(title->timestamp);
 	std::tm* tm = std::gmtime(&t);
 
 	Main_Data::game_variables->Set(com.parameters[2], atoi(Utils::FormatDate(tm, Utils::DateFormat_YYMMDD).c_str()));
 	Main_Data::game_variables->Set(com.parameters[3], atoi(Utils::FormatDate(tm, Utils::DateFormat_HHMMSS).c_str()));
-	Main_Data::game_variables->Set(com.parameters[4], save->title.hero_level);
-	Main_Data::game_variables->Set(com.parameters[5], save->title.hero_hp);
+	Main_Data::game_variables->Set(com.parameters[4], title->hero_level);
+	Main_Data::game_variables->Set(com.parameters[5], title->hero_hp);
 	Game_Map::SetNeedRefresh(true);
 
-	auto face_ids = Utils::MakeArray(save->title.face1_id, save->title.face2_id, save->title.face3_id, save->title.face4_id);
-	auto face_names = Utils::MakeArray(save->title.face1_name, save->title.face2_name, save->title.face3_name, save->title.face4_name);
+	auto face_ids = Utils::MakeArray(title->face1_id, title->face2_id, title->face3_id, title->face4_id);
+	auto face_names = Utils::MakeArray(title->face1_name, title->face2_name, title->face3_name, title->face4_name);
 
 	for (int i = 0; i <= 3; ++i) {
 		const int param = 8 + i;
@@ -4119,7 +4131,11 @@ bool Game_Interpreter::CommandManiacLoad(lcf::rpg::EventCommand const& com) {
 	auto savefs = FileFinder::Save();
 	std::string save_name = Scene_Save::GetSaveFilename(savefs, slot);
 	auto save_stream = FileFinder::Save().OpenInputStream(save_name);
-	std::unique_ptr<lcf::rpg::Save> save = lcf::LSD_Reader::Load(save_stream, Player::encoding);
+	std::unique_ptr<lcf::rpg::Save> save;
+	{
+		MapCache::ParseLock lock;
+		save = lcf::LSD_Reader::Load(save_stream, Player::encoding);
+	}
 
 	if (!save) {
 		Output::Debug("ManiacLoad: Save not found {}", slot);
@@ -20,6 +20,7 @@
 
 #include <cstdint>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 #include "async_handler.h"
@@ -32,6 +33,7 @@
 #include <lcf/rpg/saveeventexecstate.h>
 #include <lcf/flag_set.h>
 #include "async_op.h"
+#include "game_interpreter_jump_table.h"
 
 class Game_Event;
 class Game_CommonEvent;
@@ -150,6 +152,17 @@ protected:
 	 */
 	void SkipToNextConditional(std::initializer_list<Cmd> codes, int indent);
 
+	/**
+	 * Returns the jump table of the current stack frame.
+	 * The table is built on first use and kept until the frame is popped.
+	 *
+	 * @return jump table of the current frame
+	 */
+	const Game_Interpreter_JumpTable& GetJumpTable();
+
+	/** Drops the jump tables of frames that are not on the stack anymore */
+	void TrimJumpTables();
+
 	/**
 	 * Sets up a wait (and closes the message box)
 	 */
@@ -333,6 +346,9 @@ protected:
 	lcf::rpg::SaveEventExecState _state;
 	KeyInputState _keyinput;
 	AsyncOp _async_op = {};
+
+	/** Lazily built jump tables, one per stack frame */
+	std::vector<std::unique_ptr<Game_Interpreter_JumpTable>> jump_tables;
 };
 
 inline const lcf::rpg::SaveEventExecFrame* Game_Interpreter::GetFramePtr() const {
@@ -0,0 +1,123 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include <algorithm>
+#include "game_interpreter_jump_table.h"
+
+Game_Interpreter_JumpTable::Game_Interpreter_JumpTable(const std::vector<lcf::rpg::EventCommand>& list) {
+	const int size = static_cast<int>(list.size());
+
+	indents.resize(size);
+	codes.resize(size);
+	next_sibling.resize(size);
+	prev_sibling.resize(size);
+	next_end_loop.resize(size);
+
+	for (int i = 0; i < size; ++i) {
+		const auto& com = list[i];
+		indents[i] = com.indent;
+		codes[i] = static_cast<Cmd>(com.code);
+
+		if (codes[i] == Cmd::Label && !com.parameters.empty()) {
+			// Only the first label with an id is reachable
+			labels.emplace(com.parameters[0], i);
+		}
+	}
+
+	std::vector<int> stack;
+
+	int end_loop = size;
+	for (int i = size - 1; i >= 0; --i) {
+		while (!stack.empty() && indents[stack.back()] > indents[i]) {
+			stack.pop_back();
+		}
+		next_sibling[i] = stack.empty() ? size : stack.back();
+		stack.push_back(i);
+
+		next_end_loop[i] = end_loop;
+		if (codes[i] == Cmd::EndLoop) {
+			end_loop = i;
+		}
+	}
+
+	stack.clear();
+	for (int i = 0; i < size; ++i) {
+		while (!stack.empty() && indents[stack.back()] > indents[i]) {
+			stack.pop_back();
+		}
+		prev_sibling[i] = stack.empty() ? -1 : stack.back();
+		stack.push_back(i);
+	}
+}
+
+int Game_Interpreter_JumpTable::FindLabel(int label_id) const {
+	auto it = labels.find(label_id);
+	return it != labels.end() ? it->second : -1;
+}
+
+int Game_Interpreter_JumpTable::FindNext(int index, std::initializer_list<Cmd> search, int indent) const {
+	const int size = GetSize();
+
+	int cur = index;
+	while (cur >= 0 && cur < size) {
+		// All commands between a command and its next sibling are indented deeper.
+		// They can only be skipped when the current command is not less indented
+		// than the searched level (only happens for broken event code).
+		cur = indents[cur] >= indent ? next_sibling[cur] : cur + 1;
+		if (cur >= size) {
+			break;
+		}
+
+		if (indents[cur] <= indent && std::find(search.begin(), search.end(), codes[cur]) != search.end()) {
+			return cur;
+		}
+	}
+
+	return size;
+}
+
+int Game_Interpreter_JumpTable::FindPrev(int index, Cmd code, int indent) const {
+	int cur = std::min(index, GetSize() - 1);
+	if (cur < 0) {
+		return -1;
+	}
+
+	if (indents[cur] < indent || (indents[cur] == indent && codes[cur] == code)) {
+		return cur;
+	}
+
+	while (cur >= 0) {
+		cur = indents[cur] >= indent ? prev_sibling[cur] : cur - 1;
+		if (cur < 0) {
+			break;
+		}
+
+		if (indents[cur] < indent || (indents[cur] == indent && codes[cur] == code)) {
+			return cur;
+		}
+	}
+
+	return -1;
+}
+
+int Game_Interpreter_JumpTable::FindNextEndLoop(int index) const {
+	if (index < 0 || index >= GetSize()) {
+		return GetSize();
+	}
+	return next_end_loop[index];
+}
@@ -0,0 +1,107 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_GAME_INTERPRETER_JUMP_TABLE_H
+#define EP_GAME_INTERPRETER_JUMP_TABLE_H
+
+// Headers
+#include <initializer_list>
+#include <unordered_map>
+#include <vector>
+#include <lcf/rpg/eventcommand.h>
+
+/**
+ * Precomputed jump targets of an event command list.
+ *
+ * The interpreter builds one table per stack frame on the first jump
+ * and reuses it until the frame is popped. This turns the label lookup into
+ * a hash lookup and the conditional/loop scans into walks over the commands
+ * of the same indentation instead of over every command.
+ */
+class Game_Interpreter_JumpTable {
+public:
+	using Cmd = lcf::rpg::EventCommand::Code;
+
+	/**
+	 * Analyzes the command list.
+	 *
+	 * @param list commands of the stack frame
+	 */
+	explicit Game_Interpreter_JumpTable(const std::vector<lcf::rpg::EventCommand>& list);
+
+	/**
+	 * Finds the first Label command with the given id.
+	 *
+	 * @param label_id id of the label
+	 * @return index of the Label command or -1 when not found
+	 */
+	int FindLabel(int label_id) const;
+
+	/**
+	 * Finds the first command after index with com.indent <= indent whose code
+	 * is in codes. Matches the behaviour of Game_Interpreter::SkipToNextConditional.
+	 *
+	 * @param index index to start the search after
+	 * @param codes which codes to check
+	 * @param indent the indentation level to check
+	 * @return index of the command or the list size when not found
+	 */
+	int FindNext(int index, std::initializer_list<Cmd> codes, int indent) const;
+
+	/**
+	 * Searches backwards from index for the command with the given code and indent.
+	 * The search stops at the first command with a lower indentation, which is
+	 * returned instead.
+	 *
+	 * @param index index to start the search at
+	 * @param code code to search for
+	 * @param indent the indentation level to check
+	 * @return index of the command found or -1 when the start of the list is reached
+	 */
+	int FindPrev(int index, Cmd code, int indent) const;
+
+	/**
+	 * Finds the next EndLoop command after index regardless of the indentation.
+	 *
+	 * @param index index to start the search after
+	 * @return index of the EndLoop or the list size when not found
+	 */
+	int FindNextEndLoop(int index) const;
+
+	/** @return amount of commands in the analyzed list */
+	int GetSize() const;
+
+private:
+	/** Indentation of every command */
+	std::vector<int> indents;
+	/** Code of every command */
+	std::vector<Cmd> codes;
+	/** First following command with the same or a lower indentation */
+	std::vector<int> next_sibling;
+	/** Last preceding command with the same or a lower indentation */
+	std::vector<int> prev_sibling;
+	/** Next EndLoop command */
+	std::vector<int> next_end_loop;
+	/** Label id -> index of the first Label command */
+	std::unordered_map<int, int> labels;
+};
+
+inline int Game_Interpreter_JumpTable::GetSize() const {
+	return static_cast<int>(indents.size());
+}
+
+#endif
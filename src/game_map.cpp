@@ -21,8 +21,10 @@
 #include <sstream>
 #include <algorithm>
 #include <climits>
+#include <map>
 
 #include "async_handler.h"
+#include "event_spatial_index.h"
 #include "options.h"
 #include "system.h"
 #include "game_battle.h"
@@ -37,10 +39,9 @@
 #include "game_pictures.h"
 #include "scene_battle.h"
 #include "scene_map.h"
-#include <lcf/lmu/reader.h>
-#include <lcf/reader_lcf.h>
 #include "map_data.h"
 #include "main_data.h"
+#include "map_cache.h"
 #include "output.h"
 #include "util_macro.h"
 #include "game_system.h"
@@ -53,6 +54,7 @@
 #include <lcf/rpg/save.h>
 #include "scene_gameover.h"
 #include "feature.h"
+#include "worker_pool.h"
 
 namespace {
 	// Intended bad value, Game_Map::Init sets them correctly
@@ -70,6 +72,29 @@ namespace {
 	std::vector<unsigned char> passages_up;
 	std::vector<Game_Event> events;
 	std::vector<Game_CommonEvent> common_events;
+	EventSpatialIndex event_index;
+
+	/** A value page conditions depend on and the events using it */
+	struct PageDependency {
+		int id;
+		int value;
+		std::vector<int> slots;
+	};
+
+	/**
+	 * Page condition dependencies of the map events.
+	 * Refresh compares the watched values against the values seen during the
+	 * previous refresh and only re-evaluates the pages of the affected events.
+	 */
+	struct {
+		std::vector<PageDependency> switches;
+		std::vector<PageDependency> variables;
+		std::vector<PageDependency> items;
+		std::vector<PageDependency> actors;
+		std::vector<PageDependency> timers;
+		std::vector<int> dirty_slots;
+		bool refresh_all = true;
+	} page_deps;
 
 	std::unique_ptr<lcf::rpg::Map> map;
 
@@ -91,6 +116,8 @@ namespace {
 
 namespace Game_Map {
 void SetupCommon();
+void RebuildEventIndex();
+void RebuildEventDependencies();
 }
 
 void Game_Map::OnContinueFromBattle() {
@@ -98,6 +125,7 @@ void Game_Map::OnContinueFromBattle() {
 }
 
 static Game_Map::Parallax::Params GetParallaxParams();
+static void PrefetchTeleportTargets();
 
 void Game_Map::Init() {
 	screen_width = (Player::screen_width / 16) * SCREEN_TILE_SIZE;
@@ -129,6 +157,8 @@ void Game_Map::InitCommonEvents() {
 
 void Game_Map::Dispose() {
 	events.clear();
+	event_index.Clear();
+	page_deps = {};
 	map.reset();
 	map_info = {};
 	panorama = {};
@@ -247,6 +277,7 @@ void Game_Map::SetupFromSave(
 			auto& ev = events[i];
 			ev.SetSaveData(map_info.events[i]);
 		}
+		RebuildEventIndex();
 	}
 	map_info.events.clear();
 	interpreter->Clear();
@@ -283,7 +314,18 @@ void Game_Map::SetupFromSave(
 }
 
 std::unique_ptr<lcf::rpg::Map> Game_Map::loadMapFile(int map_id) {
+	// The hash of every loaded map is part of a recording, bypass the cache
+	const bool use_cache = !Input::IsRecording();
+	if (use_cache) {
+		auto map = MapCache::Get(map_id);
+		if (map) {
+			Output::Debug("Loaded Map {} (cached)", Game_Map::ConstructMapName(map_id, false));
+			return map;
+		}
+	}
+
 	std::unique_ptr<lcf::rpg::Map> map;
+	std::string error;
 
 	// Try loading EasyRPG map files first, then fallback to normal RPG Maker
 	// FIXME: Assert map was cached for async platforms
@@ -304,7 +346,7 @@ std::unique_ptr<lcf::rpg::Map> Game_Map::loadMapFile(int map_id) {
 			return nullptr;
 		}
 
-		map = lcf::LMU_Reader::Load(map_stream, Player::encoding);
+		map = MapCache::Load(map_stream, false, Player::encoding, error);
 
 		if (Input::IsRecording()) {
 			map_stream.clear();
@@ -318,18 +360,53 @@ std::unique_ptr<lcf::rpg::Map> Game_Map::loadMapFile(int map_id) {
 			Output::Error("Loading of Map {} failed.\nMap not readable.", map_name);
 			return nullptr;
 		}
-		map = lcf::LMU_Reader::LoadXml(map_stream);
+		map = MapCache::Load(map_stream, true, Player::encoding, error);
 	}
 
 	Output::Debug("Loaded Map {}", map_name);
 
 	if (map.get() == NULL) {
-		Output::ErrorStr(lcf::LcfReader::GetError());
+		Output::ErrorStr(error);
+	} else if (use_cache) {
+		MapCache::Add(map_id, *map);
 	}
 
 	return map;
 }
 
+static void PrefetchTeleportTargets() {
+	// Limits the parsing work (and cache evictions) caused by maps with many exits
+	constexpr int max_prefetch = 4;
+
+	if (!Player::game_config.map_prefetch.Get() || Input::IsRecording() || WorkerPool::Shared().GetThreadCount() == 0) {
+		return;
+	}
+
+	int num_prefetch = 0;
+	for (int target : MapCache::GetTeleportTargets(Game_Map::GetMap(), Game_Map::GetMapId())) {
+		if (num_prefetch >= max_prefetch) {
+			break;
+		}
+		if (MapCache::Contains(target)) {
+			continue;
+		}
+
+		// Same lookup order as loadMapFile, errors are reported when the map is loaded
+		bool is_xml = true;
+		std::string map_file = FileFinder::Game().FindFile(Game_Map::ConstructMapName(target, true));
+		if (map_file.empty()) {
+			is_xml = false;
+			map_file = FileFinder::Game().FindFile(Game_Map::ConstructMapName(target, false));
+		}
+		if (map_file.empty()) {
+			continue;
+		}
+
+		MapCache::Prefetch(target, FileFinder::Game().OpenInputStream(map_file), is_xml, Player::encoding);
+		++num_prefetch;
+	}
+}
+
 void Game_Map::SetupCommon() {
 	if (!Tr::GetCurrentTranslationId().empty()) {
 		//  Build our map translation id.
@@ -355,6 +432,17 @@ void Game_Map::SetupCommon() {
 	for (const auto& ev : map->events) {
 		events.emplace_back(GetMapId(), &ev);
 	}
+	RebuildEventIndex();
+	RebuildEventDependencies();
+
+	PrefetchTeleportTargets();
+}
+
+void Game_Map::RebuildEventIndex() {
+	event_index.Reset(GetTilesX(), GetTilesY(), static_cast<int>(events.size()));
+	for (size_t i = 0; i < events.size(); ++i) {
+		event_index.Update(static_cast<int>(i), events[i].GetX(), events[i].GetY());
+	}
 }
 
 void Game_Map::PrepareSave(lcf::rpg::Save& save) {
@@ -415,11 +503,120 @@ std::vector<uint8_t> Game_Map::GetTilesLayer(int layer) {
 	return layer >= 1 ? map_info.upper_tiles : map_info.lower_tiles;
 }
 
+static void AddPageDependency(std::map<int, std::vector<int>>& deps, int id, int slot) {
+	auto& slots = deps[id];
+	if (slots.empty() || slots.back() != slot) {
+		slots.push_back(slot);
+	}
+}
+
+static std::vector<PageDependency> MakePageDependencies(const std::map<int, std::vector<int>>& deps) {
+	std::vector<PageDependency> result;
+	result.reserve(deps.size());
+	for (auto& dep: deps) {
+		result.push_back({ dep.first, 0, dep.second });
+	}
+	return result;
+}
+
+void Game_Map::RebuildEventDependencies() {
+	std::map<int, std::vector<int>> switches, variables, items, actors, timers;
+
+	// The events are created in the order of the map events
+	for (size_t i = 0; i < map->events.size(); ++i) {
+		const int slot = static_cast<int>(i);
+		for (const auto& page: map->events[i].pages) {
+			const auto& cond = page.condition;
+			if (cond.flags.switch_a) {
+				AddPageDependency(switches, cond.switch_a_id, slot);
+			}
+			if (cond.flags.switch_b) {
+				AddPageDependency(switches, cond.switch_b_id, slot);
+			}
+			if (cond.flags.variable) {
+				AddPageDependency(variables, cond.variable_id, slot);
+			}
+			if (cond.flags.item) {
+				AddPageDependency(items, cond.item_id, slot);
+			}
+			if (cond.flags.actor) {
+				AddPageDependency(actors, cond.actor_id, slot);
+			}
+			if (cond.flags.timer) {
+				AddPageDependency(timers, Game_Party::Timer1, slot);
+			}
+			if (cond.flags.timer2) {
+				AddPageDependency(timers, Game_Party::Timer2, slot);
+			}
+		}
+	}
+
+	page_deps.switches = MakePageDependencies(switches);
+	page_deps.variables = MakePageDependencies(variables);
+	page_deps.items = MakePageDependencies(items);
+	page_deps.actors = MakePageDependencies(actors);
+	page_deps.timers = MakePageDependencies(timers);
+	page_deps.dirty_slots.clear();
+	page_deps.refresh_all = true;
+}
+
+/**
+ * Stores the current value of every dependency and collects the events
+ * of the values which changed.
+ *
+ * @param deps dependencies to check
+ * @param get function returning the current value of an id
+ * @param mark whether to mark the events of changed values dirty
+ */
+template <typename F>
+static void UpdatePageDependencies(std::vector<PageDependency>& deps, F&& get, bool mark) {
+	for (auto& dep: deps) {
+		int value = get(dep.id);
+		if (value == dep.value) {
+			continue;
+		}
+		dep.value = value;
+		if (mark) {
+			page_deps.dirty_slots.insert(page_deps.dirty_slots.end(), dep.slots.begin(), dep.slots.end());
+		}
+	}
+}
+
 void Game_Map::Refresh() {
 	if (GetMapId() > 0) {
-		for (Game_Event& ev : events) {
-			ev.RefreshPage();
+		const bool mark = !page_deps.refresh_all;
+
+		UpdatePageDependencies(page_deps.switches, [](int id) {
+			return Main_Data::game_switches->GetInt(id);
+		}, mark);
+		UpdatePageDependencies(page_deps.variables, [](int id) {
+			return Main_Data::game_variables->Get(id);
+		}, mark);
+		UpdatePageDependencies(page_deps.items, [](int id) {
+			return Main_Data::game_party->GetItemCount(id) + Main_Data::game_party->GetEquippedItemCount(id);
+		}, mark);
+		UpdatePageDependencies(page_deps.actors, [](int id) {
+			return Main_Data::game_party->IsActorInParty(id) ? 1 : 0;
+		}, mark);
+		UpdatePageDependencies(page_deps.timers, [](int id) {
+			return Main_Data::game_party->GetTimerSeconds(id);
+		}, mark);
+
+		if (page_deps.refresh_all) {
+			for (Game_Event& ev : events) {
+				ev.RefreshPage();
+			}
+			page_deps.refresh_all = false;
+		} else {
+			// Keep the event order of a full refresh
+			auto& dirty = page_deps.dirty_slots;
+			std::sort(dirty.begin(), dirty.end());
+			dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+			for (int slot: dirty) {
+				events[slot].RefreshPage();
+			}
 		}
+		page_deps.dirty_slots.clear();
 	}
 
 	need_refresh = false;
@@ -610,8 +807,8 @@ bool Game_Map::MakeWay(const Game_Character& self,
 
 	if (vehicle_type != Game_Vehicle::Airship) {
 		// Check for collision with events on the target tile.
-		for (auto& other: GetEvents()) {
-			if (MakeWayCollideEvent(to_x, to_y, self, other, self_conflict)) {
+		for (auto* other = GetNextEventXY(to_x, to_y, nullptr); other; other = GetNextEventXY(to_x, to_y, other)) {
+			if (MakeWayCollideEvent(to_x, to_y, self, *other, self_conflict)) {
 				return false;
 			}
 		}
@@ -657,10 +854,8 @@ bool Game_Map::CanLandAirship(int x, int y) {
 		return false;
 	}
 
-	for (auto& ev: events) {
-		if (ev.IsInPosition(x, y)
-				&& ev.IsActive()
-				&& ev.GetActivePage() != nullptr) {
+	for (auto* ev = GetNextEventXY(x, y, nullptr); ev; ev = GetNextEventXY(x, y, ev)) {
+		if (ev->IsActive() && ev->GetActivePage() != nullptr) {
 			return false;
 		}
 	}
@@ -695,11 +890,10 @@ bool Game_Map::CanDisembarkShip(Game_Player& player, int x, int y) {
 		return false;
 	}
 
-	for (auto& ev: GetEvents()) {
-		if (ev.IsInPosition(x, y)
-			&& ev.GetLayer() == lcf::rpg::EventPage::Layers_same
-			&& ev.IsActive()
-			&& ev.GetActivePage() != nullptr) {
+	for (auto* ev = GetNextEventXY(x, y, nullptr); ev; ev = GetNextEventXY(x, y, ev)) {
+		if (ev->GetLayer() == lcf::rpg::EventPage::Layers_same
+			&& ev->IsActive()
+			&& ev->GetActivePage() != nullptr) {
 			return false;
 		}
 	}
@@ -762,15 +956,15 @@ bool Game_Map::IsPassableTile(const Game_Character* self, int bit, int x, int y)
 
 	// Highest ID event with layer=below, not through, and a tile graphic wins.
 	int event_tile_id = 0;
-	for (auto& ev: events) {
-		if (self == &ev) {
+	for (auto* ev = GetNextEventXY(x, y, nullptr); ev; ev = GetNextEventXY(x, y, ev)) {
+		if (self == ev) {
 			continue;
 		}
-		if (!ev.IsActive() || ev.GetActivePage() == nullptr || ev.GetThrough()) {
+		if (!ev->IsActive() || ev->GetActivePage() == nullptr || ev->GetThrough()) {
 			continue;
 		}
-		if (ev.IsInPosition(x, y) && ev.GetLayer() == lcf::rpg::EventPage::Layers_below) {
-			int tile_id = ev.GetTileId();
+		if (ev->GetLayer() == lcf::rpg::EventPage::Layers_below) {
+			int tile_id = ev->GetTileId();
 			if (tile_id > 0) {
 				event_tile_id = tile_id;
 			}
@@ -872,24 +1066,55 @@ int Game_Map::GetTerrainTag(int x, int y) {
 }
 
 void Game_Map::GetEventsXY(std::vector<Game_Event*>& events, int x, int y) {
-	for (Game_Event& ev : GetEvents()) {
-		if (ev.IsInPosition(x, y) && ev.IsActive()) {
-			events.push_back(&ev);
+	for (auto* ev = GetNextEventXY(x, y, nullptr); ev; ev = GetNextEventXY(x, y, ev)) {
+		if (ev->IsActive()) {
+			events.push_back(ev);
 		}
 	}
 }
 
 Game_Event* Game_Map::GetEventAt(int x, int y, bool require_active) {
-	auto& events = GetEvents();
-	for (auto iter = events.rbegin(); iter != events.rend(); ++iter) {
-		auto& ev = *iter;
-		if (ev.IsInPosition(x, y) && (!require_active || ev.IsActive())) {
-			return &ev;
+	Game_Event* result = nullptr;
+	for (auto* ev = GetNextEventXY(x, y, nullptr); ev; ev = GetNextEventXY(x, y, ev)) {
+		if (!require_active || ev->IsActive()) {
+			result = ev;
+		}
+	}
+	return result;
+}
+
+Game_Event* Game_Map::GetNextEventXY(int x, int y, const Game_Event* ev) {
+	int slot = ev ? static_cast<int>(ev - events.data()) : -1;
+
+	if (event_index.GetSlotCount() == static_cast<int>(events.size()) && event_index.IsInGrid(x, y)) {
+		slot = event_index.GetNext(x, y, slot);
+		return slot >= 0 ? &events[slot] : nullptr;
+	}
+
+	// Positions outside of the map are not indexed
+	for (++slot; slot < static_cast<int>(events.size()); ++slot) {
+		if (events[slot].IsInPosition(x, y)) {
+			return &events[slot];
 		}
 	}
 	return nullptr;
 }
 
+void Game_Map::UpdateEventPosition(const Game_Character& ch) {
+	if (events.empty()) {
+		return;
+	}
+
+	// Only events stored in the event list are indexed
+	const auto* ev = static_cast<const Game_Event*>(&ch);
+	if (std::less<const Game_Event*>()(ev, events.data())
+			|| !std::less<const Game_Event*>()(ev, events.data() + events.size())) {
+		return;
+	}
+
+	event_index.Update(static_cast<int>(ev - events.data()), ev->GetX(), ev->GetY());
+}
+
 bool Game_Map::LoopHorizontal() {
 	return map->scroll_type == lcf::rpg::Map::ScrollType_horizontal || map->scroll_type == lcf::rpg::Map::ScrollType_both;
 }
@@ -515,6 +515,26 @@ namespace Game_Map {
 
 	void GetEventsXY(std::vector<Game_Event*>& events, int x, int y);
 
+	/**
+	 * Iterates the events at a position in ID order.
+	 * Uses the event spatial index, so the cost depends only on the amount
+	 * of events on the tile. Events may move while iterating.
+	 *
+	 * @param x x position on the map
+	 * @param y y position on the map
+	 * @param ev event to continue after, nullptr to start with the first event
+	 * @return the next event at (x,y) or nullptr when none is left
+	 */
+	Game_Event* GetNextEventXY(int x, int y, const Game_Event* ev);
+
+	/**
+	 * Updates the event spatial index after the position of an event changed.
+	 * Characters which are not part of the event list are ignored.
+	 *
+	 * @param ch event that moved
+	 */
+	void UpdateEventPosition(const Game_Character& ch);
+
 	/**
 	 * @param x x position on the map
 	 * @param y y position on the map
@@ -15,6 +15,7 @@
  * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <cmath>
 #include "bitmap.h"
 #include "options.h"
@@ -61,9 +62,7 @@ void SyncCurrentToFinish(lcf::rpg::SavePicture& data) {
 Game_Pictures::Picture::Picture(lcf::rpg::SavePicture save)
 	: data(std::move(save))
 {
-	// FIXME: Make this more accurate by checking all animating chunks values to see if they all will remain stable.
-	// Write unit tests to ensure it's correct.
-	// Then add it to ErasePicture()
+	// Game_Pictures::Update removes the picture from the active set once it is idle
 	needs_update = !IsEmpty(data);
 }
 
@@ -76,8 +75,11 @@ void Game_Pictures::InitGraphics() {
 void Game_Pictures::SetSaveData(std::vector<lcf::rpg::SavePicture> save)
 {
 	pictures.clear();
+	active_pictures.clear();
 
 	frame_counter = save.empty() ? 0 : save.back().frames;
+	map_frames = 0;
+	battle_frames = 0;
 
 	// Don't create pictures for empty save picture data at the end of the vector.
 	int num_pictures = static_cast<int>(save.size());
@@ -91,6 +93,9 @@ void Game_Pictures::SetSaveData(std::vector<lcf::rpg::SavePicture> save)
 	pictures.reserve(num_pictures);
 	for (int i = 0; i < num_pictures; ++i) {
 		pictures.emplace_back(std::move(save[i]));
+		if (pictures.back().needs_update) {
+			active_pictures.push_back(pictures.back().data.ID);
+		}
 	}
 }
 
@@ -102,6 +107,9 @@ std::vector<lcf::rpg::SavePicture> Game_Pictures::GetSaveData() const {
 
 	for (auto& pic: pictures) {
 		save.push_back(pic.data);
+		if (!pic.needs_update) {
+			save.back().frames += GetIdleFrames(pic);
+		}
 	}
 
 	// RPG_RT Save game data always has a constant number of pictures
@@ -144,6 +152,9 @@ Game_Pictures::Picture& Game_Pictures::GetPicture(int id) {
 		pictures.reserve(id);
 		while (static_cast<int>(pictures.size()) < id) {
 			pictures.emplace_back(pictures.size() + 1);
+			// Idle from now on
+			pictures.back().idle_map_frames = map_frames;
+			pictures.back().idle_battle_frames = battle_frames;
 		}
 	}
 	return pictures[id - 1];
@@ -171,8 +182,6 @@ void Game_Pictures::OnBattleEnd() {
 }
 
 bool Game_Pictures::Picture::Show(const ShowParams& params) {
-	needs_update = true;
-
 	data.name = params.name;
 	data.use_transparent_color = params.use_transparent_color;
 	data.fixed_to_map = params.fixed_to_map;
@@ -246,6 +255,7 @@ bool Game_Pictures::Picture::Show(const ShowParams& params) {
 
 bool Game_Pictures::Show(int id, const ShowParams& params) {
 	auto& pic = GetPicture(id);
+	Activate(pic);
 	if (pic.Show(params)) {
 		if (pic.sprite && !pic.data.name.empty()) {
 			// When the name is empty the current image buffer is reused by ShowPicture command (Used by Yume2kki)
@@ -315,6 +325,7 @@ void Game_Pictures::Picture::Move(const MoveParams& params) {
 
 void Game_Pictures::Move(int id, const MoveParams& params) {
 	auto& pic = GetPicture(id);
+	Activate(pic);
 	pic.Move(params);
 }
 
@@ -512,10 +523,6 @@ void Game_Pictures::Picture::Update(bool is_battle) {
 		++data.frames;
 	}
 
-	if (!needs_update) {
-		return;
-	}
-
 	if (data.time_left > 0) {
 		--data.time_left;
 	}
@@ -590,11 +597,85 @@ void Game_Pictures::Picture::Update(bool is_battle) {
 	}
 }
 
+bool Game_Pictures::Picture::IsIdle() const {
+	if (data.time_left > 0
+			|| data.current_x != data.finish_x
+			|| data.current_y != data.finish_y
+			|| data.current_red != data.finish_red
+			|| data.current_green != data.finish_green
+			|| data.current_blue != data.finish_blue
+			|| data.current_sat != data.finish_sat
+			|| data.current_magnify != data.finish_magnify
+			|| data.current_top_trans != data.finish_top_trans
+			|| data.current_bot_trans != data.finish_bot_trans) {
+		return false;
+	}
+
+	if (Player::IsRPG2k3E() && data.spritesheet_speed > 0) {
+		return false;
+	}
+
+	switch (data.effect_mode) {
+		case lcf::rpg::SavePicture::Effect_none:
+			// Rotation continues until one revolution is done, see Update
+			return !(data.current_effect_power > 0 && data.current_rotation > 0.0);
+		case lcf::rpg::SavePicture::Effect_maniac_fixed_angle:
+			return data.current_effect_power == data.finish_effect_power
+				&& data.current_rotation == data.current_effect_power;
+		default:
+			return false;
+	}
+}
+
+void Game_Pictures::Activate(Picture& pic) {
+	if (pic.needs_update) {
+		return;
+	}
+
+	pic.data.frames += GetIdleFrames(pic);
+	pic.needs_update = true;
+	active_pictures.push_back(pic.data.ID);
+}
+
+int Game_Pictures::GetIdleFrames(const Picture& pic) const {
+	if (!Player::IsRPG2k3E()) {
+		return 0;
+	}
+
+	int frames = 0;
+	if (pic.IsOnMap()) {
+		frames += map_frames - pic.idle_map_frames;
+	}
+	if (pic.IsOnBattle()) {
+		frames += battle_frames - pic.idle_battle_frames;
+	}
+	return frames;
+}
+
 void Game_Pictures::Update(bool is_battle) {
 	++frame_counter;
-	for (auto& pic: pictures) {
-		pic.Update(is_battle);
+	if (is_battle) {
+		++battle_frames;
+	} else {
+		++map_frames;
 	}
+
+	// Pictures that stopped moving and animating leave the active set.
+	// Thousands of pictures are common in Maniac Patch games, mostly idle.
+	auto end = std::remove_if(active_pictures.begin(), active_pictures.end(), [&](int id) {
+		auto& pic = pictures[id - 1];
+		pic.Update(is_battle);
+
+		if (!pic.IsIdle()) {
+			return false;
+		}
+
+		pic.needs_update = false;
+		pic.idle_map_frames = map_frames;
+		pic.idle_battle_frames = battle_frames;
+		return true;
+	});
+	active_pictures.erase(end, active_pictures.end());
 }
 
 Game_Pictures::ShowParams Game_Pictures::Picture::GetShowParams() const {
@@ -99,11 +99,18 @@ public:
 		std::unique_ptr<Sprite_Picture> sprite;
 		lcf::rpg::SavePicture data;
 		FileRequestBinding request_id;
+		/** Whether the picture is in the active set and updated every frame */
 		bool needs_update = false;
 		int origin = 0;
+		/** Map and battle frame counters when the picture became idle, used to catch up data.frames */
+		int idle_map_frames = 0;
+		int idle_battle_frames = 0;
 
 		void Update(bool is_battle);
 
+		/** @return whether Update would only increment data.frames */
+		bool IsIdle() const;
+
 		bool IsOnMap() const;
 		bool IsOnBattle() const;
 		int NumSpriteSheetFrames() const;
@@ -136,8 +143,17 @@ private:
 	void RequestPictureSprite(Picture& pic);
 	void OnPictureSpriteReady(FileRequestResult*, int id);
 
+	/** Adds a picture to the active set, must be called before the picture is modified */
+	void Activate(Picture& pic);
+	/** @return frames an idle picture missed, they are added to data.frames when it is activated or saved */
+	int GetIdleFrames(const Picture& pic) const;
+
 	std::vector<Picture> pictures;
+	/** IDs of the pictures that are updated every frame, idle pictures are skipped */
+	std::vector<int> active_pictures;
 	int frame_counter = 0;
+	int map_frames = 0;
+	int battle_frames = 0;
 };
 
 inline bool Game_Pictures::Picture::IsOnMap() const {
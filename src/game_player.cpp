@@ -434,16 +434,16 @@ bool Game_Player::CheckEventTriggerHere(TriggerSet triggers, bool triggered_by_d
 
 	bool result = false;
 
-	for (auto& ev: Game_Map::GetEvents()) {
-		const auto trigger = ev.GetTrigger();
-		if (ev.IsActive()
-				&& ev.GetX() == GetX()
-				&& ev.GetY() == GetY()
-				&& ev.GetLayer() != lcf::rpg::EventPage::Layers_same
+	const int x = GetX();
+	const int y = GetY();
+	for (auto* ev = Game_Map::GetNextEventXY(x, y, nullptr); ev; ev = Game_Map::GetNextEventXY(x, y, ev)) {
+		const auto trigger = ev->GetTrigger();
+		if (ev->IsActive()
+				&& ev->GetLayer() != lcf::rpg::EventPage::Layers_same
 				&& trigger >= 0
 				&& triggers[trigger]) {
 			SetEncounterCalling(false);
-			result |= ev.ScheduleForegroundExecution(triggered_by_decision_key, true);
+			result |= ev->ScheduleForegroundExecution(triggered_by_decision_key, true);
 		}
 	}
 	return result;
@@ -455,16 +455,14 @@ bool Game_Player::CheckEventTriggerThere(TriggerSet triggers, int x, int y, bool
 	}
 	bool result = false;
 
-	for (auto& ev : Game_Map::GetEvents()) {
-		const auto trigger = ev.GetTrigger();
-		if (ev.IsActive()
-				&& ev.GetX() == x
-				&& ev.GetY() == y
-				&& ev.GetLayer() == lcf::rpg::EventPage::Layers_same
+	for (auto* ev = Game_Map::GetNextEventXY(x, y, nullptr); ev; ev = Game_Map::GetNextEventXY(x, y, ev)) {
+		const auto trigger = ev->GetTrigger();
+		if (ev->IsActive()
+				&& ev->GetLayer() == lcf::rpg::EventPage::Layers_same
 				&& trigger >= 0
 				&& triggers[trigger]) {
 			SetEncounterCalling(false);
-			result |= ev.ScheduleForegroundExecution(triggered_by_decision_key, true);
+			result |= ev->ScheduleForegroundExecution(triggered_by_decision_key, true);
 		}
 	}
 	return result;
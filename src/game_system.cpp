@@ -199,6 +199,23 @@ void Game_System::SePlay(const lcf::rpg::Animation &animation) {
 	}
 }
 
+void Game_System::PreloadSystemSe() {
+	se_preload_request_ids.clear();
+
+	for (int i = 0; i < SFX_Count; ++i) {
+		const auto& se = GetSystemSE(i);
+		if (se.name.empty() || se.name == "(OFF)" || se.volume == 0 || StringView(se.name).ends_with(".script")) {
+			continue;
+		}
+
+		int32_t tempo = Utils::Clamp<int32_t>(se.tempo, 10, 400);
+
+		FileRequestAsync* request = AsyncHandler::RequestFile("Sound", se.name);
+		se_preload_request_ids.push_back(request->Bind(&Game_System::OnSePreloadReady, this, tempo));
+		request->Start();
+	}
+}
+
 StringView Game_System::GetSystemName() {
 	return !data.graphics_name.empty() ?
 		StringView(data.graphics_name) : StringView(lcf::Data::system.system_name);
@@ -591,6 +608,21 @@ void Game_System::OnSeReady(FileRequestResult* result, lcf::rpg::Sound se, bool
 	Audio().SE_Play(std::move(se_cache), se.volume, se.tempo);
 }
 
+void Game_System::OnSePreloadReady(FileRequestResult* result, int tempo) {
+	auto se_cache = AudioSeCache::GetCachedSe(result->file);
+	if (!se_cache) {
+		Filesystem_Stream::InputStream stream;
+		if (IsStopSoundFilename(result->file, stream) || !stream) {
+			return;
+		}
+		se_cache = AudioSeCache::Create(std::move(stream), result->file);
+	}
+
+	if (se_cache) {
+		Audio().SE_Preload(std::move(se_cache), tempo);
+	}
+}
+
 bool Game_System::IsMessageTransparent() {
 	if (Feature::HasRpg2kBattleSystem() && Game_Battle::IsBattleRunning()) {
 		return false;
@@ -21,6 +21,7 @@
 // Headers
 #include <string>
 #include <map>
+#include <vector>
 #include <lcf/rpg/animation.h>
 #include <lcf/rpg/music.h>
 #include <lcf/rpg/sound.h>
@@ -135,6 +136,12 @@ public:
 	 */
 	void SePlay(const lcf::rpg::Animation& animation);
 
+	/**
+	 * Loads the system sound effects and converts them to the audio output
+	 * format so the first playback does not decode them.
+	 */
+	void PreloadSystemSe();
+
 	/** @return system graphic filename.  */
 	StringView GetSystemName();
 
@@ -440,6 +447,7 @@ private:
 	void OnBgmReady(FileRequestResult* result);
 	void OnBgmInelukiReady(FileRequestResult* result);
 	void OnSeReady(FileRequestResult* result, lcf::rpg::Sound se, bool stop_sounds);
+	void OnSePreloadReady(FileRequestResult* result, int tempo);
 	void OnChangeSystemGraphicReady(FileRequestResult* result);
 private:
 	lcf::rpg::SaveSystem data;
@@ -447,6 +455,7 @@ private:
 	FileRequestBinding music_request_id;
 	FileRequestBinding system_request_id;
 	std::map<std::string, FileRequestBinding> se_request_ids;
+	std::vector<FileRequestBinding> se_preload_request_ids;
 	Color bg_color = Color{ 0, 0, 0, 255 };
 	bool bgm_pending = false;
 	int loaded_frame_count = 0;
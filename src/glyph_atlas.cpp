@@ -0,0 +1,178 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include <algorithm>
+#include "glyph_atlas.h"
+#include "bitmap.h"
+
+namespace {
+	// Glyphs of similar height share a shelf
+	constexpr int shelf_granularity = 4;
+
+	int ShelfHeight(int height) {
+		return (height + shelf_granularity - 1) / shelf_granularity * shelf_granularity;
+	}
+}
+
+GlyphAtlas::Key GlyphAtlas::MakeKey(char32_t glyph, bool shaped, int size) {
+	return (static_cast<Key>(static_cast<uint16_t>(size)) << 33) | (static_cast<Key>(shaped) << 32) | glyph;
+}
+
+GlyphAtlas::GlyphAtlas(int width, int height) : width(width), height(height) {
+}
+
+bool GlyphAtlas::Find(Key key, Font::GlyphRet& ret) {
+	auto it = glyphs.find(key);
+	if (it == glyphs.end()) {
+		++stats.misses;
+		return false;
+	}
+
+	++stats.hits;
+
+	const auto& entry = it->second;
+	if (entry.shelf >= 0) {
+		shelves[entry.shelf].last_use = ++tick;
+	}
+
+	ret = { bitmap, entry.advance, entry.offset, entry.has_color, entry.rect };
+	return true;
+}
+
+bool GlyphAtlas::Insert(Key key, Font::GlyphRet& ret) {
+	auto it = glyphs.find(key);
+	if (it != glyphs.end()) {
+		const auto& entry = it->second;
+		ret = { bitmap, entry.advance, entry.offset, entry.has_color, entry.rect };
+		return true;
+	}
+
+	const Rect src_rect = ret.bitmap->GetRect();
+
+	if (src_rect.width > width || src_rect.height > height) {
+		return false;
+	}
+
+	if (!bitmap) {
+		bitmap = Bitmap::Create(width, height, true);
+	}
+
+	Entry entry;
+	entry.advance = ret.advance;
+	entry.offset = ret.offset;
+	entry.has_color = ret.has_color;
+
+	if (src_rect.IsEmpty()) {
+		// Nothing to draw (e.g. a space), only the metrics are cached
+		entry.shelf = -1;
+	} else {
+		entry.shelf = AllocateShelf(src_rect.width, src_rect.height);
+
+		auto& shelf = shelves[entry.shelf];
+		entry.rect = { shelf.x, shelf.y, src_rect.width, src_rect.height };
+		shelf.x += src_rect.width;
+		shelf.last_use = ++tick;
+		shelf.keys.push_back(key);
+
+		bitmap->ClearRect(entry.rect);
+		bitmap->BlitFast(entry.rect.x, entry.rect.y, *ret.bitmap, src_rect, Opacity::Opaque());
+	}
+
+	glyphs[key] = entry;
+
+	ret.bitmap = bitmap;
+	ret.rect = entry.rect;
+	return true;
+}
+
+int GlyphAtlas::AllocateShelf(int glyph_width, int glyph_height) {
+	const int shelf_height = std::min(ShelfHeight(glyph_height), height);
+
+	for (int i = 0; i < static_cast<int>(shelves.size()); ++i) {
+		const auto& shelf = shelves[i];
+		if (shelf.height == shelf_height && width - shelf.x >= glyph_width) {
+			return i;
+		}
+	}
+
+	const int free_y = shelves.empty() ? 0 : shelves.back().y + shelves.back().height;
+	if (height - free_y >= shelf_height) {
+		Shelf shelf;
+		shelf.y = free_y;
+		shelf.height = shelf_height;
+		shelves.push_back(shelf);
+		return static_cast<int>(shelves.size()) - 1;
+	}
+
+	// Atlas is full: Reuse the least recently used shelf that is high enough
+	int lru = -1;
+	for (int i = 0; i < static_cast<int>(shelves.size()); ++i) {
+		const auto& shelf = shelves[i];
+		if (shelf.height >= glyph_height && (lru < 0 || shelf.last_use < shelves[lru].last_use)) {
+			lru = i;
+		}
+	}
+
+	if (lru < 0) {
+		// Only lower shelves exist, start from scratch
+		glyphs.clear();
+		shelves.clear();
+		++stats.evictions;
+		return AllocateShelf(glyph_width, glyph_height);
+	}
+
+	auto& shelf = shelves[lru];
+	for (Key key : shelf.keys) {
+		glyphs.erase(key);
+	}
+	shelf.keys.clear();
+	shelf.x = 0;
+	++stats.evictions;
+
+	return lru;
+}
+
+bool GlyphAtlas::FindSize(Key key, Rect& size) const {
+	auto it = sizes.find(key);
+	if (it == sizes.end()) {
+		return false;
+	}
+
+	size = it->second;
+	return true;
+}
+
+void GlyphAtlas::InsertSize(Key key, const Rect& size) {
+	if (sizes.size() >= max_sizes) {
+		sizes.clear();
+	}
+
+	sizes[key] = size;
+}
+
+void GlyphAtlas::Clear() {
+	glyphs.clear();
+	shelves.clear();
+	sizes.clear();
+}
+
+GlyphAtlas::Stats GlyphAtlas::GetStats() const {
+	Stats ret = stats;
+	ret.entries = static_cast<int>(glyphs.size());
+	return ret;
+}
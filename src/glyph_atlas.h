@@ -0,0 +1,148 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_GLYPH_ATLAS_H
+#define EP_GLYPH_ATLAS_H
+
+// Headers
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "font.h"
+#include "memory_management.h"
+#include "point.h"
+#include "rect.h"
+
+/**
+ * Cache of rendered glyphs of a font.
+ *
+ * The glyphs are copied into a single atlas bitmap which is divided into
+ * shelves (rows of glyphs with similar height). When the atlas is full the
+ * least recently used shelf is evicted and reused.
+ * Glyph advances are cached separately because Text::GetSize measures far
+ * more glyphs than are drawn.
+ */
+class GlyphAtlas {
+public:
+	/** Identifies a glyph: Codepoint or glyph index, shaping state and font size */
+	using Key = uint64_t;
+
+	/** Counters of the atlas */
+	struct Stats {
+		/** Find calls that returned a glyph */
+		int hits = 0;
+		/** Find calls that found no glyph */
+		int misses = 0;
+		/** shelves that were cleared to make room */
+		int evictions = 0;
+		/** glyphs currently held */
+		int entries = 0;
+	};
+
+	/**
+	 * Creates a key for a glyph.
+	 *
+	 * @param glyph codepoint or glyph index
+	 * @param shaped whether glyph is a glyph index returned by shaping
+	 * @param size font size the glyph is rendered at
+	 * @return key
+	 */
+	static Key MakeKey(char32_t glyph, bool shaped, int size);
+
+	/**
+	 * @param width width of the atlas bitmap
+	 * @param height height of the atlas bitmap
+	 */
+	GlyphAtlas(int width, int height);
+
+	/**
+	 * Looks up a rendered glyph.
+	 *
+	 * @param key glyph key
+	 * @param ret receives the glyph. bitmap is the atlas, rect the area of the glyph
+	 * @return whether the glyph was found
+	 */
+	bool Find(Key key, Font::GlyphRet& ret);
+
+	/**
+	 * Copies a rendered glyph into the atlas.
+	 * Evicts the least recently used shelf when there is no space left.
+	 *
+	 * @param key glyph key
+	 * @param ret rendered glyph. On success bitmap and rect are changed to refer to the atlas.
+	 * @return whether the glyph was added, false when it is larger than the atlas
+	 */
+	bool Insert(Key key, Font::GlyphRet& ret);
+
+	/**
+	 * Looks up a cached glyph size.
+	 *
+	 * @param key glyph key
+	 * @param size receives the size
+	 * @return whether the size was found
+	 */
+	bool FindSize(Key key, Rect& size) const;
+
+	/**
+	 * Caches a glyph size.
+	 *
+	 * @param key glyph key
+	 * @param size size returned by Font::vGetSize
+	 */
+	void InsertSize(Key key, const Rect& size);
+
+	/** Removes all glyphs and sizes */
+	void Clear();
+
+	/** @return counters of the atlas */
+	Stats GetStats() const;
+
+	/** Maximum amount of cached glyph sizes, the size cache is cleared when exceeded */
+	static constexpr size_t max_sizes = 4096;
+
+private:
+	struct Shelf {
+		int y = 0;
+		int height = 0;
+		/** Next free x position */
+		int x = 0;
+		uint32_t last_use = 0;
+		std::vector<Key> keys;
+	};
+
+	struct Entry {
+		Rect rect;
+		Point advance;
+		Point offset;
+		bool has_color = false;
+		int shelf = 0;
+	};
+
+	int AllocateShelf(int width, int height);
+
+	int width = 0;
+	int height = 0;
+	/** Bitmap is created on first use to pick up the current pixel format */
+	BitmapRef bitmap;
+	std::vector<Shelf> shelves;
+	std::unordered_map<Key, Entry> glyphs;
+	std::unordered_map<Key, Rect> sizes;
+	uint32_t tick = 0;
+	Stats stats;
+};
+
+#endif
@@ -30,6 +30,8 @@
 #include "drawable_mgr.h"
 #include "baseui.h"
 #include "game_clock.h"
+#include "game_system.h"
+#include "main_data.h"
 
 using namespace std::chrono_literals;
 
@@ -42,6 +44,17 @@ namespace Graphics {
 	std::unique_ptr<FpsOverlay> fps_overlay;
 
 	std::string window_title_key;
+
+	Rect RetainedDraw(Bitmap& dst);
+
+	/** State of the last frame drawn by the retained renderer */
+	struct {
+		bool valid = false;
+		const Bitmap* dst = nullptr;
+		Rect dst_rect;
+		const Scene* scene = nullptr;
+		Color background_color;
+	} retained;
 }
 
 void Graphics::Init() {
@@ -104,7 +117,7 @@ void Graphics::UpdateTitle() {
 #endif
 }
 
-void Graphics::Draw(Bitmap& dst) {
+Rect Graphics::Draw(Bitmap& dst) {
 	auto& transition = Transition::instance();
 
 	auto min_z = std::numeric_limits<Drawable::Z_t>::min();
@@ -114,8 +127,49 @@ void Graphics::Draw(Bitmap& dst) {
 	} else if (transition.IsErasedNotActive()) {
 		min_z = transition.GetZ() + 1;
 		dst.Clear();
+	} else if (DisplayUi->IsRetainedRender()) {
+		return RetainedDraw(dst);
 	}
+
+	retained.valid = false;
 	LocalDraw(dst, min_z, max_z);
+	return dst.GetRect();
+}
+
+Rect Graphics::RetainedDraw(Bitmap& dst) {
+	auto& drawable_list = DrawableMgr::GetLocalList();
+
+	// Must be called every frame, the drawables compare against the last frame
+	Rect damage;
+	bool tracked = drawable_list.CollectDamage(damage);
+
+	Color background_color;
+	if (Main_Data::game_system) {
+		background_color = Main_Data::game_system->GetBackgroundColor();
+	}
+
+	if (!tracked || !retained.valid || retained.dst != &dst || retained.dst_rect != dst.GetRect() ||
+			retained.scene != current_scene.get() || retained.background_color != background_color) {
+		damage = dst.GetRect();
+	}
+
+	retained.valid = true;
+	retained.dst = &dst;
+	retained.dst_rect = dst.GetRect();
+	retained.scene = current_scene.get();
+	retained.background_color = background_color;
+
+	damage.Adjust(dst.GetRect());
+	if (damage.IsEmpty()) {
+		// Nothing changed, dst still contains the last frame
+		return damage;
+	}
+
+	dst.SetClipRect(damage);
+	LocalDraw(dst, std::numeric_limits<Drawable::Z_t>::min(), std::numeric_limits<Drawable::Z_t>::max());
+	dst.ClearClipRect();
+
+	return damage;
 }
 
 void Graphics::LocalDraw(Bitmap& dst, Drawable::Z_t min_z, Drawable::Z_t max_z) {
@@ -48,7 +48,15 @@ namespace Graphics {
 	 */
 	void Update();
 
-	void Draw(Bitmap& dst);
+	/**
+	 * Draws the current scene.
+	 * In retained mode only the parts of dst that changed since the last frame
+	 * are redrawn, the other parts must still contain the last frame.
+	 *
+	 * @param dst bitmap to draw on
+	 * @return the part of dst that was redrawn, empty when nothing changed
+	 */
+	Rect Draw(Bitmap& dst);
 
 	void LocalDraw(Bitmap& dst, Drawable::Z_t min_z, Drawable::Z_t max_z);
 
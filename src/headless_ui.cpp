@@ -0,0 +1,56 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "headless_ui.h"
+#include "bitmap.h"
+#include "color.h"
+#include "pixel_format.h"
+
+HeadlessUi::HeadlessUi(long width, long height, const Game_Config& cfg) : BaseUi(cfg)
+{
+	current_display_mode.width = width;
+	current_display_mode.height = height;
+	current_display_mode.bpp = 32;
+
+	const auto format = format_B8G8R8A8_n().format();
+	Bitmap::SetFormat(Bitmap::ChooseFormat(format));
+	main_surface = Bitmap::Create(width, height, Color(0, 0, 0, 255));
+
+	// Never wait for the next frame
+	frame_limit = Game_Clock::duration(0);
+
+	audio_ = std::make_unique<EmptyAudio>(cfg.audio);
+}
+
+void HeadlessUi::ProcessEvents() {
+}
+
+void HeadlessUi::UpdateDisplay() {
+	// Nothing is presented, only consume the damage of this frame
+	TakeDisplayDamage();
+}
+
+void HeadlessUi::vGetConfig(Game_ConfigVideo& cfg) const {
+	cfg.renderer.Lock("Headless (Software)");
+}
+
+#ifdef SUPPORT_AUDIO
+AudioInterface& HeadlessUi::GetAudio() {
+	return *audio_;
+}
+#endif
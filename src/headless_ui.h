@@ -0,0 +1,60 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_HEADLESS_UI_H
+#define EP_HEADLESS_UI_H
+
+// Headers
+#include <memory>
+#include "audio.h"
+#include "baseui.h"
+
+/**
+ * HeadlessUi class.
+ * Renders into an offscreen surface without opening a window and never
+ * receives input events. Used by the benchmark mode (--benchmark), input
+ * comes from a replayed input log.
+ */
+class HeadlessUi final : public BaseUi {
+public:
+	/**
+	 * Constructor.
+	 *
+	 * @param width surface width.
+	 * @param height surface height.
+	 * @param cfg config options
+	 */
+	HeadlessUi(long width, long height, const Game_Config& cfg);
+
+	/**
+	 * Inherited from BaseUi.
+	 */
+	/** @{ */
+	void ProcessEvents() override;
+	void UpdateDisplay() override;
+	void vGetConfig(Game_ConfigVideo& cfg) const override;
+
+#ifdef SUPPORT_AUDIO
+	AudioInterface& GetAudio() override;
+#endif
+	/** @} */
+
+private:
+	std::unique_ptr<AudioInterface> audio_;
+};
+
+#endif
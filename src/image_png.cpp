@@ -31,6 +31,22 @@ static void read_data(png_structp png_ptr, png_bytep data, png_size_t length) {
 	*bufp += length;
 }
 
+namespace {
+	struct SpanReader {
+		const uint8_t* cur;
+		const uint8_t* end;
+	};
+}
+
+static void read_data_span(png_structp png_ptr, png_bytep data, png_size_t length) {
+	auto* reader = reinterpret_cast<SpanReader*>(png_get_io_ptr(png_ptr));
+	if (static_cast<size_t>(reader->end - reader->cur) < length) {
+		png_error(png_ptr, "Unexpected end of file");
+	}
+	memcpy(data, reader->cur, length);
+	reader->cur += length;
+}
+
 static void read_data_istream(png_structp png_ptr, png_bytep data, png_size_t length) {
 	auto* bufp = reinterpret_cast<Filesystem_Stream::InputStream*>(png_get_io_ptr(png_ptr));
 	if (bufp != nullptr && *bufp) {
@@ -60,6 +76,12 @@ bool ImagePNG::ReadPNG(const void* buffer, bool transparent,
 
 bool ImagePNG::ReadPNG(Filesystem_Stream::InputStream& stream, bool transparent,
 	int& width, int& height, void*& pixels) {
+	auto data = stream.GetData();
+	if (!data.empty()) {
+		SpanReader reader = { data.data(), data.data() + data.size() };
+		return ReadPNGWithReadFunction(&reader, read_data_span, transparent, width, height, pixels);
+	}
+
 	return ReadPNGWithReadFunction(&stream, read_data_istream, transparent, width, height, pixels);
 }
 
@@ -73,6 +73,11 @@ bool ImageXYZ::ReadXYZ(const uint8_t* data, unsigned len, bool transparent,
 
 bool ImageXYZ::ReadXYZ(Filesystem_Stream::InputStream& stream, bool transparent,
 					   int& width, int& height, void*& pixels) {
+	auto data = stream.GetData();
+	if (!data.empty()) {
+		return ReadXYZ(data.data(), (unsigned) data.size(), transparent, width, height, pixels);
+	}
+
 	std::vector<uint8_t> buffer = Utils::ReadStream(stream);
 	return ReadXYZ(&buffer.front(), (unsigned) buffer.size(), transparent, width, height, pixels);
 }
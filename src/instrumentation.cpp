@@ -17,11 +17,83 @@
 
 #include "instrumentation.h"
 #include "utils.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <ostream>
 
+#ifdef HAVE_THREADS
+#include <mutex>
+#include <thread>
+#endif
+
+bool Instrumentation::profiler_enabled = false;
 #ifdef PLAYER_INSTRUMENTATION_VTUNE
 __itt_domain* Instrumentation::domain = nullptr;
 #endif
 
+namespace {
+	/** Amount of frames kept in the ring buffer (5 seconds at 60 FPS) */
+	constexpr int max_frames = 300;
+
+	struct ZoneRecord {
+		const char* name;
+		int depth;
+		/** 0 for the main thread, 1 for all other threads */
+		int thread;
+		int64_t begin;
+		int64_t end;
+	};
+
+	struct FrameRecord {
+		int64_t begin = 0;
+		int64_t end = 0;
+		std::vector<ZoneRecord> zones;
+	};
+
+	/** Ring buffer, frames[head] is the frame in progress */
+	std::vector<FrameRecord> frames;
+	int head = 0;
+	int num_completed = 0;
+	/** Nesting level of the open zones of the calling thread */
+	thread_local int zone_depth = 0;
+
+#ifdef HAVE_THREADS
+	std::mutex mutex;
+	std::thread::id main_thread;
+
+	using lock_type = std::lock_guard<std::mutex>;
+
+	bool IsMainThread() {
+		return std::this_thread::get_id() == main_thread;
+	}
+#else
+	struct lock_type {
+		explicit lock_type(int) {}
+	};
+	int mutex = 0;
+
+	bool IsMainThread() {
+		return true;
+	}
+#endif
+
+	int64_t Now() {
+		using namespace std::chrono;
+		return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+	}
+
+	/** Calls f for the completed frames from the oldest to the newest */
+	template <typename F>
+	void ForEachFrame(int num_frames, F&& f) {
+		num_frames = std::min(num_frames, num_completed);
+		for (int i = num_frames; i > 0; --i) {
+			f(frames[(head - i + max_frames) % max_frames]);
+		}
+	}
+}
+
 void Instrumentation::Init(const char* name) {
 #ifdef PLAYER_INSTRUMENTATION_VTUNE
 	assert(!domain);
@@ -34,3 +106,150 @@ void Instrumentation::Init(const char* name) {
 	(void)name;
 #endif
 }
+
+void Instrumentation::SetProfilerEnabled(bool enabled) {
+	lock_type lock(mutex);
+
+	if (enabled && frames.empty()) {
+		frames.resize(max_frames);
+#ifdef HAVE_THREADS
+		main_thread = std::this_thread::get_id();
+#endif
+	}
+	profiler_enabled = enabled;
+}
+
+void Instrumentation::ProfilerFrameBegin() {
+	lock_type lock(mutex);
+
+	frames[head].begin = Now();
+	zone_depth = 0;
+}
+
+void Instrumentation::ProfilerFrameEnd() {
+	lock_type lock(mutex);
+
+	auto& frame = frames[head];
+	frame.end = Now();
+	if (frame.begin == 0) {
+		frame.begin = frame.end;
+	}
+
+	head = (head + 1) % max_frames;
+	num_completed = std::min(num_completed + 1, max_frames - 1);
+
+	// Reuse the zone storage of the oldest frame
+	auto& next = frames[head];
+	next.begin = 0;
+	next.end = 0;
+	next.zones.clear();
+}
+
+int64_t Instrumentation::ProfilerZoneBegin() {
+	++zone_depth;
+	return Now();
+}
+
+void Instrumentation::ProfilerZoneEnd(const char* name, int64_t begin) {
+	int64_t end = Now();
+	int thread = IsMainThread() ? 0 : 1;
+	zone_depth = std::max(zone_depth - 1, 0);
+	int depth = zone_depth;
+
+	lock_type lock(mutex);
+	if (!frames.empty()) {
+		frames[head].zones.push_back({ name, depth, thread, begin, end });
+	}
+}
+
+std::vector<Instrumentation::ZoneSummary> Instrumentation::GetProfilerSummary(int num_frames) {
+	struct Entry {
+		ZoneSummary summary;
+		int thread;
+		int64_t first_begin;
+		int64_t total;
+	};
+	std::vector<Entry> entries;
+	int64_t frame_total = 0;
+	int count = 0;
+
+	{
+		lock_type lock(mutex);
+		ForEachFrame(num_frames, [&](const FrameRecord& frame) {
+			frame_total += frame.end - frame.begin;
+			++count;
+
+			for (const auto& zone: frame.zones) {
+				auto it = std::find_if(entries.begin(), entries.end(), [&](const Entry& e) {
+					return e.thread == zone.thread && e.summary.depth == zone.depth && std::strcmp(e.summary.name, zone.name) == 0;
+				});
+				const int64_t rel_begin = zone.begin - frame.begin;
+				if (it == entries.end()) {
+					entries.push_back({ { zone.name, zone.depth, 0.0 }, zone.thread, rel_begin, 0 });
+					it = entries.end() - 1;
+				}
+				it->first_begin = std::min(it->first_begin, rel_begin);
+				it->total += zone.end - zone.begin;
+			}
+		});
+	}
+
+	std::vector<ZoneSummary> result;
+	if (count == 0) {
+		return result;
+	}
+
+	// Parents start before their children, other threads are listed last
+	std::sort(entries.begin(), entries.end(), [](const Entry& l, const Entry& r) {
+		if (l.thread != r.thread) {
+			return l.thread < r.thread;
+		}
+		if (l.first_begin != r.first_begin) {
+			return l.first_begin < r.first_begin;
+		}
+		return l.summary.depth < r.summary.depth;
+	});
+
+	result.reserve(entries.size() + 1);
+	result.push_back({ "Frame", 0, frame_total / 1e6 / count });
+	for (auto& e: entries) {
+		e.summary.ms = e.total / 1e6 / count;
+		result.push_back(e.summary);
+	}
+
+	return result;
+}
+
+bool Instrumentation::WriteChromeTrace(std::ostream& os) {
+	lock_type lock(mutex);
+
+	int64_t epoch = 0;
+	ForEachFrame(max_frames, [&](const FrameRecord& frame) {
+		if (epoch == 0) {
+			epoch = frame.begin;
+		}
+	});
+
+	auto write_event = [&](const char* name, int thread, int64_t begin, int64_t end, bool& first) {
+		if (!first) {
+			os << ",\n";
+		}
+		first = false;
+		// Chrome expects microseconds
+		os << "{\"name\":\"" << name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread
+			<< ",\"ts\":" << (begin - epoch) / 1000.0 << ",\"dur\":" << (end - begin) / 1000.0 << "}";
+	};
+
+	bool first = true;
+	os << std::fixed << std::setprecision(3);
+	os << "{\"traceEvents\":[\n";
+	ForEachFrame(max_frames, [&](const FrameRecord& frame) {
+		write_event("Frame", 0, frame.begin, frame.end, first);
+		for (const auto& zone: frame.zones) {
+			write_event(zone.name, zone.thread, zone.begin, zone.end, first);
+		}
+	});
+	os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+	return os.good();
+}
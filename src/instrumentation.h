@@ -26,6 +26,9 @@
 #include <ittnotify.h>
 #endif
 #include <cassert>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
 
 class Instrumentation {
 public:
@@ -42,6 +45,68 @@ public:
 	/** Call at the end of a frame */
 	static void FrameEnd();
 
+	/**
+	 * Enables the builtin frame profiler.
+	 * When disabled zones and frames are not recorded.
+	 *
+	 * @param enabled whether to record zones
+	 */
+	static void SetProfilerEnabled(bool enabled);
+
+	/** @return whether the builtin frame profiler is enabled */
+	static bool IsProfilerEnabled();
+
+	/** Average time of a zone over the last frames */
+	struct ZoneSummary {
+		const char* name;
+		/** nesting level of the zone */
+		int depth;
+		/** average milliseconds per frame */
+		double ms;
+	};
+
+	/**
+	 * Summarizes the recorded zones.
+	 * The first entry is the whole frame, followed by the zones of the main
+	 * thread. The zones of all other threads are listed last.
+	 *
+	 * @param num_frames amount of completed frames to average
+	 * @return time per zone, in order of first appearance
+	 */
+	static std::vector<ZoneSummary> GetProfilerSummary(int num_frames);
+
+	/**
+	 * Writes all frames in the profiler ring buffer as a Chrome trace event
+	 * JSON document (viewable in chrome://tracing or Perfetto).
+	 *
+	 * @param os stream to write to
+	 * @return true on success
+	 */
+	static bool WriteChromeTrace(std::ostream& os);
+
+	/**
+	 * RAII wrapper that records a named zone of the frame profiler.
+	 * Zones can be nested and can be used from any thread.
+	 */
+	class Zone {
+	public:
+		/**
+		 * Begins a zone.
+		 *
+		 * @param name name of the zone, must be a string literal
+		 */
+		explicit Zone(const char* name);
+
+		Zone(const Zone&) = delete;
+		Zone& operator=(const Zone&) = delete;
+
+		/** Ends the zone */
+		~Zone();
+	private:
+		const char* name = nullptr;
+		int64_t begin = 0;
+	};
+
 	/** RAII wrapper around FrameBegin() / FrameEnd() */
 	class FrameScope {
 	public:
@@ -74,6 +139,12 @@ public:
 	};
 
 private:
+	static void ProfilerFrameBegin();
+	static void ProfilerFrameEnd();
+	static int64_t ProfilerZoneBegin();
+	static void ProfilerZoneEnd(const char* name, int64_t begin);
+
+	static bool profiler_enabled;
 #ifdef PLAYER_INSTRUMENTATION_VTUNE
 	static __itt_domain* domain;
 #endif
@@ -84,12 +155,35 @@ inline void Instrumentation::FrameBegin() {
 	assert(domain);
 	__itt_frame_begin_v3(domain, nullptr);
 #endif
+	if (profiler_enabled) {
+		ProfilerFrameBegin();
+	}
 }
 inline void Instrumentation::FrameEnd() {
 #ifdef PLAYER_INSTRUMENTATION_VTUNE
 	assert(domain);
 	__itt_frame_end_v3(domain, nullptr);
 #endif
+	if (profiler_enabled) {
+		ProfilerFrameEnd();
+	}
+}
+
+inline bool Instrumentation::IsProfilerEnabled() {
+	return profiler_enabled;
+}
+
+inline Instrumentation::Zone::Zone(const char* name) {
+	if (profiler_enabled) {
+		this->name = name;
+		begin = ProfilerZoneBegin();
+	}
+}
+
+inline Instrumentation::Zone::~Zone() {
+	if (name) {
+		ProfilerZoneEnd(name, begin);
+	}
 }
 
 inline Instrumentation::FrameScope::FrameScope(bool frame_begin)
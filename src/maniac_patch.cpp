@@ -24,6 +24,10 @@
 #include "output.h"
 #include "input.h"
 
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <unordered_map>
 #include <vector>
 
 /*
@@ -199,14 +203,15 @@ int process(std::vector<int32_t>::iterator& it, std::vector<int32_t>::iterator e
 			if (imm2 == 0) {
 				return imm;
 			}
-			return imm / imm2;
+			// 64 bit because INT_MIN / -1 overflows
+			return static_cast<int32_t>(Utils::Clamp<int64_t>(static_cast<int64_t>(imm) / imm2, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max()));
 		case Op::Mod:
 			imm = process(it, end, ip);
 			imm2 = process(it, end, ip);
 			if (imm2 == 0) {
 				return imm;
 			}
-			return imm % imm2;
+			return static_cast<int32_t>(static_cast<int64_t>(imm) % imm2);
 		case Op::BitOr:
 			imm = process(it, end, ip);
 			imm2 = process(it, end, ip);
@@ -265,6 +270,7 @@ int process(std::vector<int32_t>::iterator& it, std::vector<int32_t>::iterator e
 			imm3 = process(it, end, ip);
 			return imm != 0 ? imm2 : imm3;
 		case Op::Function:
+			// The arguments are evaluated in the order they are encoded
 			imm = *it++; // function
 			imm2 = *it++; // arguments
 
@@ -301,6 +307,7 @@ int process(std::vector<int32_t>::iterator& it, std::vector<int32_t>::iterator e
 						Output::Warning("Maniac: Expression actor args {} != 2", imm2);
 						return 0;
 					}
+					imm3 = process(it, end, ip);
 					return ControlVariables::Actor(process(it, end, ip), imm3);
 				case Fn::Party:
 					if (imm2 != 2) {
@@ -328,43 +335,53 @@ int process(std::vector<int32_t>::iterator& it, std::vector<int32_t>::iterator e
 						Output::Warning("Maniac: Expression pow args {} != 2", imm2);
 						return 0;
 					}
-					return ControlVariables::Pow(process(it, end, ip), process(it, end, ip));
+					imm3 = process(it, end, ip);
+					return ControlVariables::Pow(imm3, process(it, end, ip));
 				case Fn::Sqrt:
 					if (imm2 != 2) {
 						Output::Warning("Maniac: Expression sqrt args {} != 2", imm2);
 						return 0;
 					}
-					return ControlVariables::Sqrt(process(it, end, ip), process(it, end, ip));
+					imm3 = process(it, end, ip);
+					return ControlVariables::Sqrt(imm3, process(it, end, ip));
 				case Fn::Sin:
 					if (imm2 != 3) {
 						Output::Warning("Maniac: Expression sin args {} != 3", imm2);
 						return 0;
 					}
-					return ControlVariables::Sin(process(it, end, ip), process(it, end, ip), process(it, end, ip));
+					imm3 = process(it, end, ip);
+					value = process(it, end, ip);
+					return ControlVariables::Sin(imm3, value, process(it, end, ip));
 				case Fn::Cos:
 					if (imm2 != 3) {
 						Output::Warning("Maniac: Expression cos args {} != 3", imm2);
 						return 0;
 					}
-					return ControlVariables::Cos(process(it, end, ip), process(it, end, ip), process(it, end, ip));
+					imm3 = process(it, end, ip);
+					value = process(it, end, ip);
+					return ControlVariables::Cos(imm3, value, process(it, end, ip));
 				case Fn::Atan2:
 					if (imm2 != 3) {
 						Output::Warning("Maniac: Expression atan2 args {} != 3", imm2);
 						return 0;
 					}
-					return ControlVariables::Atan2(process(it, end, ip), process(it, end, ip), process(it, end, ip));
+					imm3 = process(it, end, ip);
+					value = process(it, end, ip);
+					return ControlVariables::Atan2(imm3, value, process(it, end, ip));
 				case Fn::Min:
 					if (imm2 != 2) {
 						Output::Warning("Maniac: Expression min args {} != 2", imm2);
 						return 0;
 					}
-					return ControlVariables::Min(process(it, end, ip), process(it, end, ip));
+					imm3 = process(it, end, ip);
+					return ControlVariables::Min(imm3, process(it, end, ip));
 				case Fn::Max:
 					if (imm2 != 2) {
 						Output::Warning("Maniac: Expression max args {} != 2", imm2);
 						return 0;
 					}
-					return ControlVariables::Max(process(it, end, ip), process(it, end, ip));
+					imm3 = process(it, end, ip);
+					return ControlVariables::Max(imm3, process(it, end, ip));
 				case Fn::Abs:
 					if (imm2 != 1) {
 						Output::Warning("Maniac: Expression abs args {} != 1", imm2);
@@ -376,25 +393,33 @@ int process(std::vector<int32_t>::iterator& it, std::vector<int32_t>::iterator e
 						Output::Warning("Maniac: Expression clamp args {} != 3", imm2);
 						return 0;
 					}
-					return ControlVariables::Clamp(process(it, end, ip), process(it, end, ip), process(it, end, ip));
+					imm3 = process(it, end, ip);
+					value = process(it, end, ip);
+					return ControlVariables::Clamp(imm3, value, process(it, end, ip));
 				case Fn::Muldiv:
 					if (imm2 != 3) {
 						Output::Warning("Maniac: Expression muldiv args {} != 3", imm2);
 						return 0;
 					}
-					return ControlVariables::Muldiv(process(it, end, ip), process(it, end, ip), process(it, end, ip));
+					imm3 = process(it, end, ip);
+					value = process(it, end, ip);
+					return ControlVariables::Muldiv(imm3, value, process(it, end, ip));
 				case Fn::Divmul:
 					if (imm2 != 3) {
 						Output::Warning("Maniac: Expression divmul args {} != 3", imm2);
 						return 0;
 					}
-					return ControlVariables::Divmul(process(it, end, ip), process(it, end, ip), process(it, end, ip));
+					imm3 = process(it, end, ip);
+					value = process(it, end, ip);
+					return ControlVariables::Divmul(imm3, value, process(it, end, ip));
 				case Fn::Between:
 					if (imm2 != 3) {
 						Output::Warning("Maniac: Expression between args {} != 3", imm2);
 						return 0;
 					}
-					return ControlVariables::Between(process(it, end, ip), process(it, end, ip), process(it, end, ip));
+					imm3 = process(it, end, ip);
+					value = process(it, end, ip);
+					return ControlVariables::Between(imm3, value, process(it, end, ip));
 				default:
 					Output::Warning("Maniac: Expression Unknown Func {}", imm);
 					for (int i = 0; i < imm2; ++i) {
@@ -408,19 +433,555 @@ int process(std::vector<int32_t>::iterator& it, std::vector<int32_t>::iterator e
 	}
 }
 
+namespace {
+	std::vector<int32_t> Unpack(Span<const int32_t> op_codes) {
+		std::vector<int32_t> ops;
+		ops.reserve(op_codes.size() * 4);
+		for (auto &o: op_codes) {
+			auto uo = static_cast<uint32_t>(o);
+			ops.push_back(static_cast<int32_t>(uo & 0x000000FF));
+			ops.push_back(static_cast<int32_t>((uo & 0x0000FF00) >> 8));
+			ops.push_back(static_cast<int32_t>((uo & 0x00FF0000) >> 16));
+			ops.push_back(static_cast<int32_t>((uo & 0xFF000000) >> 24));
+		}
+		return ops;
+	}
+
+	using OpCode = ManiacPatch::Expression::OpCode;
+	using Instruction = ManiacPatch::Expression::Instruction;
+
+	int32_t ClampToInt32(int64_t value) {
+		return static_cast<int32_t>(Utils::Clamp<int64_t>(value, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max()));
+	}
+
+	/** @return whether the result only depends on the arguments */
+	bool IsPure(const Instruction& ins) {
+		switch (ins.op) {
+			case OpCode::Var:
+			case OpCode::Switch:
+			case OpCode::VarIndirect:
+			case OpCode::SwitchIndirect:
+				return false;
+			case OpCode::Call:
+				switch (static_cast<Fn>(ins.value)) {
+					case Fn::Rand:
+					case Fn::Item:
+					case Fn::Event:
+					case Fn::Actor:
+					case Fn::Party:
+					case Fn::Enemy:
+					case Fn::Misc:
+						return false;
+					default:
+						return true;
+				}
+			default:
+				return true;
+		}
+	}
+
+	/** @return amount of values taken from the stack */
+	int GetArgumentCount(const Instruction& ins) {
+		switch (ins.op) {
+			case OpCode::Push:
+				return 0;
+			case OpCode::Var:
+			case OpCode::Switch:
+			case OpCode::VarIndirect:
+			case OpCode::SwitchIndirect:
+			case OpCode::Negate:
+			case OpCode::Not:
+			case OpCode::Flip:
+				return 1;
+			case OpCode::Ternary:
+				return 3;
+			case OpCode::Call:
+				return ins.args;
+			default:
+				return 2;
+		}
+	}
+
+	/**
+	 * Computes the result of an instruction.
+	 * args points to the first argument, the arguments are in the order they are encoded.
+	 */
+	int32_t Execute(const Instruction& ins, const int32_t* args, const Game_Interpreter* ip) {
+		switch (ins.op) {
+			case OpCode::Push:
+				return ins.value;
+			case OpCode::Var:
+				return Main_Data::game_variables->Get(args[0]);
+			case OpCode::Switch:
+				return Main_Data::game_switches->GetInt(args[0]);
+			case OpCode::VarIndirect:
+				return Main_Data::game_variables->GetIndirect(args[0]);
+			case OpCode::SwitchIndirect:
+				return Main_Data::game_switches->GetInt(Main_Data::game_variables->Get(args[0]));
+			case OpCode::Negate:
+				return -args[0];
+			case OpCode::Not:
+				return !args[0] ? 0 : 1;
+			case OpCode::Flip:
+				return ~args[0];
+			case OpCode::Add:
+				return ClampToInt32(static_cast<int64_t>(args[0]) + args[1]);
+			case OpCode::Sub:
+				return ClampToInt32(static_cast<int64_t>(args[0]) - args[1]);
+			case OpCode::Mul:
+				return ClampToInt32(static_cast<int64_t>(args[0]) * args[1]);
+			case OpCode::Div:
+				return args[1] == 0 ? args[0] : ClampToInt32(static_cast<int64_t>(args[0]) / args[1]);
+			case OpCode::Mod:
+				return args[1] == 0 ? args[0] : static_cast<int32_t>(static_cast<int64_t>(args[0]) % args[1]);
+			case OpCode::BitOr:
+				return args[0] | args[1];
+			case OpCode::BitAnd:
+				return args[0] & args[1];
+			case OpCode::BitXor:
+				return args[0] ^ args[1];
+			case OpCode::BitShiftLeft:
+				return args[0] << args[1];
+			case OpCode::BitShiftRight:
+				return args[0] >> args[1];
+			case OpCode::Equal:
+				return args[0] == args[1] ? 1 : 0;
+			case OpCode::GreaterEqual:
+				return args[0] >= args[1] ? 1 : 0;
+			case OpCode::LessEqual:
+				return args[0] <= args[1] ? 1 : 0;
+			case OpCode::Greater:
+				return args[0] > args[1] ? 1 : 0;
+			case OpCode::Less:
+				return args[0] < args[1] ? 1 : 0;
+			case OpCode::NotEqual:
+				return args[0] != args[1] ? 1 : 0;
+			case OpCode::Or:
+				return !!args[0] || !!args[1] ? 1 : 0;
+			case OpCode::And:
+				return !!args[0] && !!args[1] ? 1 : 0;
+			case OpCode::Ternary:
+				return args[0] != 0 ? args[1] : args[2];
+			case OpCode::Call:
+				break;
+		}
+
+		switch (static_cast<Fn>(ins.value)) {
+			case Fn::Rand:
+				return ControlVariables::Random(args[1], args[0]);
+			case Fn::Item:
+				return ControlVariables::Item(args[1], args[0]);
+			case Fn::Event:
+				return ControlVariables::Event(args[1], args[0], *ip);
+			case Fn::Actor:
+				return ControlVariables::Actor(args[1], args[0]);
+			case Fn::Party:
+				return ControlVariables::Party(args[1], args[0]);
+			case Fn::Enemy:
+				return ControlVariables::Enemy(args[1], args[0]);
+			case Fn::Misc:
+				return ControlVariables::Other(args[0]);
+			case Fn::Pow:
+				return ControlVariables::Pow(args[0], args[1]);
+			case Fn::Sqrt:
+				return ControlVariables::Sqrt(args[0], args[1]);
+			case Fn::Sin:
+				return ControlVariables::Sin(args[0], args[1], args[2]);
+			case Fn::Cos:
+				return ControlVariables::Cos(args[0], args[1], args[2]);
+			case Fn::Atan2:
+				return ControlVariables::Atan2(args[0], args[1], args[2]);
+			case Fn::Min:
+				return ControlVariables::Min(args[0], args[1]);
+			case Fn::Max:
+				return ControlVariables::Max(args[0], args[1]);
+			case Fn::Abs:
+				return ControlVariables::Abs(args[0]);
+			case Fn::Clamp:
+				return ControlVariables::Clamp(args[0], args[1], args[2]);
+			case Fn::Muldiv:
+				return ControlVariables::Muldiv(args[0], args[1], args[2]);
+			case Fn::Divmul:
+				return ControlVariables::Divmul(args[0], args[1], args[2]);
+			case Fn::Between:
+				return ControlVariables::Between(args[0], args[1], args[2]);
+			default:
+				// Unknown function, the arguments were only evaluated
+				return 0;
+		}
+	}
+
+	/**
+	 * Translates the op codes into instructions.
+	 * Consumes the op codes exactly like process() does, so malformed
+	 * expressions yield the same result.
+	 */
+	class Compiler {
+	public:
+		explicit Compiler(Span<const int32_t> op_codes) : ops(Unpack(op_codes)) {}
+
+		ManiacPatch::Expression Compile() {
+			Parse();
+			return std::move(expr);
+		}
+
+	private:
+		bool AtEnd() const {
+			return pos >= ops.size();
+		}
+
+		int32_t Next() {
+			if (AtEnd()) {
+				++pos;
+				return 0;
+			}
+			return ops[pos++];
+		}
+
+		void Push(int32_t value) {
+			Emit({ OpCode::Push, 0, value });
+		}
+
+		void Emit(Instruction ins) {
+			const int argc = GetArgumentCount(ins);
+			assert(depth >= argc);
+
+			// Constant folding: All arguments are constants when the last instructions are Push.
+			// A non constant argument always ends with an instruction other than Push.
+			auto& code = expr.code;
+			if (ins.op != OpCode::Push && IsPure(ins) && static_cast<int>(code.size()) >= argc &&
+					std::all_of(code.end() - argc, code.end(), [](const Instruction& i) { return i.op == OpCode::Push; })) {
+				int32_t args[3] = {};
+				for (int i = 0; i < argc; ++i) {
+					args[std::min(i, 2)] = code[code.size() - argc + i].value;
+				}
+				code.resize(code.size() - argc);
+				depth -= argc;
+				ins = { OpCode::Push, 0, Execute(ins, args, nullptr) };
+			}
+
+			depth += 1 - GetArgumentCount(ins);
+			expr.stack_size = std::max(expr.stack_size, depth);
+			code.push_back(ins);
+		}
+
+		void EmitOp(OpCode op, int argc) {
+			for (int i = 0; i < argc; ++i) {
+				Parse();
+			}
+			Emit({ op, 0, 0 });
+		}
+
+		void EmitCall(Fn fn, int argc) {
+			for (int i = 0; i < argc; ++i) {
+				Parse();
+			}
+			Emit({ OpCode::Call, static_cast<uint8_t>(argc), static_cast<int32_t>(fn) });
+		}
+
+		void Parse();
+
+		void Function();
+
+		std::vector<int32_t> ops;
+		size_t pos = 0;
+		int depth = 0;
+		ManiacPatch::Expression expr;
+	};
+
+	void Compiler::Parse() {
+		if (AtEnd()) {
+			Push(0);
+			return;
+		}
+
+		auto op = static_cast<Op>(Next());
+
+		switch (op) {
+			case Op::Null:
+				Next();
+				Push(0);
+				return;
+			case Op::U8:
+			case Op::UX8:
+				Push(Next());
+				return;
+			case Op::U16:
+			case Op::UX16: {
+				int32_t imm = Next();
+				if (AtEnd()) {
+					Push(0);
+					return;
+				}
+				int32_t imm2 = Next();
+				Push((imm2 << 8) + imm);
+				return;
+			}
+			case Op::S32:
+			case Op::SX32: {
+				int32_t value = 0;
+				for (int i = 0; i < 3; ++i) {
+					value |= Next() << (i * 8);
+					if (AtEnd()) {
+						Push(0);
+						return;
+					}
+				}
+				value += Next() << 24;
+				Push(value);
+				return;
+			}
+			case Op::Var:
+				EmitOp(OpCode::Var, 1);
+				return;
+			case Op::Switch:
+				EmitOp(OpCode::Switch, 1);
+				return;
+			case Op::VarIndirect:
+				EmitOp(OpCode::VarIndirect, 1);
+				return;
+			case Op::SwitchIndirect:
+				EmitOp(OpCode::SwitchIndirect, 1);
+				return;
+			case Op::Negate:
+				EmitOp(OpCode::Negate, 1);
+				return;
+			case Op::Not:
+				EmitOp(OpCode::Not, 1);
+				return;
+			case Op::Flip:
+				EmitOp(OpCode::Flip, 1);
+				return;
+			case Op::Add:
+				EmitOp(OpCode::Add, 2);
+				return;
+			case Op::Sub:
+				EmitOp(OpCode::Sub, 2);
+				return;
+			case Op::Mul:
+				EmitOp(OpCode::Mul, 2);
+				return;
+			case Op::Div:
+				EmitOp(OpCode::Div, 2);
+				return;
+			case Op::Mod:
+				EmitOp(OpCode::Mod, 2);
+				return;
+			case Op::BitOr:
+				EmitOp(OpCode::BitOr, 2);
+				return;
+			case Op::BitAnd:
+				EmitOp(OpCode::BitAnd, 2);
+				return;
+			case Op::BitXor:
+				EmitOp(OpCode::BitXor, 2);
+				return;
+			case Op::BitShiftLeft:
+				EmitOp(OpCode::BitShiftLeft, 2);
+				return;
+			case Op::BitShiftRight:
+				EmitOp(OpCode::BitShiftRight, 2);
+				return;
+			case Op::Equal:
+				EmitOp(OpCode::Equal, 2);
+				return;
+			case Op::GreaterEqual:
+				EmitOp(OpCode::GreaterEqual, 2);
+				return;
+			case Op::LessEqual:
+				EmitOp(OpCode::LessEqual, 2);
+				return;
+			case Op::Greater:
+				EmitOp(OpCode::Greater, 2);
+				return;
+			case Op::Less:
+				EmitOp(OpCode::Less, 2);
+				return;
+			case Op::NotEqual:
+				EmitOp(OpCode::NotEqual, 2);
+				return;
+			case Op::Or:
+				EmitOp(OpCode::Or, 2);
+				return;
+			case Op::And:
+				EmitOp(OpCode::And, 2);
+				return;
+			case Op::Ternary:
+				EmitOp(OpCode::Ternary, 3);
+				return;
+			case Op::Function:
+				Function();
+				return;
+			default:
+				Output::Warning("Maniac: Expression contains unsupported operation {}", static_cast<int>(op));
+				Push(0);
+				return;
+		}
+	}
+
+	void Compiler::Function() {
+		const int32_t fn = Next();
+		const int32_t argc = Next();
+
+		if ((argc & 0x80) != 0) {
+			// Argument count is 4 bytes, that mode is not supported
+			Output::Warning("Maniac: Expression func long args unsupported");
+			Push(0);
+			return;
+		}
+
+		auto check_args = [&](int expected, const char* name) {
+			if (argc != expected) {
+				Output::Warning("Maniac: Expression {} args {} != {}", name, argc, expected);
+				Push(0);
+				return false;
+			}
+			EmitCall(static_cast<Fn>(fn), argc);
+			return true;
+		};
+
+		switch (static_cast<Fn>(fn)) {
+			case Fn::Rand:
+				check_args(2, "rnd");
+				return;
+			case Fn::Item:
+				check_args(2, "item");
+				return;
+			case Fn::Event:
+				check_args(2, "event");
+				return;
+			case Fn::Actor:
+				check_args(2, "actor");
+				return;
+			case Fn::Party:
+				check_args(2, "member");
+				return;
+			case Fn::Enemy:
+				check_args(2, "enemy");
+				return;
+			case Fn::Misc:
+				check_args(1, "misc");
+				return;
+			case Fn::Pow:
+				check_args(2, "pow");
+				return;
+			case Fn::Sqrt:
+				check_args(2, "sqrt");
+				return;
+			case Fn::Sin:
+				check_args(3, "sin");
+				return;
+			case Fn::Cos:
+				check_args(3, "cos");
+				return;
+			case Fn::Atan2:
+				check_args(3, "atan2");
+				return;
+			case Fn::Min:
+				check_args(2, "min");
+				return;
+			case Fn::Max:
+				check_args(2, "max");
+				return;
+			case Fn::Abs:
+				check_args(1, "abs");
+				return;
+			case Fn::Clamp:
+				check_args(3, "clamp");
+				return;
+			case Fn::Muldiv:
+				check_args(3, "muldiv");
+				return;
+			case Fn::Divmul:
+				check_args(3, "divmul");
+				return;
+			case Fn::Between:
+				check_args(3, "between");
+				return;
+			default:
+				Output::Warning("Maniac: Expression Unknown Func {}", fn);
+				EmitCall(static_cast<Fn>(fn), argc);
+				return;
+		}
+	}
+
+	/** Compiled expression of an event command */
+	struct CacheEntry {
+		/** To detect when the memory of the command was reused for another command */
+		std::vector<int32_t> op_codes;
+		ManiacPatch::Expression expr;
+	};
+
+	std::unordered_map<const int32_t*, CacheEntry> expression_cache;
+
+	// Limits the memory used when many maps with expressions are visited
+	constexpr size_t expression_cache_limit = 4096;
+}
+
+ManiacPatch::Expression ManiacPatch::CompileExpression(Span<const int32_t> op_codes) {
+	return Compiler(op_codes).Compile();
+}
+
+int32_t ManiacPatch::EvaluateExpression(const Expression& expr, const Game_Interpreter& interpreter) {
+	if (expr.code.empty()) {
+		return 0;
+	}
+
+	constexpr int small_stack = 32;
+	int32_t small[small_stack];
+	std::vector<int32_t> large;
+
+	int32_t* stack = small;
+	if (expr.stack_size > small_stack) {
+		large.resize(expr.stack_size);
+		stack = large.data();
+	}
+
+	// Points behind the topmost value
+	int32_t* sp = stack;
+
+	for (const auto& ins : expr.code) {
+		if (ins.op == OpCode::Push) {
+			*sp++ = ins.value;
+			continue;
+		}
+
+		sp -= GetArgumentCount(ins);
+		*sp = Execute(ins, sp, &interpreter);
+		++sp;
+	}
+
+	assert(sp == stack + 1);
+	return stack[0];
+}
+
 int32_t ManiacPatch::ParseExpression(Span<const int32_t> op_codes, const Game_Interpreter& interpreter) {
-	std::vector<int32_t> ops;
-	for (auto &o: op_codes) {
-		auto uo = static_cast<uint32_t>(o);
-		ops.push_back(static_cast<int32_t>(uo & 0x000000FF));
-		ops.push_back(static_cast<int32_t>((uo & 0x0000FF00) >> 8));
-		ops.push_back(static_cast<int32_t>((uo & 0x00FF0000) >> 16));
-		ops.push_back(static_cast<int32_t>((uo & 0xFF000000) >> 24));
+	auto it = expression_cache.find(op_codes.data());
+
+	if (it == expression_cache.end() || !std::equal(op_codes.begin(), op_codes.end(), it->second.op_codes.begin(), it->second.op_codes.end())) {
+		if (expression_cache.size() >= expression_cache_limit) {
+			expression_cache.clear();
+		}
+
+		auto& entry = expression_cache[op_codes.data()];
+		entry.op_codes.assign(op_codes.begin(), op_codes.end());
+		entry.expr = CompileExpression(op_codes);
+		return EvaluateExpression(entry.expr, interpreter);
 	}
+
+	return EvaluateExpression(it->second.expr, interpreter);
+}
+
+int32_t ManiacPatch::InterpretExpression(Span<const int32_t> op_codes, const Game_Interpreter& interpreter) {
+	auto ops = Unpack(op_codes);
 	auto beg = ops.begin();
 	return process(beg, ops.end(), interpreter);
 }
 
+void ManiacPatch::ClearExpressionCache() {
+	expression_cache.clear();
+}
+
 std::array<bool, 50> ManiacPatch::GetKeyRange() {
 	std::array<Input::Keys::InputKey, 50> keys = {
 		Input::Keys::A,
@@ -21,13 +21,104 @@
 
 #include <array>
 #include <cstdint>
+#include <vector>
 #include "span.h"
 
 class Game_Interpreter;
 
 namespace ManiacPatch {
+	/**
+	 * A Maniac expression decoded into a flat instruction list for a stack machine.
+	 * Subexpressions that only use constants are already evaluated.
+	 */
+	struct Expression {
+		enum class OpCode : uint8_t {
+			/** Pushes value */
+			Push,
+			Var,
+			Switch,
+			VarIndirect,
+			SwitchIndirect,
+			Negate,
+			Not,
+			Flip,
+			Add,
+			Sub,
+			Mul,
+			Div,
+			Mod,
+			BitOr,
+			BitAnd,
+			BitXor,
+			BitShiftLeft,
+			BitShiftRight,
+			Equal,
+			GreaterEqual,
+			LessEqual,
+			Greater,
+			Less,
+			NotEqual,
+			Or,
+			And,
+			Ternary,
+			/** Calls function value with args arguments */
+			Call
+		};
+
+		struct Instruction {
+			OpCode op = OpCode::Push;
+			/** Argument count of Call */
+			uint8_t args = 0;
+			/** Constant of Push or function of Call */
+			int32_t value = 0;
+		};
+
+		std::vector<Instruction> code;
+		/** Largest amount of values on the stack during evaluation */
+		int stack_size = 0;
+	};
+
+	/**
+	 * Decodes the op codes of an expression.
+	 * Unsupported operations are reported here and evaluate to 0.
+	 *
+	 * @param op_codes packed op codes of the event command
+	 * @return compiled expression
+	 */
+	Expression CompileExpression(Span<const int32_t> op_codes);
+
+	/**
+	 * Evaluates a compiled expression.
+	 *
+	 * @param expr compiled expression
+	 * @param interpreter interpreter executing the command
+	 * @return result
+	 */
+	int32_t EvaluateExpression(const Expression& expr, const Game_Interpreter& interpreter);
+
+	/**
+	 * Evaluates the expression of an event command.
+	 * The compiled expression is cached, the op codes are only decoded again when they change.
+	 *
+	 * @param op_codes packed op codes of the event command
+	 * @param interpreter interpreter executing the command
+	 * @return result
+	 */
 	int32_t ParseExpression(Span<const int32_t> op_codes, const Game_Interpreter& interpreter);
 
+	/**
+	 * Evaluates an expression by walking the op codes without compiling them.
+	 * Slower than ParseExpression, kept as a reference for tests and benchmarks.
+	 *
+	 * @param op_codes packed op codes of the event command
+	 * @param interpreter interpreter executing the command
+	 * @return result
+	 */
+	int32_t InterpretExpression(Span<const int32_t> op_codes, const Game_Interpreter& interpreter);
+
+	/** Removes all compiled expressions */
+	void ClearExpressionCache();
+
 	std::array<bool, 50> GetKeyRange();
 
 	bool GetKeyState(uint32_t key_id);
@@ -0,0 +1,265 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include <algorithm>
+#include <cassert>
+#include <list>
+#include <lcf/lmu/reader.h>
+#include <lcf/reader_lcf.h>
+#include "map_cache.h"
+#include "worker_pool.h"
+
+#ifdef HAVE_THREADS
+#  include <condition_variable>
+#  include <mutex>
+#endif
+
+namespace {
+	/** A cached map, or a map that is parsed by the worker pool */
+	struct Slot {
+		/** nullptr when the prefetch failed */
+		std::shared_ptr<const lcf::rpg::Map> map;
+		// Protected by prefetch_mutex
+		bool pending = false;
+	};
+
+	struct Entry {
+		int map_id;
+		std::shared_ptr<Slot> slot;
+	};
+
+	/** The front of the list is the most recently used map */
+	std::list<Entry> lru;
+	MapCache::Stats stats;
+
+#ifdef HAVE_THREADS
+	std::mutex prefetch_mutex;
+	std::condition_variable prefetch_cv;
+
+	/** A map waiting for the prefetch task */
+	struct PrefetchJob {
+		std::shared_ptr<Slot> slot;
+		Filesystem_Stream::InputStream stream;
+		bool is_xml;
+		std::string encoding;
+	};
+
+	// Protected by prefetch_mutex
+	std::list<PrefetchJob> prefetch_queue;
+	bool prefetch_task_running = false;
+#endif
+
+	/**
+	 * The lcf reader reports errors through a global and is not safe to use
+	 * from two threads at once. Held by every map parse and every ParseLock.
+	 */
+#ifdef HAVE_THREADS
+	std::mutex parse_mutex;
+#endif
+
+	std::unique_ptr<lcf::rpg::Map> Parse(Filesystem_Stream::InputStream& stream, bool is_xml, StringView encoding, std::string* error) {
+		MapCache::ParseLock lock;
+		std::unique_ptr<lcf::rpg::Map> map;
+		if (is_xml) {
+			map = lcf::LMU_Reader::LoadXml(stream);
+		} else {
+			map = lcf::LMU_Reader::Load(stream, encoding);
+		}
+
+		if (!map && error) {
+			*error = lcf::LcfReader::GetError();
+		}
+		return map;
+	}
+
+#ifdef HAVE_THREADS
+	/**
+	 * Parses the queued maps one after another. Only one instance runs at a
+	 * time, so prefetching never occupies more than one worker.
+	 */
+	void RunPrefetchQueue() {
+		std::unique_lock<std::mutex> lock(prefetch_mutex);
+
+		while (!prefetch_queue.empty()) {
+			auto job = std::move(prefetch_queue.front());
+			prefetch_queue.pop_front();
+			lock.unlock();
+
+			// The lcf field tables were already built by the map parsed on the main thread,
+			// the worker only reads them.
+			auto map = Parse(job.stream, job.is_xml, job.encoding, nullptr);
+			job.stream.Close();
+
+			lock.lock();
+			job.slot->map = std::move(map);
+			job.slot->pending = false;
+			prefetch_cv.notify_all();
+		}
+
+		prefetch_task_running = false;
+	}
+#endif
+
+	std::list<Entry>::iterator Find(int map_id) {
+		return std::find_if(lru.begin(), lru.end(), [map_id](const Entry& e) { return e.map_id == map_id; });
+	}
+
+	void Insert(int map_id, std::shared_ptr<Slot> slot) {
+		lru.push_front({ map_id, std::move(slot) });
+
+		// A running prefetch of an evicted map finishes into its orphaned slot
+		while (static_cast<int>(lru.size()) > MapCache::max_entries) {
+			lru.pop_back();
+		}
+	}
+
+	void WaitForPrefetch(Slot& slot) {
+#ifdef HAVE_THREADS
+		std::unique_lock<std::mutex> lock(prefetch_mutex);
+		prefetch_cv.wait(lock, [&slot]() { return !slot.pending; });
+#else
+		assert(!slot.pending);
+#endif
+	}
+}
+
+MapCache::ParseLock::ParseLock() {
+#ifdef HAVE_THREADS
+	parse_mutex.lock();
+#endif
+}
+
+MapCache::ParseLock::~ParseLock() {
+#ifdef HAVE_THREADS
+	parse_mutex.unlock();
+#endif
+}
+
+std::unique_ptr<lcf::rpg::Map> MapCache::Get(int map_id) {
+	auto it = Find(map_id);
+	if (it == lru.end()) {
+		++stats.misses;
+		return nullptr;
+	}
+
+	auto slot = it->slot;
+	WaitForPrefetch(*slot);
+
+	if (!slot->map) {
+		// The caller parses the file again and reports the error
+		lru.erase(it);
+		++stats.misses;
+		return nullptr;
+	}
+
+	lru.splice(lru.begin(), lru, it);
+	++stats.hits;
+
+	return std::make_unique<lcf::rpg::Map>(*slot->map);
+}
+
+std::shared_ptr<const lcf::rpg::Map> MapCache::Peek(int map_id) {
+	auto it = Find(map_id);
+	if (it == lru.end()) {
+		return nullptr;
+	}
+
+	auto& slot = *it->slot;
+#ifdef HAVE_THREADS
+	std::lock_guard<std::mutex> lock(prefetch_mutex);
+#endif
+	return slot.pending ? nullptr : slot.map;
+}
+
+void MapCache::Add(int map_id, const lcf::rpg::Map& map) {
+	auto it = Find(map_id);
+	if (it != lru.end()) {
+		lru.erase(it);
+	}
+
+	auto slot = std::make_shared<Slot>();
+	slot->map = std::make_shared<const lcf::rpg::Map>(map);
+	Insert(map_id, std::move(slot));
+}
+
+void MapCache::Prefetch(int map_id, Filesystem_Stream::InputStream stream, bool is_xml, std::string encoding) {
+#ifdef HAVE_THREADS
+	if (!stream || WorkerPool::Shared().GetThreadCount() == 0 || Contains(map_id)) {
+		return;
+	}
+
+	auto slot = std::make_shared<Slot>();
+	slot->pending = true;
+	Insert(map_id, slot);
+	++stats.prefetched;
+
+	{
+		std::lock_guard<std::mutex> lock(prefetch_mutex);
+		prefetch_queue.push_back({ slot, std::move(stream), is_xml, std::move(encoding) });
+		if (prefetch_task_running) {
+			return;
+		}
+		prefetch_task_running = true;
+	}
+
+	WorkerPool::Shared().Push(RunPrefetchQueue);
+#else
+	(void)map_id;
+	(void)stream;
+	(void)is_xml;
+	(void)encoding;
+#endif
+}
+
+std::unique_ptr<lcf::rpg::Map> MapCache::Load(Filesystem_Stream::InputStream& stream, bool is_xml, StringView encoding, std::string& error) {
+	return Parse(stream, is_xml, encoding, &error);
+}
+
+bool MapCache::Contains(int map_id) {
+	return Find(map_id) != lru.end();
+}
+
+std::vector<int> MapCache::GetTeleportTargets(const lcf::rpg::Map& map, int map_id) {
+	std::vector<int> targets;
+
+	for (const auto& ev : map.events) {
+		for (const auto& page : ev.pages) {
+			for (const auto& com : page.event_commands) {
+				if (static_cast<lcf::rpg::EventCommand::Code>(com.code) != lcf::rpg::EventCommand::Code::Teleport || com.parameters.empty()) {
+					continue;
+				}
+
+				int target = com.parameters[0];
+				if (target > 0 && target != map_id && std::find(targets.begin(), targets.end(), target) == targets.end()) {
+					targets.push_back(target);
+				}
+			}
+		}
+	}
+
+	return targets;
+}
+
+void MapCache::Clear() {
+	lru.clear();
+}
+
+MapCache::Stats MapCache::GetStats() {
+	stats.entries = static_cast<int>(lru.size());
+	return stats;
+}
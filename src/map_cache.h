@@ -0,0 +1,140 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_MAP_CACHE_H
+#define EP_MAP_CACHE_H
+
+// Headers
+#include <memory>
+#include <string>
+#include <vector>
+#include <lcf/rpg/map.h>
+#include "filesystem_stream.h"
+#include "string_view.h"
+
+/**
+ * LRU cache of parsed maps.
+ *
+ * The cache keeps the maps as parsed from the file (before translation),
+ * Get always returns a copy, so Game_Map can modify its map freely.
+ * Maps can be prefetched: The file is opened on the main thread and parsed
+ * by the worker pool, Get waits for a prefetch that is still running.
+ * The lcf reader is not reentrant: Prefetches are parsed one after another,
+ * maps parsed by the main thread must use Load and all other lcf reader
+ * calls must hold a ParseLock.
+ */
+namespace MapCache {
+	/**
+	 * Waits for a running prefetch and blocks further prefetches while alive.
+	 * The lcf reader reports errors through a global, so every lcf reader
+	 * call outside of the map cache (database, savegames) must hold one,
+	 * including the error lookup.
+	 * Must not be held while calling Get or Load.
+	 */
+	class ParseLock {
+	public:
+		ParseLock();
+		~ParseLock();
+
+		ParseLock(const ParseLock&) = delete;
+		ParseLock& operator=(const ParseLock&) = delete;
+	};
+
+	/** Counters of the cache */
+	struct Stats {
+		/** Get calls that returned a map */
+		int hits = 0;
+		/** Get calls that found no map */
+		int misses = 0;
+		/** maps parsed by the worker pool */
+		int prefetched = 0;
+		/** maps currently held, including running prefetches */
+		int entries = 0;
+	};
+
+	/** Maximum amount of maps in the cache */
+	constexpr int max_entries = 16;
+
+	/**
+	 * Returns a copy of a cached map.
+	 * Waits when the map is being prefetched.
+	 *
+	 * @param map_id id of the map
+	 * @return copy of the map or nullptr when not cached
+	 */
+	std::unique_ptr<lcf::rpg::Map> Get(int map_id);
+
+	/**
+	 * Returns a cached map without waiting and without updating the LRU order.
+	 *
+	 * @param map_id id of the map
+	 * @return the map or nullptr when not cached or still being prefetched
+	 */
+	std::shared_ptr<const lcf::rpg::Map> Peek(int map_id);
+
+	/**
+	 * Stores a copy of a parsed map.
+	 * The least recently used map is evicted when the cache is full.
+	 *
+	 * @param map_id id of the map
+	 * @param map parsed map
+	 */
+	void Add(int map_id, const lcf::rpg::Map& map);
+
+	/**
+	 * Parses a map in the background, unless it is already cached.
+	 * Without worker threads nothing is done: Parsing maps that are maybe
+	 * never visited would only delay the main thread.
+	 *
+	 * @param map_id id of the map
+	 * @param stream opened map file
+	 * @param is_xml whether the file is an EasyRPG XML map (emu)
+	 * @param encoding encoding of the LMU strings
+	 */
+	void Prefetch(int map_id, Filesystem_Stream::InputStream stream, bool is_xml, std::string encoding);
+
+	/**
+	 * Parses a map file. Waits while a prefetch is parsed.
+	 *
+	 * @param stream opened map file
+	 * @param is_xml whether the file is an EasyRPG XML map (emu)
+	 * @param encoding encoding of the LMU strings
+	 * @param error set to the error of the lcf reader when parsing failed
+	 * @return parsed map or nullptr on error
+	 */
+	std::unique_ptr<lcf::rpg::Map> Load(Filesystem_Stream::InputStream& stream, bool is_xml, StringView encoding, std::string& error);
+
+	/** @return whether a map is cached or being prefetched */
+	bool Contains(int map_id);
+
+	/**
+	 * Collects the maps targeted by the teleport commands of a map.
+	 *
+	 * @param map map to scan
+	 * @param map_id id of the map, excluded from the result
+	 * @return map ids in order of appearance, without duplicates
+	 */
+	std::vector<int> GetTeleportTargets(const lcf::rpg::Map& map, int map_id);
+
+	/** Removes all maps, e.g. when another game is loaded */
+	void Clear();
+
+	/** @return counters of the cache */
+	Stats GetStats();
+}
+
+#endif
@@ -60,6 +60,20 @@ void MessageOverlay::Draw(Bitmap& dst) {
 	dirty = false;
 }
 
+bool MessageOverlay::GetDamage(Rect& damage) {
+	std::tuple<const Bitmap*, uint32_t, bool> state = { nullptr, 0, false };
+	Rect bounds;
+
+	if (IsVisible() && bitmap && (IsAnyMessageVisible() || show_all)) {
+		// A dirty bitmap is redrawn after blitting it, the new revision causes damage in the next frame
+		state = { bitmap.get(), bitmap->GetRevision(), dirty };
+		bounds = Rect(ox, oy, bitmap->GetWidth(), bitmap->GetHeight());
+	}
+
+	damage = UpdateDamage(damage_state, state, damage_bounds, bounds);
+	return true;
+}
+
 void MessageOverlay::AddMessage(const std::string& message, Color color) {
 	if (message.empty()) {
 		return;
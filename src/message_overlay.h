@@ -20,6 +20,7 @@
 
 #include <deque>
 #include <string>
+#include <tuple>
 #include "color.h"
 #include "drawable.h"
 #include "memory_management.h"
@@ -45,6 +46,8 @@ public:
 
 	void Draw(Bitmap& dst) override;
 
+	bool GetDamage(Rect& damage) override;
+
 	void Update();
 
 	void AddMessage(const std::string& message, Color color);
@@ -74,6 +77,10 @@ private:
 	int counter = 0;
 
 	bool show_all = false;
+
+	/** Drawn bitmap, its revision and the dirty flag of the last frame, for damage tracking */
+	std::tuple<const Bitmap*, uint32_t, bool> damage_state = { nullptr, 0, false };
+	Rect damage_bounds;
 };
 
 #endif
@@ -27,6 +27,7 @@
 #include <lcf/lmt/reader.h>
 #include <lcf/lsd/reader.h>
 #include "main_data.h"
+#include "map_cache.h"
 #include "meta.h"
 #include "output.h"
 #include "player.h"
@@ -184,7 +185,11 @@ std::vector<Meta::FileItem> Meta::BuildImportCandidateList(const FilesystemView&
 			// Note that corruptness is checked later (in window_savefile.cpp)
 			std::string file = child_tree->FindFile(ss.str());
 			if (!file.empty()) {
-				std::unique_ptr<lcf::rpg::Save> savegame = lcf::LSD_Reader::Load(file, Player::encoding);
+				std::unique_ptr<lcf::rpg::Save> savegame;
+				{
+					MapCache::ParseLock lock;
+					savegame = lcf::LSD_Reader::Load(file, Player::encoding);
+				}
 				if (savegame != nullptr) {
 					if (savegame->party_location.map_id == pivot_map_id || pivot_map_id==0) {
 						FileItem item;
@@ -99,6 +99,9 @@
  */
 #define EXE_NAME "RPG_RT.exe"
 
+/** File name of the directory index in the save directory. */
+#define ASSET_INDEX_NAME "easyrpg.index"
+
 /** Default fps rate. */
 #define DEFAULT_FPS 60
 
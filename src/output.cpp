@@ -24,6 +24,9 @@
 #include <fstream>
 #include <thread>
 #include <chrono>
+#ifdef HAVE_THREADS
+#  include <mutex>
+#endif
 #ifdef __ANDROID__
 #  include <android/log.h>
 #elif defined(EMSCRIPTEN)
@@ -49,6 +52,7 @@
 #include "message_overlay.h"
 #include "font.h"
 #include "baseui.h"
+#include "simulation_thread.h"
 
 using namespace std::chrono_literals;
 
@@ -91,6 +95,18 @@ namespace {
 
 	bool ignore_pause = false;
 
+#ifdef HAVE_THREADS
+	// Messages logged by worker threads are forwarded to the main thread
+	const std::thread::id main_thread_id = std::this_thread::get_id();
+	std::mutex deferred_mutex;
+	struct DeferredMessage {
+		LogLevel lvl;
+		std::string msg;
+		Color c;
+	};
+	std::vector<DeferredMessage> deferred_log;
+#endif
+
 	std::vector<std::string> log_buffer;
 	// pair of repeat count + message
 	struct {
@@ -117,6 +133,14 @@ void Output::IgnorePause(bool const val) {
 }
 
 static void WriteLog(LogLevel lvl, std::string const& msg, Color const& c = Color()) {
+#ifdef HAVE_THREADS
+	if (std::this_thread::get_id() != main_thread_id) {
+		std::lock_guard<std::mutex> lock(deferred_mutex);
+		deferred_log.push_back({ lvl, msg, c });
+		return;
+	}
+#endif
+
 #ifdef EMSCRIPTEN
 
 // Allow pretty log output and filtering in browser console
@@ -274,6 +298,23 @@ void Output::Quit() {
 	init = false;
 }
 
+void Output::Update() {
+#ifdef HAVE_THREADS
+	std::vector<DeferredMessage> messages;
+	{
+		std::lock_guard<std::mutex> lock(deferred_mutex);
+		if (deferred_log.empty()) {
+			return;
+		}
+		messages.swap(deferred_log);
+	}
+
+	for (auto& m : messages) {
+		WriteLog(m.lvl, m.msg, m.c);
+	}
+#endif
+}
+
 bool Output::TakeScreenshot() {
 	int index = 0;
 	std::string p;
@@ -304,6 +345,12 @@ void Output::ToggleLog() {
 }
 
 void Output::ErrorStr(std::string const& err) {
+	if (SimulationThread::IsCurrentThread()) {
+		// The display belongs to the main thread, it reports the error after
+		// the batch was stopped
+		SimulationThread::Abort(err);
+	}
+
 	WriteLog(LogLevel::Error, err);
 	static bool recursive_call = false;
 	if (!recursive_call && DisplayUi) {
@@ -57,6 +57,12 @@ namespace Output {
 	 */
 	void Quit();
 
+	/**
+	 * Writes the messages that were logged by worker threads.
+	 * Must be called from the main thread, usually once per frame.
+	 */
+	void Update();
+
 	/**
 	 * Takes screenshot and save it in the save directory.
 	 *
@@ -22,6 +22,11 @@
 #include <cassert>
 #include <utility>
 
+#if defined(EP_PLATFORM_MMAP) && !defined(_WIN32)
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#endif
+
 #ifndef DT_UNKNOWN
 #define DT_UNKNOWN 0
 #endif
@@ -123,6 +128,29 @@ int64_t Platform::File::GetSize() const {
 #endif
 }
 
+int64_t Platform::File::GetModificationTime() const {
+#if defined(_WIN32)
+	WIN32_FILE_ATTRIBUTE_DATA data;
+	BOOL res = ::GetFileAttributesExW(filename.c_str(),
+			GetFileExInfoStandard,
+			&data);
+	if (!res) {
+		return -1;
+	}
+
+	// FILETIME counts 100ns intervals since 1601-01-01
+	int64_t ft = ((int64_t)data.ftLastWriteTime.dwHighDateTime << 32) | (int64_t)data.ftLastWriteTime.dwLowDateTime;
+	return (ft - INT64_C(116444736000000000)) / 10000000;
+#elif defined(__vita__)
+	// SceDateTime would need a conversion, not worth it
+	return -1;
+#else
+	struct stat sb = {};
+	int result = ::stat(filename.c_str(), &sb);
+	return (result == 0) ? (int64_t)sb.st_mtime : (int64_t)-1;
+#endif
+}
+
 bool Platform::File::MakeDirectory(bool follow_symlinks) const {
 	if (IsDirectory(follow_symlinks)) {
 		return true;
@@ -182,6 +210,65 @@ bool Platform::File::MakeDirectory(bool follow_symlinks) const {
 	return true;
 }
 
+Platform::MappedFile::MappedFile(const std::string& name) {
+#if defined(_WIN32)
+	HANDLE file_handle = ::CreateFileW(Utils::ToWideString(name).c_str(), GENERIC_READ, FILE_SHARE_READ,
+		nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file_handle == INVALID_HANDLE_VALUE) {
+		return;
+	}
+
+	LARGE_INTEGER file_size;
+	if (::GetFileSizeEx(file_handle, &file_size) && file_size.QuadPart > 0 &&
+			static_cast<uint64_t>(file_size.QuadPart) <= SIZE_MAX) {
+		mapping_handle = ::CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping_handle) {
+			data = static_cast<const uint8_t*>(::MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0));
+			if (data) {
+				size = static_cast<size_t>(file_size.QuadPart);
+			} else {
+				::CloseHandle(mapping_handle);
+				mapping_handle = nullptr;
+			}
+		}
+	}
+	// The mapping keeps the file open
+	::CloseHandle(file_handle);
+#elif defined(EP_PLATFORM_MMAP)
+	int fd = ::open(name.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return;
+	}
+
+	struct stat sb = {};
+	if (::fstat(fd, &sb) == 0 && S_ISREG(sb.st_mode) && sb.st_size > 0 &&
+			static_cast<uint64_t>(sb.st_size) <= SIZE_MAX) {
+		void* addr = ::mmap(nullptr, static_cast<size_t>(sb.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		if (addr != MAP_FAILED) {
+			data = static_cast<const uint8_t*>(addr);
+			size = static_cast<size_t>(sb.st_size);
+		}
+	}
+	// The mapping keeps the file open
+	::close(fd);
+#else
+	(void)name;
+#endif
+}
+
+Platform::MappedFile::~MappedFile() {
+	if (!data) {
+		return;
+	}
+
+#if defined(_WIN32)
+	::UnmapViewOfFile(data);
+	::CloseHandle(mapping_handle);
+#elif defined(EP_PLATFORM_MMAP)
+	::munmap(const_cast<uint8_t*>(data), size);
+#endif
+}
+
 Platform::Directory::Directory(const std::string& name) {
 #if defined(_WIN32)
 	std::wstring wname = Utils::ToWideString((name.empty() ? "." : name) + "\\*");
@@ -36,6 +36,11 @@
 #  include <sys/types.h>
 #endif
 
+#if defined(_WIN32) || ((defined(__unix__) || defined(__APPLE__)) && \
+	!defined(__vita__) && !defined(PLAYER_NINTENDO) && !defined(__EMSCRIPTEN__))
+#  define EP_PLATFORM_MMAP
+#endif
+
 /**
  * Provides abstractions for accessing operating system APIs.
  *
@@ -89,6 +94,9 @@ namespace Platform {
 		/** @return Filesize or -1 on error */
 		int64_t GetSize() const;
 
+		/** @return Time of the last modification (Unix time) or -1 on error */
+		int64_t GetModificationTime() const;
+
 		/**
 		 * Creates a directory recursively at the filename path.
 		 * @param follow_symlinks Whether to follow symlinks (if supported on this platform)
@@ -104,6 +112,44 @@ namespace Platform {
 #endif
 	};
 
+	/**
+	 * Read-only memory mapping of a whole file.
+	 * On platforms without memory mapping support opening always fails.
+	 */
+	class MappedFile {
+	public:
+		explicit MappedFile() = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile(const MappedFile&) = delete;
+
+		/**
+		 * Maps a file into memory.
+		 *
+		 * @param name File to map
+		 */
+		explicit MappedFile(const std::string& name);
+		~MappedFile();
+
+		/** @return Start of the mapped file or nullptr when mapping failed */
+		const uint8_t* GetData() const;
+
+		/** @return Size of the mapped file */
+		size_t GetSize() const;
+
+		/** @return true if the file was mapped successfully */
+		explicit operator bool() const noexcept;
+
+		/** @return true when the platform supports memory mapping */
+		static constexpr bool IsSupported();
+
+	private:
+		const uint8_t* data = nullptr;
+		size_t size = 0;
+#ifdef _WIN32
+		HANDLE mapping_handle = nullptr;
+#endif
+	};
+
 	/** Wrapper around directory reading */
 	class Directory {
 	public:
@@ -154,6 +200,26 @@ namespace Platform {
 		bool valid_entry = false;
 	};
 
+	inline const uint8_t* MappedFile::GetData() const {
+		return data;
+	}
+
+	inline size_t MappedFile::GetSize() const {
+		return size;
+	}
+
+	inline MappedFile::operator bool() const noexcept {
+		return data != nullptr;
+	}
+
+	constexpr bool MappedFile::IsSupported() {
+#ifdef EP_PLATFORM_MMAP
+		return true;
+#else
+		return false;
+#endif
+	}
+
 	inline Directory::operator bool() const noexcept {
 #ifdef __vita__
 		return dir_handle >= 0;
@@ -210,6 +210,7 @@ bool Sdl2Ui::vChangeDisplaySurfaceResolution(int new_width, int new_height) {
 	}
 
 	sdl_texture_game = new_sdl_texture_game;
+	texture_outdated = true;
 
 	BitmapRef new_main_surface = Bitmap::Create(new_width, new_height, Color(0, 0, 0, 255));
 
@@ -406,6 +407,7 @@ bool Sdl2Ui::RefreshDisplayMode() {
 			Output::Debug("SDL_CreateTexture failed : {}", SDL_GetError());
 			return false;
 		}
+		texture_outdated = true;
 
 		renderer_sg.Dismiss();
 		window_sg.Dismiss();
@@ -540,8 +542,22 @@ void Sdl2Ui::ToggleVsync() {
 }
 
 void Sdl2Ui::UpdateDisplay() {
-	// SDL_UpdateTexture was found to be faster than SDL_LockTexture / SDL_UnlockTexture.
-	SDL_UpdateTexture(sdl_texture_game, nullptr, main_surface->pixels(), main_surface->pitch());
+	Rect damage = TakeDisplayDamage();
+	if (texture_outdated) {
+		damage = main_surface->GetRect();
+		texture_outdated = false;
+	}
+
+	if (damage == main_surface->GetRect()) {
+		// SDL_UpdateTexture was found to be faster than SDL_LockTexture / SDL_UnlockTexture.
+		SDL_UpdateTexture(sdl_texture_game, nullptr, main_surface->pixels(), main_surface->pitch());
+	} else if (!damage.IsEmpty()) {
+		// Only upload the changed part. The texture still contains the rest of the last frame.
+		SDL_Rect sdl_damage = { damage.x, damage.y, damage.width, damage.height };
+		auto* pixels = static_cast<const uint8_t*>(main_surface->pixels()) +
+			damage.y * main_surface->pitch() + damage.x * main_surface->bpp();
+		SDL_UpdateTexture(sdl_texture_game, &sdl_damage, pixels, main_surface->pitch());
+	}
 
 	if (window.size_changed && window.width > 0 && window.height > 0) {
 		// Based on SDL2 function UpdateLogicalSize
@@ -703,6 +719,12 @@ void Sdl2Ui::ProcessEvent(SDL_Event &evnt) {
 		case SDL_FINGERMOTION:
 			ProcessFingerEvent(evnt);
 			return;
+
+		case SDL_RENDER_TARGETS_RESET:
+		case SDL_RENDER_DEVICE_RESET:
+			// Texture contents are lost
+			texture_outdated = true;
+			return;
 	}
 }
 
@@ -1208,6 +1230,10 @@ void Sdl2Ui::vGetConfig(Game_ConfigVideo& cfg) const {
 #endif
 	cfg.scaling_mode.SetOptionVisible(true);
 	cfg.stretch.SetOptionVisible(true);
+	cfg.retained_render.SetOptionVisible(true);
+#ifdef HAVE_THREADS
+	cfg.threaded_render.SetOptionVisible(true);
+#endif
 	cfg.game_resolution.SetOptionVisible(true);
 
 	cfg.vsync.Set(current_display_mode.vsync);
@@ -128,6 +128,8 @@ private:
 	/** Main SDL window. */
 	SDL_Texture* sdl_texture_game = nullptr;
 	SDL_Texture* sdl_texture_scaled = nullptr;
+	/** sdl_texture_game was recreated and must be uploaded completely */
+	bool texture_outdated = true;
 	SDL_Window* sdl_window = nullptr;
 	SDL_Renderer* sdl_renderer = nullptr;
 	SDL_Joystick *sdl_joystick = nullptr;
@@ -41,6 +41,7 @@
 #include "dynrpg.h"
 #include "filefinder.h"
 #include "filefinder_rtp.h"
+#include "filesystem_root.h"
 #include "fileext_guesser.h"
 #include "game_actors.h"
 #include "game_battle.h"
@@ -64,6 +65,7 @@
 #include <lcf/lmt/reader.h>
 #include <lcf/lsd/reader.h>
 #include "main_data.h"
+#include "map_cache.h"
 #include "output.h"
 #include "player.h"
 #include <lcf/reader_lcf.h>
@@ -76,10 +78,13 @@
 #include "game_quit.h"
 #include "scene_settings.h"
 #include "scene_title.h"
+#include "simulation_thread.h"
+#include "task_graph.h"
 #include "instrumentation.h"
 #include "transition.h"
 #include <lcf/scope_guard.h>
 #include "baseui.h"
+#include "headless_ui.h"
 #include "game_clock.h"
 #include "message_overlay.h"
 
@@ -96,6 +101,10 @@
 #include "exe_reader.h"
 #endif
 
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
 using namespace std::chrono_literals;
 
 namespace Player {
@@ -130,6 +139,7 @@ namespace Player {
 	int frames;
 	std::string replay_input_path;
 	std::string record_input_path;
+	std::string profile_trace_path;
 	std::string command_line;
 	int speed_modifier = 3;
 	int speed_modifier_plus = 10;
@@ -150,6 +160,109 @@ namespace {
 	FileRequestBinding system_request_id;
 	FileRequestBinding save_request_id;
 	FileRequestBinding map_request_id;
+
+	/** State of the headless benchmark mode (--benchmark) */
+	struct {
+		int target_frames = 0;
+		int frames = 0;
+		Game_Clock::time_point start;
+		Game_Clock::duration draw_time = {};
+	} benchmark;
+
+	/** @return peak resident memory of the process in bytes, 0 if unknown */
+	size_t GetPeakMemoryUsage() {
+#if defined(__linux__) || defined(__APPLE__)
+		struct rusage usage;
+		if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#  ifdef __APPLE__
+			return static_cast<size_t>(usage.ru_maxrss);
+#  else
+			return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#  endif
+		}
+#endif
+		return 0;
+	}
+
+	void PrintBenchmarkReport() {
+		using ms = std::chrono::duration<double, std::milli>;
+
+		const auto total = ms(Game_Clock::now() - benchmark.start).count();
+		const auto draw = ms(benchmark.draw_time).count();
+		const int frames = std::max(benchmark.frames, 1);
+
+		Output::Info("Benchmark: {} logical frames in {:.1f} ms", benchmark.frames, total);
+		Output::Info("Benchmark: {:.1f} logical frames/s", benchmark.frames * 1000.0 / std::max(total, 1.0));
+		Output::Info("Benchmark: Draw {:.1f} ms total, {:.3f} ms/frame", draw, draw / frames);
+
+		auto peak = GetPeakMemoryUsage();
+		if (peak > 0) {
+			Output::Info("Benchmark: Peak memory {:.1f} MiB", peak / 1024.0 / 1024.0);
+		} else {
+			Output::Info("Benchmark: Peak memory unknown");
+		}
+	}
+
+	/** Executes one logical frame of the current scene */
+	void UpdateLogicalFrame() {
+		Scene::old_instances.clear();
+		{
+			Instrumentation::Zone zone("Scene Update");
+			Scene::instance->MainFunction();
+		}
+
+		Graphics::GetMessageOverlay().Update();
+	}
+
+	/**
+	 * The game scenes do not access the window and can run on the simulation thread.
+	 * Every other scene (title, settings, ...) is executed by the main thread.
+	 */
+	bool IsSimulationThreadScene() {
+		return Scene::instance && (Scene::instance->type == Scene::Map || Scene::instance->type == Scene::Battle);
+	}
+
+	/**
+	 * Handles the system keys. Can run on the simulation thread, the window
+	 * is then accessed after the batch.
+	 */
+	void UpdateSystemKeys() {
+		if (Input::IsSystemTriggered(Input::TOGGLE_FPS)) {
+			SimulationThread::RunOnMainThread([]() { DisplayUi->ToggleShowFps(); });
+		}
+		if (Input::IsSystemTriggered(Input::TAKE_SCREENSHOT)) {
+			SimulationThread::RunOnMainThread([]() { Output::TakeScreenshot(); });
+		}
+		if (Input::IsSystemTriggered(Input::SHOW_LOG)) {
+			Output::ToggleLog();
+		}
+		if (Input::IsSystemTriggered(Input::TOGGLE_ZOOM)) {
+			SimulationThread::RunOnMainThread([]() { DisplayUi->ToggleZoom(); });
+		}
+		float speed = 1.0;
+		if (Input::IsSystemPressed(Input::FAST_FORWARD)) {
+			speed = Player::speed_modifier;
+		}
+		if (Input::IsSystemPressed(Input::FAST_FORWARD_PLUS)) {
+			speed = Player::speed_modifier_plus;
+		}
+		Game_Clock::SetGameSpeedFactor(speed);
+
+		if (Main_Data::game_quit) {
+			Player::reset_flag |= Main_Data::game_quit->ShouldQuit();
+		}
+	}
+
+	/** Draws the scene to the display surface without presenting it */
+	void ComposeFrame() {
+		Graphics::Update();
+		Rect damage;
+		{
+			Instrumentation::Zone zone("Draw");
+			damage = Graphics::Draw(*DisplayUi->GetDisplaySurface());
+		}
+		DisplayUi->SetDisplayDamage(damage);
+	}
 }
 
 void Player::Init(std::vector<std::string> args) {
@@ -180,6 +293,10 @@ void Player::Init(std::vector<std::string> args) {
 	Output::Debug("CLI: {}", command_line);
 
 	Game_Clock::logClockInfo();
+	if (benchmark.target_frames > 0 && rng_seed < 0) {
+		// Replays must be reproducible
+		rng_seed = 0;
+	}
 	if (rng_seed < 0) {
 		Rand::SeedRandomNumberGenerator(time(NULL));
 	} else {
@@ -190,6 +307,10 @@ void Player::Init(std::vector<std::string> args) {
 
 	DisplayUi.reset();
 
+	if (benchmark.target_frames > 0) {
+		DisplayUi = std::make_shared<HeadlessUi>(Player::screen_width, Player::screen_height, cfg);
+	}
+
 	if(! DisplayUi) {
 		DisplayUi = BaseUi::CreateUi(Player::screen_width, Player::screen_height, cfg);
 	}
@@ -197,6 +318,10 @@ void Player::Init(std::vector<std::string> args) {
 	Input::Init(cfg.input, replay_input_path, record_input_path);
 	Input::AddRecordingData(Input::RecordingData::CommandLine, command_line);
 
+	if (DisplayUi->IsThreadedRender() && benchmark.target_frames == 0) {
+		SimulationThread::Init();
+	}
+
 	player_config = std::move(cfg.player);
 }
 
@@ -208,6 +333,7 @@ void Player::Run() {
 	reset_flag = false;
 
 	Game_Clock::ResetFrame(Game_Clock::now());
+	benchmark.start = Game_Clock::now();
 
 	// Main loop
 	// libretro invokes the MainLoop through a retro_run-callback
@@ -221,21 +347,51 @@ void Player::Run() {
 void Player::MainLoop() {
 	Instrumentation::FrameScope iframe;
 
-	const auto frame_time = Game_Clock::now();
+	// The benchmark advances the clock by exactly one logical frame per loop
+	const auto frame_time = benchmark.target_frames > 0
+		? Game_Clock::GetFrameTime() + Game_Clock::GetTargetGameTimeStep()
+		: Game_Clock::now();
 	Game_Clock::OnNextFrame(frame_time);
 
 	Player::UpdateInput();
 
 	int num_updates = 0;
+	if (SimulationThread::IsRunning()) {
+		// Threaded rendering: The frame composed at the end of the previous loop
+		// is presented while the simulation thread executes the logical frames.
+		// The window events are polled by the main thread once per loop, the
+		// system keys are handled between the frames like in the loop below.
+		SimulationThread::Run([first_frame = true]() mutable {
+			if (!IsSimulationThreadScene() || !Game_Clock::NextGameTimeStep()) {
+				return false;
+			}
+			if (!first_frame) {
+				UpdateSystemKeys();
+			}
+			first_frame = false;
+			UpdateLogicalFrame();
+			return true;
+		});
+		{
+			Instrumentation::Zone zone("Present");
+			DisplayUi->UpdateDisplay();
+		}
+		num_updates = SimulationThread::Wait();
+
+		auto error = SimulationThread::TakeError();
+		if (!error.empty()) {
+			Output::ErrorStr(error);
+		}
+	}
+
+	// Executes all frames when the simulation thread is not used, otherwise
+	// the frames the thread left over because of a scene change
 	while (Game_Clock::NextGameTimeStep()) {
 		if (num_updates > 0) {
 			Player::UpdateInput();
 		}
 
-		Scene::old_instances.clear();
-		Scene::instance->MainFunction();
-
-		Graphics::GetMessageOverlay().Update();
+		UpdateLogicalFrame();
 
 		++num_updates;
 	}
@@ -244,10 +400,30 @@ void Player::MainLoop() {
 		Input::UpdateSystem();
 	}
 
-	Player::Draw();
+	if (SimulationThread::IsRunning()) {
+		// Presented by the next loop
+		ComposeFrame();
+	} else if (benchmark.target_frames > 0) {
+		benchmark.frames += num_updates;
+		if (benchmark.frames >= benchmark.target_frames) {
+			exit_flag = true;
+		}
+
+		auto draw_begin = Game_Clock::now();
+		Player::Draw();
+		benchmark.draw_time += Game_Clock::now() - draw_begin;
+	} else {
+		Player::Draw();
+	}
 
 	Scene::old_instances.clear();
 
+	{
+		Instrumentation::Zone zone("Cache");
+		Cache::Update();
+	}
+	Output::Update();
+
 	if (!Transition::instance().IsActive() && Scene::instance->type == Scene::Null) {
 		Exit();
 		return;
@@ -286,31 +462,7 @@ void Player::Resume() {
 }
 
 void Player::UpdateInput() {
-	// Input Logic:
-	if (Input::IsSystemTriggered(Input::TOGGLE_FPS)) {
-		DisplayUi->ToggleShowFps();
-	}
-	if (Input::IsSystemTriggered(Input::TAKE_SCREENSHOT)) {
-		Output::TakeScreenshot();
-	}
-	if (Input::IsSystemTriggered(Input::SHOW_LOG)) {
-		Output::ToggleLog();
-	}
-	if (Input::IsSystemTriggered(Input::TOGGLE_ZOOM)) {
-		DisplayUi->ToggleZoom();
-	}
-	float speed = 1.0;
-	if (Input::IsSystemPressed(Input::FAST_FORWARD)) {
-		speed = speed_modifier;
-	}
-	if (Input::IsSystemPressed(Input::FAST_FORWARD_PLUS)) {
-		speed = speed_modifier_plus;
-	}
-	Game_Clock::SetGameSpeedFactor(speed);
-
-	if (Main_Data::game_quit) {
-		reset_flag |= Main_Data::game_quit->ShouldQuit();
-	}
+	UpdateSystemKeys();
 
 	// Update Logic:
 	DisplayUi->ProcessEvents();
@@ -342,7 +494,7 @@ void Player::Update(bool update_scene) {
 	// Game events can query full screen status and change their behavior, so this needs to
 	// be a game key and not a system key.
 	if (Input::IsTriggered(Input::TOGGLE_FULLSCREEN)) {
-		DisplayUi->ToggleFullscreen();
+		SimulationThread::RunOnMainThread([]() { DisplayUi->ToggleFullscreen(); });
 	}
 
 	if (Main_Data::game_quit) {
@@ -372,8 +524,8 @@ void Player::Update(bool update_scene) {
 }
 
 void Player::Draw() {
-	Graphics::Update();
-	Graphics::Draw(*DisplayUi->GetDisplaySurface());
+	ComposeFrame();
+	Instrumentation::Zone zone("Present");
 	DisplayUi->UpdateDisplay();
 }
 
@@ -389,10 +541,20 @@ int Player::GetFrames() {
 }
 
 void Player::Exit() {
+	SimulationThread::Quit();
+
+	if (benchmark.target_frames > 0) {
+		PrintBenchmarkReport();
+	}
+
 	if (player_config.settings_autosave.Get()) {
 		Scene_Settings::SaveConfig(true);
 	}
 
+	if (game_config.asset_index.Get() && FileFinder::Game()) {
+		FileFinder::SaveAssetIndex();
+	}
+
 	Graphics::UpdateSceneCallback();
 #ifdef EMSCRIPTEN
 	BitmapRef surface = DisplayUi->GetDisplaySurface();
@@ -408,6 +570,16 @@ void Player::Exit() {
 	Font::Dispose();
 	DynRpg::Reset();
 	Graphics::Quit();
+
+	if (!profile_trace_path.empty()) {
+		auto os = FileFinder::Root().OpenOutputStream(profile_trace_path, std::ios_base::out | std::ios_base::trunc);
+		if (os && Instrumentation::WriteChromeTrace(os)) {
+			Output::Debug("Profiler trace written to {}", profile_trace_path);
+		} else {
+			Output::Warning("Failed writing profiler trace to {}", profile_trace_path);
+		}
+	}
+
 	Output::Quit();
 	FileFinder::Quit();
 	DisplayUi.reset();
@@ -490,6 +662,24 @@ Game_Config Player::ParseCommandLine() {
 			debug_flag = true;
 			continue;
 		}
+		if (cp.ParseNext(arg, 1, "--benchmark")) {
+			if (arg.ParseValue(0, li_value) && li_value > 0) {
+				benchmark.target_frames = li_value;
+				no_audio_flag = true;
+			}
+			continue;
+		}
+		if (cp.ParseNext(arg, 1, "--profile-trace")) {
+			if (arg.NumValues() > 0) {
+				profile_trace_path = arg.Value(0);
+				Instrumentation::SetProfilerEnabled(true);
+			}
+			continue;
+		}
+		if (cp.ParseNext(arg, 0, "--profile")) {
+			Instrumentation::SetProfilerEnabled(true);
+			continue;
+		}
 		if (cp.ParseNext(arg, 0, {"hidetitle", "--hide-title"})) {
 			// Legacy RPG_RT argument - hidetitle
 			hide_title_flag = true;
@@ -673,46 +863,167 @@ Game_Config Player::ParseCommandLine() {
 	return cfg;
 }
 
+namespace {
+	/** Database files, opened by the main thread and parsed by a worker */
+	struct DatabaseFiles {
+		std::string ldb_name;
+		std::string lmt_name;
+		Filesystem_Stream::InputStream ldb_stream;
+		Filesystem_Stream::InputStream lmt_stream;
+		std::unique_ptr<lcf::rpg::Database> db;
+		std::unique_ptr<lcf::rpg::TreeMap> treemap;
+		std::string error;
+	};
+
+	/** Bundled fonts, opened by the main thread and read into memory by a worker */
+	struct FontFiles {
+		Filesystem_Stream::InputStream gothic;
+		Filesystem_Stream::InputStream mincho;
+	};
+
+	/** Opens the LDB and LMT (main thread) */
+	DatabaseFiles OpenDatabase();
+	/** Parses the opened LDB and LMT (any thread) */
+	void ParseDatabase(DatabaseFiles& files);
+	/** Reports errors and moves the parsed database into lcf::Data (main thread) */
+	void ApplyDatabase(DatabaseFiles& files);
+
+	/** Opens the bundled fonts (main thread) */
+	FontFiles OpenFonts();
+	/** Replaces the font streams with in-memory copies (any thread) */
+	void ReadFonts(FontFiles& files);
+	/** Creates the default fonts (main thread) */
+	void ApplyFonts(FontFiles& files);
+}
+
 void Player::CreateGameObjects() {
+	using ms = std::chrono::duration<double, std::milli>;
+	const auto startup_begin = Game_Clock::now();
+
 	// Parse game specific settings
 	CmdlineParser cp(arguments);
 	game_config = Game_ConfigGame::Create(cp);
 
+	if (game_config.asset_index.Get()) {
+		FileFinder::LoadAssetIndex();
+	}
+
+	// Maps of the previous game
+	MapCache::Clear();
+
 	// Load the meta information file.
 	// Note: This should eventually be split across multiple folders as described in Issue #1210
 	std::string meta_file = FileFinder::Game().FindFile(META_NAME);
 	meta.reset(new Meta(meta_file));
 
-	// Guess non-standard extensions (for the DB) before loading the encoding
-	GuessNonStandardExtensions();
+	// The startup stages run as a task graph: Worker tasks only parse data
+	// owned by the task, everything touching the filesystem caches, lcf::Data
+	// or the game configuration stays on the main thread.
+	using Affinity = TaskGraph::Affinity;
+	TaskGraph graph;
+
+	DatabaseFiles db_files;
+	FontFiles font_files;
+	Filesystem_Stream::InputStream exfont_stream;
+	bool has_exfont = false;
+	std::vector<uint8_t> exfont_custom;
+#ifndef EMSCRIPTEN
+	Filesystem_Stream::InputStream exeis;
+	std::unique_ptr<EXEReader> exe_reader;
+	std::unique_ptr<EXEReader::FileInfo> version_info;
+	bool detect_version = false;
+#endif
+	bool no_rtp_warning_flag = false;
+	std::vector<std::string> rtp_candidates;
+	std::shared_ptr<RootFilesystem> rtp_root;
+	int rtp_version = 0;
+	std::vector<FileFinder_RTP::SearchPath> rtp_search_paths;
+
+	auto encoding_task = graph.Add("Detect encoding", Affinity::Main, {}, [&]() {
+		// Guess non-standard extensions (for the DB) before loading the encoding
+		GuessNonStandardExtensions();
+
+		GetEncoding();
+		escape_symbol = lcf::ReaderUtil::Recode("\\", encoding);
+		if (escape_symbol.empty()) {
+			Output::Error("Invalid encoding: {}.", encoding);
+		}
+		escape_char = Utils::DecodeUTF32(Player::escape_symbol).front();
+	});
+
+	graph.Add("Translations", Affinity::Main, { encoding_task }, [&]() {
+		// Check for translation-related directories and load language names.
+		translation.InitTranslations();
+
+		std::string game_path = FileFinder::GetFullFilesystemPath(FileFinder::Game());
+		std::string save_path = FileFinder::GetFullFilesystemPath(FileFinder::Save());
+		if (game_path == save_path) {
+			Output::DebugStr("Game and Save Directory:");
+			FileFinder::DumpFilesystem(FileFinder::Game());
+		} else {
+			Output::Debug("Game Directory:");
+			FileFinder::DumpFilesystem(FileFinder::Game());
+			Output::Debug("SaveDirectory:", save_path);
+			FileFinder::DumpFilesystem(FileFinder::Save());
+		}
+	});
 
-	GetEncoding();
-	escape_symbol = lcf::ReaderUtil::Recode("\\", encoding);
-	if (escape_symbol.empty()) {
-		Output::Error("Invalid encoding: {}.", encoding);
-	}
-	escape_char = Utils::DecodeUTF32(Player::escape_symbol).front();
+	auto open_db_task = graph.Add("Open database", Affinity::Main, { encoding_task }, [&]() {
+		db_files = OpenDatabase();
+	});
 
-	// Check for translation-related directories and load language names.
-	translation.InitTranslations();
+	auto parse_db_task = graph.Add("Parse database", Affinity::Worker, { open_db_task }, [&]() {
+		ParseDatabase(db_files);
+	});
 
-	std::string game_path = FileFinder::GetFullFilesystemPath(FileFinder::Game());
-	std::string save_path = FileFinder::GetFullFilesystemPath(FileFinder::Save());
-	if (game_path == save_path) {
-		Output::DebugStr("Game and Save Directory:");
-		FileFinder::DumpFilesystem(FileFinder::Game());
-	} else {
-		Output::Debug("Game Directory:");
-		FileFinder::DumpFilesystem(FileFinder::Game());
-		Output::Debug("SaveDirectory:", save_path);
-		FileFinder::DumpFilesystem(FileFinder::Save());
-	}
+	auto open_assets_task = graph.Add("Open fonts and RPG_RT", Affinity::Main, {}, [&]() {
+		font_files = OpenFonts();
 
-	LoadDatabase();
+		// Check for bundled ExFont
+		exfont_stream = FileFinder::OpenImage("Font", "ExFont");
+		if (!exfont_stream) {
+			// Backwards compatible with older Player versions
+			exfont_stream = FileFinder::OpenImage(".", "ExFont");
+		}
+		has_exfont = static_cast<bool>(exfont_stream);
+
+#ifndef EMSCRIPTEN
+		// Attempt reading ExFont and version information from RPG_RT.exe (not supported on Emscripten)
+		exeis = FileFinder::Game().OpenFile(EXE_NAME);
+		detect_version = game_config.engine == EngineNone;
+#endif
+	});
+
+	auto read_fonts_task = graph.Add("Read fonts", Affinity::Worker, { open_assets_task }, [&]() {
+		ReadFonts(font_files);
+
+		if (has_exfont) {
+			exfont_custom = Utils::ReadStream(exfont_stream);
+		}
+	});
+
+#ifndef EMSCRIPTEN
+	auto read_exe_task = graph.Add("Read RPG_RT", Affinity::Worker, { open_assets_task }, [&]() {
+		if (!exeis) {
+			return;
+		}
+
+		exe_reader.reset(new EXEReader(std::move(exeis)));
+		if (!has_exfont) {
+			// A bundled ExFont has precedence
+			exfont_custom = exe_reader->GetExFont();
+		}
+		if (detect_version) {
+			version_info = std::make_unique<EXEReader::FileInfo>(exe_reader->GetFileInfo());
+		}
+	});
+#else
+	auto read_exe_task = open_assets_task;
+#endif
+
+	auto ini_task = graph.Add("Read ini", Affinity::Main, { encoding_task }, [&]() {
+		Player::has_custom_resolution = false;
 
-	bool no_rtp_warning_flag = false;
-	Player::has_custom_resolution = false;
-	{ // Scope lifetime of variables for ini parsing
 		std::string ini_file = FileFinder::Game().FindFile(INI_NAME);
 
 		auto ini_stream = FileFinder::Game().OpenInputStream(ini_file, std::ios_base::in);
@@ -729,117 +1040,140 @@ void Player::CreateGameObjects() {
 				}
 			}
 		}
-	}
 
-	std::stringstream title;
-	if (!game_title.empty()) {
-		Output::Debug("Loading game {}", game_title);
-		title << game_title << " - ";
-		Input::AddRecordingData(Input::RecordingData::GameTitle, game_title);
-	} else {
-		Output::Debug("Could not read game title.");
-	}
-	title << GAME_TITLE;
-	DisplayUi->SetTitle(title.str());
+		std::stringstream title;
+		if (!game_title.empty()) {
+			Output::Debug("Loading game {}", game_title);
+			title << game_title << " - ";
+			Input::AddRecordingData(Input::RecordingData::GameTitle, game_title);
+		} else {
+			Output::Debug("Could not read game title.");
+		}
+		title << GAME_TITLE;
+		DisplayUi->SetTitle(title.str());
 
-	if (no_rtp_warning_flag) {
-		Output::Debug("Game does not need RTP (FullPackageFlag=1)");
-	}
+		if (no_rtp_warning_flag) {
+			Output::Debug("Game does not need RTP (FullPackageFlag=1)");
+		}
+	});
 
-	// ExFont parsing
-	Cache::exfont_custom.clear();
-	// Check for bundled ExFont
-	auto exfont_stream = FileFinder::OpenImage("Font", "ExFont");
-	if (!exfont_stream) {
-		// Backwards compatible with older Player versions
-		exfont_stream = FileFinder::OpenImage(".", "ExFont");
-	}
+	auto apply_db_task = graph.Add("Apply database", Affinity::Main, { parse_db_task }, [&]() {
+		ApplyDatabase(db_files);
+	});
 
-	int& engine = game_config.engine;
+	auto engine_task = graph.Add("Detect engine", Affinity::Main, { apply_db_task, read_exe_task, read_fonts_task }, [&]() {
+		int& engine = game_config.engine;
 
 #ifndef EMSCRIPTEN
-	// Attempt reading ExFont and version information from RPG_RT.exe (not supported on Emscripten)
-	std::unique_ptr<EXEReader> exe_reader;
-	auto exeis = FileFinder::Game().OpenFile(EXE_NAME);
-
-	if (exeis) {
-		exe_reader.reset(new EXEReader(std::move(exeis)));
-		Cache::exfont_custom = exe_reader->GetExFont();
-		if (!Cache::exfont_custom.empty()) {
-			Output::Debug("ExFont loaded from RPG_RT");
-		}
+		if (exe_reader) {
+			if (!has_exfont && !exfont_custom.empty()) {
+				Output::Debug("ExFont loaded from RPG_RT");
+			}
 
-		if (engine == EngineNone) {
-			auto version_info = exe_reader->GetFileInfo();
-			version_info.Print();
-			bool is_patch_maniac;
-			engine = version_info.GetEngineType(is_patch_maniac);
-			if (!game_config.patch_override) {
-				game_config.patch_maniac.Set(is_patch_maniac);
+			if (version_info) {
+				version_info->Print();
+				bool is_patch_maniac;
+				engine = version_info->GetEngineType(is_patch_maniac);
+				if (!game_config.patch_override) {
+					game_config.patch_maniac.Set(is_patch_maniac);
+				}
 			}
-		}
 
-		if (engine == EngineNone) {
-			Output::Debug("Unable to detect version from exe");
+			if (engine == EngineNone) {
+				Output::Debug("Unable to detect version from exe");
+			}
+		} else {
+			Output::Debug("Cannot find RPG_RT");
 		}
-	} else {
-		Output::Debug("Cannot find RPG_RT");
-	}
 #endif
 
-	if (exfont_stream) {
-		Output::Debug("Using custom ExFont: {}", FileFinder::GetPathInsideGamePath(exfont_stream.GetName()));
-		Cache::exfont_custom = Utils::ReadStream(exfont_stream);
-	}
+		if (has_exfont) {
+			Output::Debug("Using custom ExFont: {}", FileFinder::GetPathInsideGamePath(exfont_stream.GetName()));
+		}
+		Cache::exfont_custom = std::move(exfont_custom);
 
-	if (engine == EngineNone) {
-		if (lcf::Data::system.ldb_id == 2003) {
-			engine = EngineRpg2k3;
-			if (!FileFinder::Game().FindFile("ultimate_rt_eb.dll").empty()) {
-				engine |= EngineEnglish | EngineMajorUpdated;
+		if (engine == EngineNone) {
+			if (lcf::Data::system.ldb_id == 2003) {
+				engine = EngineRpg2k3;
+				if (!FileFinder::Game().FindFile("ultimate_rt_eb.dll").empty()) {
+					engine |= EngineEnglish | EngineMajorUpdated;
+				}
+			} else {
+				engine = EngineRpg2k;
+				if (lcf::Data::data.version >= 1) {
+					engine |= EngineEnglish | EngineMajorUpdated;
+				}
 			}
-		} else {
-			engine = EngineRpg2k;
-			if (lcf::Data::data.version >= 1) {
-				engine |= EngineEnglish | EngineMajorUpdated;
+			if (!(engine & EngineMajorUpdated)) {
+				if (FileFinder::IsMajorUpdatedTree()) {
+					engine |= EngineMajorUpdated;
+				}
 			}
 		}
-		if (!(engine & EngineMajorUpdated)) {
-			if (FileFinder::IsMajorUpdatedTree()) {
-				engine |= EngineMajorUpdated;
-			}
+
+		Output::Debug("Engine configured as: 2k={} 2k3={} MajorUpdated={} Eng={}", Player::IsRPG2k(), Player::IsRPG2k3(), Player::IsMajorUpdatedVersion(), Player::IsEnglish());
+	});
+
+	auto rtp_paths_task = graph.Add("Find RTP paths", Affinity::Main, { engine_task }, [&]() {
+		if (no_rtp_flag) {
+			return;
 		}
-	}
 
-	Output::Debug("Engine configured as: 2k={} 2k3={} MajorUpdated={} Eng={}", Player::IsRPG2k(), Player::IsRPG2k3(), Player::IsMajorUpdatedVersion(), Player::IsEnglish());
+		rtp_candidates = FileFinder_RTP::FindSearchPaths(rtp_path);
+		rtp_version = Player::EngineVersion();
 
-	Main_Data::filefinder_rtp = std::make_unique<FileFinder_RTP>(no_rtp_flag, no_rtp_warning_flag, rtp_path);
+		// The directory trees of the shared filesystem are not thread-safe,
+		// the RTP is scanned in a private one that is handed over afterwards.
+		rtp_root = std::make_shared<RootFilesystem>();
+	});
 
-	if (!game_config.patch_override) {
-		if (!FileFinder::Game().FindFile("harmony.dll").empty()) {
-			game_config.patch_key_patch.Set(true);
+	auto rtp_scan_task = graph.Add("Scan RTP", Affinity::Worker, { rtp_paths_task }, [&]() {
+		for (StringView p : rtp_candidates) {
+			rtp_search_paths.push_back(FileFinder_RTP::DetectSearchPath(rtp_root->Subtree(""), p, rtp_version));
 		}
+	});
 
-		if (!FileFinder::Game().FindFile("dynloader.dll").empty()) {
-			game_config.patch_dynrpg.Set(true);
-			Output::Warning("This game uses DynRPG and will not run properly.");
-		}
+	graph.Add("Detect patches", Affinity::Main, { engine_task }, [&]() {
+		if (!game_config.patch_override) {
+			if (!FileFinder::Game().FindFile("harmony.dll").empty()) {
+				game_config.patch_key_patch.Set(true);
+			}
 
-		if (!FileFinder::Game().FindFile("accord.dll").empty()) {
-			game_config.patch_maniac.Set(true);
+			if (!FileFinder::Game().FindFile("dynloader.dll").empty()) {
+				game_config.patch_dynrpg.Set(true);
+				Output::Warning("This game uses DynRPG and will not run properly.");
+			}
+
+			if (!FileFinder::Game().FindFile("accord.dll").empty()) {
+				game_config.patch_maniac.Set(true);
+			}
 		}
-	}
 
-	Output::Debug("Patch configuration: dynrpg={} maniac={} key-patch={} common-this={} pic-unlock={} 2k3-commands={}",
-		Player::IsPatchDynRpg(), Player::IsPatchManiac(), Player::IsPatchKeyPatch(), game_config.patch_common_this_event.Get(), game_config.patch_unlock_pics.Get(), game_config.patch_rpg2k3_commands.Get());
+		Output::Debug("Patch configuration: dynrpg={} maniac={} key-patch={} common-this={} pic-unlock={} 2k3-commands={}",
+			Player::IsPatchDynRpg(), Player::IsPatchManiac(), Player::IsPatchKeyPatch(), game_config.patch_common_this_event.Get(), game_config.patch_unlock_pics.Get(), game_config.patch_rpg2k3_commands.Get());
+	});
 
-	ResetGameObjects();
+	graph.Add("Load fonts", Affinity::Main, { read_fonts_task }, [&]() {
+		ApplyFonts(font_files);
+	});
+
+	graph.Add("Apply RTP", Affinity::Main, { rtp_scan_task, ini_task }, [&]() {
+		Main_Data::filefinder_rtp = std::make_unique<FileFinder_RTP>(no_rtp_flag, no_rtp_warning_flag, std::move(rtp_search_paths));
+	});
 
-	LoadFonts();
+	graph.Run();
+
+	ResetGameObjects();
 
 	if (Player::IsPatchKeyPatch()) {
 		Main_Data::game_ineluki->ExecuteScriptList(FileFinder::Game().FindFile("autorun.script"));
 	}
+
+	graph.LogTimeline("Startup timeline");
+
+	const auto& rtp_entry = graph.GetTimeline()[rtp_scan_task];
+	Output::Debug("Startup: Game loaded in {:.1f} ms (RTP detection {:.1f} ms, asset index {})",
+		ms(Game_Clock::now() - startup_begin).count(), rtp_entry.end_ms - rtp_entry.begin_ms, game_config.asset_index.Get() ? "on" : "off");
 }
 
 bool Player::ChangeResolution(int width, int height) {
@@ -971,109 +1305,170 @@ void Player::GuessNonStandardExtensions() {
 	}
 }
 
-void Player::LoadDatabase() {
-	// Load lcf::Database
-	lcf::Data::Clear();
+namespace {
+DatabaseFiles OpenDatabase() {
+	DatabaseFiles files;
 
-	if (is_easyrpg_project) {
-		std::string edb = FileFinder::Game().FindFile(DATABASE_NAME_EASYRPG);
-		auto edb_stream = FileFinder::Game().OpenInputStream(edb, std::ios_base::in);
-		if (!edb_stream) {
-			Output::Error("Error loading {}", DATABASE_NAME_EASYRPG);
-			return;
-		}
+	if (Player::is_easyrpg_project) {
+		files.ldb_name = DATABASE_NAME_EASYRPG;
+		files.lmt_name = TREEMAP_NAME_EASYRPG;
 
-		auto db = lcf::LDB_Reader::LoadXml(edb_stream);
-		if (!db) {
-			Output::ErrorStr(lcf::LcfReader::GetError());
-			return;
-		} else {
-			lcf::Data::data = std::move(*db);
-		}
+		std::string edb = FileFinder::Game().FindFile(files.ldb_name);
+		files.ldb_stream = FileFinder::Game().OpenInputStream(edb, std::ios_base::in);
 
-		std::string emt = FileFinder::Game().FindFile(TREEMAP_NAME_EASYRPG);
-		auto emt_stream = FileFinder::Game().OpenInputStream(emt, std::ios_base::in);
-		if (!emt_stream) {
-			Output::Error("Error loading {}", TREEMAP_NAME_EASYRPG);
-			return;
-		}
-
-		auto treemap = lcf::LMT_Reader::LoadXml(emt_stream);
-		if (!treemap) {
-			Output::ErrorStr(lcf::LcfReader::GetError());
-		} else {
-			lcf::Data::treemap = std::move(*treemap);
-		}
+		std::string emt = FileFinder::Game().FindFile(files.lmt_name);
+		files.lmt_stream = FileFinder::Game().OpenInputStream(emt, std::ios_base::in);
 	} else {
 		// Retrieve the appropriately-renamed files.
-		std::string ldb_name = fileext_map.MakeFilename(RPG_RT_PREFIX, SUFFIX_LDB);
-		std::string ldb = FileFinder::Game().FindFile(ldb_name);
-		std::string lmt_name = fileext_map.MakeFilename(RPG_RT_PREFIX, SUFFIX_LMT);
-		std::string lmt = FileFinder::Game().FindFile(lmt_name);
+		files.ldb_name = Player::fileext_map.MakeFilename(RPG_RT_PREFIX, SUFFIX_LDB);
+		std::string ldb = FileFinder::Game().FindFile(files.ldb_name);
+		files.lmt_name = Player::fileext_map.MakeFilename(RPG_RT_PREFIX, SUFFIX_LMT);
+		std::string lmt = FileFinder::Game().FindFile(files.lmt_name);
 
-		auto ldb_stream = FileFinder::Game().OpenInputStream(ldb);
-		if (!ldb_stream) {
-			Output::Error("Error loading {}", ldb_name);
-			return;
-		}
+		files.ldb_stream = FileFinder::Game().OpenInputStream(ldb);
+		files.lmt_stream = FileFinder::Game().OpenInputStream(lmt);
+	}
 
-		auto db = lcf::LDB_Reader::Load(ldb_stream, encoding);
-		if (!db) {
-			Output::ErrorStr(lcf::LcfReader::GetError());
-			return;
-		} else {
-			lcf::Data::data = std::move(*db);
-		}
+	return files;
+}
 
-		auto lmt_stream = FileFinder::Game().OpenInputStream(lmt);
-		if (!lmt_stream) {
-			Output::Error("Error loading {}", lmt_name);
-			return;
-		}
+void ParseDatabase(DatabaseFiles& files) {
+	// LDB and LMT are parsed by the same task: The lcf reader reports errors
+	// through a global and is not safe to use from two threads at once.
+	if (!files.ldb_stream) {
+		return;
+	}
 
-		auto treemap = lcf::LMT_Reader::Load(lmt_stream, encoding);
-		if (!treemap) {
-			Output::ErrorStr(lcf::LcfReader::GetError());
-			return;
-		} else {
-			lcf::Data::treemap = std::move(*treemap);
-		}
+	MapCache::ParseLock lock;
 
-		if (Input::IsRecording()) {
-			ldb_stream.clear();
-			ldb_stream.seekg(0, std::ios::beg);
-			lmt_stream.clear();
-			lmt_stream.seekg(0, std::ios::beg);
-			Input::AddRecordingData(Input::RecordingData::Hash,
-									fmt::format("ldb {:#08x}", Utils::CRC32(ldb_stream)));
-			Input::AddRecordingData(Input::RecordingData::Hash,
-						   fmt::format("lmt {:#08x}", Utils::CRC32(lmt_stream)));
-		}
+	if (Player::is_easyrpg_project) {
+		files.db = lcf::LDB_Reader::LoadXml(files.ldb_stream);
+	} else {
+		files.db = lcf::LDB_Reader::Load(files.ldb_stream, Player::encoding);
+	}
+	if (!files.db) {
+		files.error = lcf::LcfReader::GetError();
+		return;
+	}
 
-		// Override map extension, if needed.
-		if (!DefaultLmuStartFileExists(FileFinder::Game())) {
-			FileExtGuesser::GuessAndAddLmuExtension(FileFinder::Game(), *meta, fileext_map);
-		}
+	if (!files.lmt_stream) {
+		return;
+	}
+
+	if (Player::is_easyrpg_project) {
+		files.treemap = lcf::LMT_Reader::LoadXml(files.lmt_stream);
+	} else {
+		files.treemap = lcf::LMT_Reader::Load(files.lmt_stream, Player::encoding);
+	}
+	if (!files.treemap) {
+		files.error = lcf::LcfReader::GetError();
 	}
 }
 
-void Player::LoadFonts() {
-	Font::ResetDefault();
+void ApplyDatabase(DatabaseFiles& files) {
+	lcf::Data::Clear();
+
+	if (!files.ldb_stream) {
+		Output::Error("Error loading {}", files.ldb_name);
+		return;
+	}
+
+	if (!files.db) {
+		Output::ErrorStr(files.error);
+		return;
+	}
+	lcf::Data::data = std::move(*files.db);
+
+	if (!files.lmt_stream) {
+		Output::Error("Error loading {}", files.lmt_name);
+		return;
+	}
+
+	if (!files.treemap) {
+		Output::ErrorStr(files.error);
+		return;
+	}
+	lcf::Data::treemap = std::move(*files.treemap);
+
+	if (Player::is_easyrpg_project) {
+		return;
+	}
+
+	if (Input::IsRecording()) {
+		files.ldb_stream.clear();
+		files.ldb_stream.seekg(0, std::ios::beg);
+		files.lmt_stream.clear();
+		files.lmt_stream.seekg(0, std::ios::beg);
+		Input::AddRecordingData(Input::RecordingData::Hash,
+								fmt::format("ldb {:#08x}", Utils::CRC32(files.ldb_stream)));
+		Input::AddRecordingData(Input::RecordingData::Hash,
+					   fmt::format("lmt {:#08x}", Utils::CRC32(files.lmt_stream)));
+	}
+
+	// Override map extension, if needed.
+	if (!DefaultLmuStartFileExists(FileFinder::Game())) {
+		FileExtGuesser::GuessAndAddLmuExtension(FileFinder::Game(), *Player::meta, Player::fileext_map);
+	}
+}
+
+} // anonymous namespace
+
+void Player::LoadDatabase() {
+	auto files = OpenDatabase();
+	ParseDatabase(files);
+	ApplyDatabase(files);
+}
+
+namespace {
+FontFiles OpenFonts() {
+	FontFiles files;
 
 #ifdef HAVE_FREETYPE
 	// Look for bundled fonts
-	auto gothic = FileFinder::OpenFont("Font");
-	if (gothic) {
-		Font::SetDefault(Font::CreateFtFont(std::move(gothic), 12, false, false), false);
+	files.gothic = FileFinder::OpenFont("Font");
+	files.mincho = FileFinder::OpenFont("Font2");
+#endif
+
+	return files;
+}
+
+void ReadFonts(FontFiles& files) {
+	auto read = [](Filesystem_Stream::InputStream& is) {
+		if (!is) {
+			return;
+		}
+		std::string name = ToString(is.GetName());
+		auto data = Utils::ReadStream(is);
+		is = Filesystem_Stream::InputStream(new Filesystem_Stream::InputMemoryStreamBuf(std::move(data)), std::move(name));
+	};
+
+	read(files.gothic);
+	read(files.mincho);
+}
+
+void ApplyFonts(FontFiles& files) {
+	Font::ResetDefault();
+
+#ifdef HAVE_FREETYPE
+	if (files.gothic) {
+		Font::SetDefault(Font::CreateFtFont(std::move(files.gothic), 12, false, false), false);
 	}
 
-	auto mincho = FileFinder::OpenFont("Font2");
-	if (mincho) {
-		Font::SetDefault(Font::CreateFtFont(std::move(mincho), 12, false, false), true);
+	if (files.mincho) {
+		Font::SetDefault(Font::CreateFtFont(std::move(files.mincho), 12, false, false), true);
 	}
+#else
+	(void)files;
 #endif
 }
 
+} // anonymous namespace
+
+void Player::LoadFonts() {
+	auto files = OpenFonts();
+	ApplyFonts(files);
+}
+
 static void OnMapSaveFileReady(FileRequestResult*, lcf::rpg::Save save) {
 	auto map = Game_Map::loadMapFile(Main_Data::game_player->GetMapId());
 	Game_Map::SetupFromSave(
@@ -1111,10 +1506,18 @@ void Player::LoadSavegame(const std::string& save_name, int save_id) {
 		return;
 	}
 
-	std::unique_ptr<lcf::rpg::Save> save = lcf::LSD_Reader::Load(save_stream, encoding);
+	std::unique_ptr<lcf::rpg::Save> save;
+	std::string error;
+	{
+		MapCache::ParseLock lock;
+		save = lcf::LSD_Reader::Load(save_stream, encoding);
+		if (!save) {
+			error = lcf::LcfReader::GetError();
+		}
+	}
 
 	if (!save.get()) {
-		Output::ErrorStr(lcf::LcfReader::GetError());
+		Output::ErrorStr(error);
 		return;
 	}
 
@@ -1280,7 +1683,11 @@ std::string Player::GetEncoding() {
 		std::string ldb = FileFinder::Game().FindFile(fileext_map.MakeFilename(RPG_RT_PREFIX, SUFFIX_LDB));
 		auto ldb_stream = FileFinder::Game().OpenInputStream(ldb);
 		if (ldb_stream) {
-			auto db = lcf::LDB_Reader::Load(ldb_stream);
+			std::unique_ptr<lcf::rpg::Database> db;
+			{
+				MapCache::ParseLock lock;
+				db = lcf::LDB_Reader::Load(ldb_stream);
+			}
 			if (db) {
 				std::vector<std::string> encodings = lcf::ReaderUtil::DetectEncodings(*db);
 
@@ -1392,6 +1799,8 @@ Engine options:
  --language LANG      Load the game translation in language/LANG folder.
  --load-game-id N     Skip the title scene and load SaveN.lsd (N is padded to
                       two digits).
+ --map-prefetch       Parse the maps reachable by teleports in the background.
+                      Disable with --no-map-prefetch.
  --new-game           Skip the title scene and start a new game directly.
  --no-log-color       Disable colors in terminal log.
  --no-rtp             Disable support for the Runtime Package (RTP).
@@ -1432,6 +1841,9 @@ Video options:
                        original   - 320x240 (4:3). Recommended
                        widescreen - 416x240 (16:9)
                        ultrawide  - 560x240 (21:9)
+ --retained-render    Only redraw the parts of the screen that changed. Reduces
+                      the CPU usage on static scenes like menus.
+                      Disable with --no-retained-render.
  --scaling S          How the video output is scaled.
                       Options:
                        nearest  - Scale to screen size. Fast, but causes scaling
@@ -1444,6 +1856,10 @@ Video options:
  --stretch            Ignore the aspect ratio and stretch video output to the
                       entire width of the screen.
                       Disable with --no-stretch.
+ --threaded-render    Present the screen while the next frames are simulated on
+                      a separate thread. Helps when fast forwarding or when
+                      presenting is slow (vsync). Adds one frame of latency.
+                      Disable with --no-threaded-render.
  --vsync              Enables vertical sync if supported on this platform.
                       Disable with --no-vsync.
  --window             Start in windowed mode.
@@ -1460,8 +1876,16 @@ Debug options:
                       Providing a single N sets the monster party.
                       Providing four N sets: monster party, formation,
                       condition and terrain ID.
+ --benchmark N        Run without window and audio as fast as possible for N
+                      logical frames and print frames per second, draw time
+                      and peak memory. Use with --load-game-id and
+                      --replay-input for reproducible measurements.
  --hide-title         Hide the title background image and center the command
                       menu.
+ --profile            Enable the frame profiler. The time spent per frame in
+                      the engine subsystems is shown below the FPS counter.
+ --profile-trace FILE Enable the frame profiler and write the last frames as a
+                      Chrome trace event file to FILE on exit.
  --start-map-id N     Overwrite the map used for new games and use MapN.lmu
                       instead (N is padded to four digits).
                       Incompatible with --load-game-id.
@@ -376,6 +376,9 @@ namespace Player {
 	/** Path to record input log to */
 	extern std::string record_input_path;
 
+	/** Path to write the profiler trace to on exit */
+	extern std::string profile_trace_path;
+
 	/** The concatenated command line */
 	extern std::string command_line;
 
@@ -16,6 +16,7 @@
  */
 
 // Headers
+#include <algorithm>
 #include "rect.h"
 
 void Rect::Adjust(int max_width, int max_height) {
@@ -127,3 +128,18 @@ bool Rect::AdjustRectangles(Rect& src, Rect& dst, const Rect& ref) {
 	return src.width > 0 && src.height > 0;
 }
 
+Rect Rect::GetUnion(const Rect& rect) const {
+	if (rect.IsEmpty()) {
+		return *this;
+	}
+	if (IsEmpty()) {
+		return rect;
+	}
+
+	int x1 = std::min(x, rect.x);
+	int y1 = std::min(y, rect.y);
+	int x2 = std::max(x + width, rect.x + rect.width);
+	int y2 = std::max(y + height, rect.y + rect.height);
+
+	return Rect(x1, y1, x2 - x1, y2 - y1);
+}
@@ -0,0 +1,120 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include <lcf/reader_lcf.h>
+#include "save_header.h"
+#include "map_cache.h"
+
+namespace {
+	/** Chunk of lcf::rpg::Save that holds the title */
+	constexpr int chunk_save_title = 0x64;
+
+	/** Chunks of lcf::rpg::SaveTitle */
+	enum TitleChunk {
+		timestamp = 0x01,
+		hero_name = 0x0B,
+		hero_level = 0x0C,
+		hero_hp = 0x0D,
+		face1_name = 0x15,
+		face1_id = 0x16,
+		face2_name = 0x17,
+		face2_id = 0x18,
+		face3_name = 0x19,
+		face3_id = 0x1A,
+		face4_name = 0x1B,
+		face4_id = 0x1C
+	};
+}
+
+std::unique_ptr<lcf::rpg::SaveTitle> SaveHeader::ReadTitle(std::istream& stream, std::string encoding) {
+	MapCache::ParseLock lock;
+	lcf::LcfReader reader(stream, std::move(encoding));
+
+	std::string header;
+	reader.ReadString(header, reader.ReadInt());
+	if (header != "LcfSaveData") {
+		return nullptr;
+	}
+
+	lcf::LcfReader::Chunk chunk;
+	chunk.ID = reader.ReadInt();
+	chunk.length = reader.ReadInt();
+	if (!reader.IsOk() || chunk.ID != chunk_save_title) {
+		return nullptr;
+	}
+
+	auto title = std::make_unique<lcf::rpg::SaveTitle>();
+	const uint32_t end = reader.Tell() + chunk.length;
+
+	while (reader.Tell() < end) {
+		chunk.ID = reader.ReadInt();
+		if (chunk.ID == 0) {
+			// End of struct
+			break;
+		}
+		chunk.length = reader.ReadInt();
+
+		switch (chunk.ID) {
+			case timestamp:
+				reader.Read(title->timestamp);
+				break;
+			case hero_name:
+				reader.ReadString(title->hero_name, chunk.length);
+				break;
+			case hero_level:
+				title->hero_level = reader.ReadInt();
+				break;
+			case hero_hp:
+				title->hero_hp = reader.ReadInt();
+				break;
+			case face1_name:
+				reader.ReadString(title->face1_name, chunk.length);
+				break;
+			case face1_id:
+				title->face1_id = reader.ReadInt();
+				break;
+			case face2_name:
+				reader.ReadString(title->face2_name, chunk.length);
+				break;
+			case face2_id:
+				title->face2_id = reader.ReadInt();
+				break;
+			case face3_name:
+				reader.ReadString(title->face3_name, chunk.length);
+				break;
+			case face3_id:
+				title->face3_id = reader.ReadInt();
+				break;
+			case face4_name:
+				reader.ReadString(title->face4_name, chunk.length);
+				break;
+			case face4_id:
+				title->face4_id = reader.ReadInt();
+				break;
+			default:
+				reader.Skip(chunk, "SaveHeader::ReadTitle");
+		}
+	}
+
+	// Reading stops early at the end of the file, this catches truncated titles
+	if (!reader.IsOk() || reader.Tell() != end) {
+		return nullptr;
+	}
+
+	return title;
+}
@@ -0,0 +1,46 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_SAVE_HEADER_H
+#define EP_SAVE_HEADER_H
+
+// Headers
+#include <istream>
+#include <memory>
+#include <string>
+#include <lcf/rpg/savetitle.h>
+
+/**
+ * Reads the title of a savegame without parsing the whole save.
+ *
+ * The title (timestamp, hero name, level, HP and faces) is the first chunk of
+ * a LSD file, this is all the file windows and the Maniac Patch GetSaveInfo
+ * command need. Reading stops after the title chunk, so a save that is damaged
+ * behind the title is not detected.
+ */
+namespace SaveHeader {
+	/**
+	 * Reads the title of a savegame.
+	 *
+	 * @param stream opened LSD file
+	 * @param encoding encoding of the LSD strings
+	 * @return title or nullptr when the file is not a savegame
+	 */
+	std::unique_ptr<lcf::rpg::SaveTitle> ReadTitle(std::istream& stream, std::string encoding);
+}
+
+#endif
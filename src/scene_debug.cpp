@@ -20,6 +20,7 @@
 #include <sstream>
 #include <cmath>
 #include <iomanip>
+#include "audio_secache.h"
 #include "baseui.h"
 #include "cache.h"
 #include "input.h"
@@ -66,6 +67,9 @@ void Scene_Debug::ResetPrevIndices() {
 }
 
 void Scene_Debug::Start() {
+	Cache::DumpStats();
+	AudioSeCache::DumpStats();
+
 	CreateRangeWindow();
 	CreateVarListWindow();
 	CreateNumberInputWindow();
@@ -25,14 +25,15 @@
 #include "game_system.h"
 #include "game_party.h"
 #include "input.h"
-#include <lcf/lsd/reader.h>
 #include "player.h"
+#include "save_header.h"
 #include "scene_file.h"
 #include "bitmap.h"
 #include <lcf/reader_util.h>
 #include "output.h"
 
 constexpr int arrow_animation_frames = 20;
+constexpr int visible_windows = 3;
 
 Scene_File::Scene_File(std::string message) :
 	message(message) {
@@ -71,14 +72,14 @@ void Scene_File::CreateHelpWindow() {
 	help_window->SetZ(Priority_Window + 1);
 }
 
-void Scene_File::PopulatePartyFaces(Window_SaveFile& win, int /* id */, lcf::rpg::Save& savegame) {
-	win.SetParty(savegame.title);
+void Scene_File::PopulatePartyFaces(Window_SaveFile& win, int /* id */, lcf::rpg::SaveTitle& title) {
+	win.SetParty(title);
 	win.SetHasSave(true);
 }
 
-void Scene_File::UpdateLatestTimestamp(int id, lcf::rpg::Save& savegame) {
-	if (savegame.title.timestamp > latest_time) {
-		latest_time = savegame.title.timestamp;
+void Scene_File::UpdateLatestTimestamp(int id, lcf::rpg::SaveTitle& title) {
+	if (title.timestamp > latest_time) {
+		latest_time = title.timestamp;
 		latest_slot = id;
 	}
 }
@@ -99,11 +100,12 @@ void Scene_File::PopulateSaveWindow(Window_SaveFile& win, int id) {
 			return;
 		}
 
-		std::unique_ptr<lcf::rpg::Save> savegame = lcf::LSD_Reader::Load(save_stream, Player::encoding);
+		// Only the title is needed, parsing the whole save is slow with many slots
+		std::unique_ptr<lcf::rpg::SaveTitle> title = SaveHeader::ReadTitle(save_stream, Player::encoding);
 
-		if (savegame) {
-			PopulatePartyFaces(win, id, *savegame);
-			UpdateLatestTimestamp(id, *savegame);
+		if (title) {
+			PopulatePartyFaces(win, id, *title);
+			UpdateLatestTimestamp(id, *title);
 		} else {
 			Output::Debug("Save {} corrupted", file);
 			win.SetCorrupted(true);
@@ -124,7 +126,6 @@ void Scene_File::Start() {
 		w->SetIndex(i);
 		w->SetZ(Priority_Window);
 		PopulateSaveWindow(*w, i);
-		w->Refresh();
 
 		file_windows.push_back(w);
 	}
@@ -149,7 +150,10 @@ void Scene_File::Refresh() {
 		Window_SaveFile *w = file_windows[i].get();
 		w->SetY(40 + (i - top_index) * 64);
 		w->SetActive(i == index);
-		w->Refresh();
+		// The other windows are drawn when they are scrolled into view
+		if (i >= top_index && i < top_index + visible_windows) {
+			w->Refresh();
+		}
 	}
 }
 
@@ -21,7 +21,7 @@
 // Headers
 #include <vector>
 #include "filefinder.h"
-#include <lcf/rpg/save.h>
+#include <lcf/rpg/savetitle.h>
 #include "scene.h"
 #include "window_help.h"
 #include "window_savefile.h"
@@ -53,11 +53,12 @@ public:
 protected:
 	virtual void CreateHelpWindow();
 	virtual void PopulateSaveWindow(Window_SaveFile& win, int id);
-	virtual void PopulatePartyFaces(Window_SaveFile& win, int id, lcf::rpg::Save& savegame);
-	virtual void UpdateLatestTimestamp(int id, lcf::rpg::Save& savegame);
+	virtual void PopulatePartyFaces(Window_SaveFile& win, int id, lcf::rpg::SaveTitle& title);
+	virtual void UpdateLatestTimestamp(int id, lcf::rpg::SaveTitle& title);
 	static std::unique_ptr<Sprite> MakeBorderSprite(int y);
 	static std::unique_ptr<Sprite> MakeArrowSprite(bool down);
 
+	/** Updates position and cursor of the windows and draws the visible ones */
 	void Refresh();
 	void MoveFileWindows(int dy, int dt);
 	void UpdateArrows();
@@ -20,9 +20,9 @@
 #include "filefinder.h"
 #include "game_system.h"
 #include "input.h"
-#include <lcf/lsd/reader.h>
 #include "output.h"
 #include "player.h"
+#include "save_header.h"
 #include "scene_file.h"
 #include "scene_import.h"
 
@@ -36,12 +36,15 @@ void Scene_Import::PopulateSaveWindow(Window_SaveFile& win, int id) {
 	if (id < static_cast<int>(files.size())) {
 		win.SetDisplayOverride(files[id].short_path, files[id].file_id);
 
-		std::unique_ptr<lcf::rpg::Save> savegame =
-			lcf::LSD_Reader::Load(files[id].full_path, Player::encoding);
+		std::unique_ptr<lcf::rpg::SaveTitle> title;
+		auto save_stream = FileFinder::Root().OpenInputStream(files[id].full_path);
+		if (save_stream) {
+			title = SaveHeader::ReadTitle(save_stream, Player::encoding);
+		}
 
-		if (savegame.get()) {
-			PopulatePartyFaces(win, id, *savegame);
-			UpdateLatestTimestamp(id, *savegame);
+		if (title) {
+			PopulatePartyFaces(win, id, *title);
+			UpdateLatestTimestamp(id, *title);
 		} else {
 			win.SetCorrupted(true);
 		}
@@ -18,6 +18,8 @@
 // Headers
 #include <sstream>
 #include "filefinder.h"
+#include "map_cache.h"
+#include <lcf/lsd/reader.h>
 #include "output.h"
 #include "player.h"
 #include "scene_load.h"
@@ -35,5 +37,26 @@ void Scene_Load::Action(int index) {
 }
 
 bool Scene_Load::IsSlotValid(int index) {
-	return file_windows[index]->IsValid();
+	auto& win = *file_windows[index];
+	if (!win.IsValid()) {
+		return false;
+	}
+
+	// The window only read the title, check that the rest of the save is readable
+	// instead of failing in Player::LoadSavegame
+	std::string file = fs.FindFile(fmt::format("Save{:02d}.lsd", index + 1));
+	auto save_stream = FileFinder::Save().OpenInputStream(file);
+	bool readable = false;
+	if (save_stream) {
+		MapCache::ParseLock lock;
+		readable = lcf::LSD_Reader::Load(save_stream, Player::encoding) != nullptr;
+	}
+	if (!readable) {
+		Output::Debug("Save {} corrupted", file);
+		win.SetCorrupted(true);
+		win.Refresh();
+		return false;
+	}
+
+	return true;
 }
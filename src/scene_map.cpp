@@ -314,6 +314,13 @@ void Scene_Map::StartPendingTeleport(TeleportParams tp) {
 		transition.InitErase(Main_Data::game_system->GetTransition(Main_Data::game_system->Transition_TeleportErase), this);
 	}
 
+	// Decode the graphics of the destination while the screen is erased,
+	// FinishPendingTeleport loads anything that was not prefetched
+	auto map_id = Main_Data::game_player->GetTeleportTarget().GetMapId();
+	if (map_id != Game_Map::GetMapId()) {
+		Spriteset_Map::Prefetch(map_id);
+	}
+
 	AsyncNext([=]() { FinishPendingTeleport(tp); });
 }
 
@@ -322,6 +329,7 @@ void Scene_Map::FinishPendingTeleport(TeleportParams tp) {
 	Main_Data::game_player->PerformTeleport();
 
 	if (Game_Map::GetMapId() != old_map_id) {
+		Spriteset_Map::Prefetch();
 		spriteset->Refresh();
 	}
 	FinishPendingTeleport2(MapUpdateAsyncContext(), tp);
@@ -54,8 +54,9 @@ void Scene_Save::Start() {
 
 	for (int i = 0; i < Utils::Clamp<int32_t>(lcf::Data::system.easyrpg_max_savefiles, 3, 99); i++) {
 		file_windows[i]->SetHasSave(true);
-		file_windows[i]->Refresh();
 	}
+
+	Refresh();
 }
 
 void Scene_Save::Action(int index) {
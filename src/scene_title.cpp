@@ -50,6 +50,7 @@ Scene_Title::Scene_Title() {
 
 void Scene_Title::Start() {
 	Main_Data::game_system->ResetSystemGraphic();
+	Main_Data::game_system->PreloadSystemSe();
 
 	// Change the resolution of the window
 	if (Player::has_custom_resolution) {
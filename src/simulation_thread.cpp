@@ -0,0 +1,177 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include <utility>
+#include <vector>
+#include "simulation_thread.h"
+
+#ifdef HAVE_THREADS
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace {
+	SimulationThread::Step batch;
+	int batch_frames = 0;
+	std::string batch_error;
+
+	std::vector<std::function<void()>> main_thread_queue;
+
+	/** Thrown by Abort to unwind the running step */
+	struct BatchAborted {
+		std::string err;
+	};
+
+	int RunBatch() {
+		int frames = 0;
+		try {
+			while (batch()) {
+				++frames;
+			}
+		} catch (BatchAborted& e) {
+			batch_error = std::move(e.err);
+		}
+		batch = nullptr;
+		return frames;
+	}
+
+#ifdef HAVE_THREADS
+	std::thread thread;
+	std::mutex mutex;
+	std::condition_variable cv;
+	bool pending = false;
+	bool stop = false;
+
+	void ThreadFunction() {
+		std::unique_lock<std::mutex> lock(mutex);
+
+		while (true) {
+			cv.wait(lock, []() { return stop || pending; });
+
+			if (!pending) {
+				return;
+			}
+
+			lock.unlock();
+			int frames = RunBatch();
+			lock.lock();
+
+			batch_frames = frames;
+			pending = false;
+			cv.notify_all();
+		}
+	}
+#endif
+}
+
+void SimulationThread::Init() {
+#ifdef HAVE_THREADS
+	if (thread.joinable()) {
+		return;
+	}
+
+	stop = false;
+	thread = std::thread(ThreadFunction);
+#endif
+}
+
+void SimulationThread::Quit() {
+#ifdef HAVE_THREADS
+	if (!thread.joinable()) {
+		return;
+	}
+
+	Wait();
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stop = true;
+	}
+	cv.notify_all();
+	thread.join();
+#endif
+}
+
+bool SimulationThread::IsRunning() {
+#ifdef HAVE_THREADS
+	return thread.joinable();
+#else
+	return false;
+#endif
+}
+
+bool SimulationThread::IsCurrentThread() {
+#ifdef HAVE_THREADS
+	return thread.joinable() && std::this_thread::get_id() == thread.get_id();
+#else
+	return false;
+#endif
+}
+
+void SimulationThread::Run(Step step) {
+#ifdef HAVE_THREADS
+	if (thread.joinable()) {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			batch = std::move(step);
+			batch_frames = 0;
+			pending = true;
+		}
+		cv.notify_all();
+		return;
+	}
+#endif
+
+	batch = std::move(step);
+	batch_frames = RunBatch();
+}
+
+int SimulationThread::Wait() {
+#ifdef HAVE_THREADS
+	if (thread.joinable()) {
+		std::unique_lock<std::mutex> lock(mutex);
+		cv.wait(lock, []() { return !pending; });
+	}
+#endif
+
+	// The simulation thread is idle, the queue cannot change anymore
+	auto queue = std::move(main_thread_queue);
+	main_thread_queue.clear();
+	for (auto& fn : queue) {
+		fn();
+	}
+
+	return std::exchange(batch_frames, 0);
+}
+
+void SimulationThread::RunOnMainThread(std::function<void()> fn) {
+	if (IsCurrentThread()) {
+		main_thread_queue.push_back(std::move(fn));
+		return;
+	}
+
+	fn();
+}
+
+void SimulationThread::Abort(std::string err) {
+	throw BatchAborted { std::move(err) };
+}
+
+std::string SimulationThread::TakeError() {
+	return std::exchange(batch_error, {});
+}
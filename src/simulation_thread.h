@@ -0,0 +1,103 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_SIMULATION_THREAD_H
+#define EP_SIMULATION_THREAD_H
+
+// Headers
+#include <functional>
+#include <string>
+
+/**
+ * Runs batches of logical frames on a separate thread while the main thread
+ * presents the previously drawn frame.
+ *
+ * The handoff is strict: between Run and Wait only the simulation thread
+ * accesses game state, scenes and drawables. The main thread only presents the
+ * display surface in this time. This keeps the game logic deterministic,
+ * the frames are executed in the same order as without the thread.
+ *
+ * Fatal errors raised by the simulation thread (Output::Error) are captured
+ * and must be raised again by the main thread after Wait, as only the main
+ * thread may access the window and the log.
+ *
+ * On platforms without thread support (HAVE_THREADS not defined) the batch
+ * is executed by Run on the calling thread.
+ */
+namespace SimulationThread {
+	/**
+	 * Executes one logical frame.
+	 *
+	 * @return false when the batch must stop, the remaining frames are then
+	 *         executed by the main thread after Wait.
+	 */
+	using Step = std::function<bool()>;
+
+	/** Starts the thread */
+	void Init();
+
+	/** Waits for the running batch and stops the thread */
+	void Quit();
+
+	/** @return whether the thread was started */
+	bool IsRunning();
+
+	/** @return whether the caller is the simulation thread */
+	bool IsCurrentThread();
+
+	/**
+	 * Hands a batch of logical frames to the simulation thread.
+	 * step is invoked until it returns false.
+	 *
+	 * @param step callback executing one logical frame
+	 */
+	void Run(Step step);
+
+	/**
+	 * Blocks until the batch passed to Run finished and executes the
+	 * functions queued by RunOnMainThread.
+	 *
+	 * @return number of logical frames executed by the batch
+	 */
+	int Wait();
+
+	/**
+	 * Executes a function that must run on the main thread (e.g. because it
+	 * accesses the window). When called by the simulation thread the function
+	 * is deferred until the next Wait, otherwise it is executed immediately.
+	 *
+	 * @param fn function to execute
+	 */
+	void RunOnMainThread(std::function<void()> fn);
+
+	/**
+	 * Stops the running batch because of a fatal error. The batch is unwound
+	 * and the message is returned by the next TakeError.
+	 * Must only be called from inside a step.
+	 *
+	 * @param err error message
+	 */
+	[[noreturn]] void Abort(std::string err);
+
+	/**
+	 * @return error passed to Abort by the last batch or an empty string when
+	 *         the batch finished normally. The error is cleared.
+	 */
+	std::string TakeError();
+}
+
+#endif
@@ -16,6 +16,7 @@
  */
 
 // Headers
+#include <cmath>
 #include <string>
 #include "sprite.h"
 #include "player.h"
@@ -23,6 +24,7 @@
 #include "bitmap.h"
 #include "cache.h"
 #include "drawable_mgr.h"
+#include "transform.h"
 
 // Constructor
 Sprite::Sprite(Drawable::Flags flags) : Drawable(0, flags)
@@ -37,6 +39,56 @@ void Sprite::Draw(Bitmap& dst) {
 	BlitScreen(dst);
 }
 
+bool Sprite::GetDamage(Rect& damage) {
+	DamageState state;
+	Rect bounds;
+
+	if (IsVisible() && bitmap && GetWidth() > 0 && GetHeight() > 0 &&
+			(opacity_top_effect > 0 || opacity_bottom_effect > 0)) {
+		state = { bitmap.get(), bitmap->GetRevision(), src_rect, src_rect_effect,
+			opacity_top_effect, opacity_bottom_effect, bush_effect, tone_effect,
+			zoom_x_effect, zoom_y_effect, angle_effect, blend_type_effect, blend_color_effect,
+			waver_effect_depth, waver_effect_phase, flash_effect, flipx_effect, flipy_effect };
+
+		if (zoom_x_effect == 1.0 && zoom_y_effect == 1.0 && angle_effect == 0.0 && waver_effect_depth == 0) {
+			bounds = Rect(x - ox + GetRenderOx(), y - oy + GetRenderOy(), GetWidth(), GetHeight());
+		} else {
+			bounds = GetTransformedBounds();
+		}
+	}
+
+	damage = UpdateDamage(damage_state, state, damage_bounds, bounds);
+	return true;
+}
+
+Rect Sprite::GetTransformedBounds() const {
+	// Same transformation as Bitmap::EffectsBlit
+	const int render_ox = ox - GetRenderOx();
+	const int render_oy = oy - GetRenderOy();
+	const int width = static_cast<int>(std::floor(GetWidth() * zoom_x_effect));
+	const int height = static_cast<int>(std::floor(GetHeight() * zoom_y_effect));
+
+	if (waver_effect_depth != 0) {
+		// Every line is shifted by up to this amount in both directions
+		const int offset = static_cast<int>(std::ceil(2 * std::abs(zoom_x_effect * waver_effect_depth)));
+		return Rect(static_cast<int>(x - render_ox * zoom_x_effect) - offset,
+			static_cast<int>(y - render_oy * zoom_y_effect),
+			width + 2 * offset, height);
+	}
+
+	if (angle_effect != 0.0) {
+		Transform fwd = Transform::Translation(x, y);
+		fwd *= Transform::Rotation(angle_effect);
+		fwd *= Transform::Scale(zoom_x_effect, zoom_y_effect);
+		fwd *= Transform::Translation(-render_ox, -render_oy);
+		return Bitmap::TransformRectangle(fwd, Rect(0, 0, GetWidth(), GetHeight()));
+	}
+
+	return Rect(x - static_cast<int>(std::floor(render_ox * zoom_x_effect)),
+		y - static_cast<int>(std::floor(render_oy * zoom_y_effect)),
+		width, height);
+}
+
 void Sprite::BlitScreen(Bitmap& dst) {
 	if (!bitmap || (opacity_top_effect <= 0 && opacity_bottom_effect <= 0))
 		return;
@@ -49,6 +101,18 @@ void Sprite::BlitScreen(Bitmap& dst) {
 	bitmap_changed = false;
 
 	Rect rect = src_rect_effect.GetSubRect(src_rect);
+	if (draw_effects_direct) {
+		// Same pixels as the subrect of bitmap_effects below
+		rect.x = bitmap_effects_src_rect.x + rect.x % bitmap_effects_src_rect.width;
+		rect.y = bitmap_effects_src_rect.y + rect.y % bitmap_effects_src_rect.height;
+
+		dst.EffectsToneBlit(x - ox + GetRenderOx(), y - oy + GetRenderOy(), *bitmap, rect,
+			current_tone, current_flash, current_flip_x, current_flip_y,
+			Opacity(opacity_top_effect, opacity_bottom_effect, bush_effect),
+			static_cast<Bitmap::BlendMode>(blend_type_effect), bitmap_scratch);
+		return;
+	}
+
 	if (draw_bitmap == bitmap_effects) {
 		// When a "sprite rect" (src_rect_effect) is used bitmap_effects
 		// only has the size of this subrect instead of the whole bitmap
@@ -79,7 +143,10 @@ void Sprite::BlitScreenIntern(Bitmap& dst, Bitmap const& draw_bitmap, Rect const
 }
 
 BitmapRef Sprite::Refresh(Rect& rect) {
-	if (zoom_x_effect == 1.0 && zoom_y_effect == 1.0 && angle_effect == 0.0 && waver_effect_depth == 0) {
+	draw_effects_direct = false;
+
+	const bool transformed = zoom_x_effect != 1.0 || zoom_y_effect != 1.0 || angle_effect != 0.0 || waver_effect_depth != 0;
+	if (!transformed) {
 		// Prevent effect sprite creation when not in the viewport
 		// TODO: Out of bounds math adjustments for zoom, angle and waver
 		// but even without this will catch most of the cases
@@ -100,7 +167,9 @@ BitmapRef Sprite::Refresh(Rect& rect) {
 		flipy_effect != current_flip_y;
 	bool effects_rect_changed = rect != bitmap_effects_src_rect;
 
-	if (no_effects || effects_changed || effects_rect_changed || bitmap_changed) {
+	bool outdated = effects_changed || effects_rect_changed || bitmap_changed;
+
+	if (no_effects || outdated) {
 		bitmap_effects.reset();
 	}
 
@@ -113,9 +182,16 @@ BitmapRef Sprite::Refresh(Rect& rect) {
 		current_flash = flash_effect;
 		current_flip_x = flipx_effect;
 		current_flip_y = flipy_effect;
+		bitmap_effects_src_rect = rect;
+
+		if (outdated && !transformed) {
+			// The effects changed since the last frame (e.g. a tone animation).
+			// Apply them while drawing, the effect bitmap is only created when they stay the same.
+			draw_effects_direct = true;
+			return bitmap;
+		}
 
 		bitmap_effects = Cache::SpriteEffect(bitmap, rect, flipx_effect, flipy_effect, current_tone, current_flash);
-		bitmap_effects_src_rect = rect;
 
 		return bitmap_effects;
 	}
@@ -19,6 +19,7 @@
 #define EP_SPRITE_H
 
 // Headers
+#include <tuple>
 #include "color.h"
 #include "drawable.h"
 #include "memory_management.h"
@@ -34,6 +35,8 @@ public:
 
 	void Draw(Bitmap& dst) override;
 
+	bool GetDamage(Rect& damage) override;
+
 	virtual int GetWidth() const;
 	virtual int GetHeight() const;
 
@@ -127,6 +130,8 @@ private:
 	Color flash_effect;
 
 	BitmapRef bitmap_effects;
+	/** Reused for drawing effects that change every frame, see Bitmap::EffectsToneBlit */
+	BitmapRef bitmap_scratch;
 
 	Rect bitmap_effects_src_rect;
 
@@ -137,6 +142,45 @@ private:
 	bool current_flip_x = false;
 	bool current_flip_y = false;
 	bool bitmap_changed = true;
+	/** Effects are applied while drawing instead of using bitmap_effects */
+	bool draw_effects_direct = false;
+
+	/** Everything that affects the output of Draw, for damage tracking */
+	struct DamageState {
+		const Bitmap* bitmap = nullptr;
+		uint32_t revision = 0;
+		Rect src_rect;
+		Rect src_rect_effect;
+		int opacity_top = 0;
+		int opacity_bottom = 0;
+		int bush = 0;
+		Tone tone;
+		double zoom_x = 1.0;
+		double zoom_y = 1.0;
+		double angle = 0.0;
+		int blend_type = 0;
+		Color blend_color;
+		int waver_depth = 0;
+		double waver_phase = 0.0;
+		Color flash;
+		bool flip_x = false;
+		bool flip_y = false;
+
+		auto Tie() const {
+			return std::tie(bitmap, revision, src_rect, src_rect_effect, opacity_top, opacity_bottom, bush, tone,
+				zoom_x, zoom_y, angle, blend_type, blend_color, waver_depth, waver_phase, flash, flip_x, flip_y);
+		}
+
+		bool operator==(const DamageState& other) const {
+			return Tie() == other.Tie();
+		}
+	};
+
+	DamageState damage_state;
+	Rect damage_bounds;
+
+	/** @return screen area drawn by a zoomed, rotated or wavering sprite */
+	Rect GetTransformedBounds() const;
 
 	void BlitScreen(Bitmap& dst);
 	void BlitScreenIntern(Bitmap& dst, Bitmap const& draw_bitmap,
@@ -32,6 +32,10 @@ Sprite_Battler::Sprite_Battler(Game_Battler* battler, int index) :
 Sprite_Battler::~Sprite_Battler() {
 }
 
+bool Sprite_Battler::GetDamage(Rect&) {
+	return false;
+}
+
 void Sprite_Battler::ResetZ() {
 	static_assert(Game_Battler::Type_Ally < Game_Battler::Type_Enemy, "Game_Battler enums re-ordered! Fix Z order logic here!");
 
@@ -40,6 +40,9 @@ public:
 
 	~Sprite_Battler() override;
 
+	/** The drawing state is calculated in Draw, damage is not tracked */
+	bool GetDamage(Rect& damage) override;
+
 	Game_Battler* GetBattler() const;
 
 	void SetBattler(Game_Battler* new_battler);
@@ -59,6 +59,10 @@ void Sprite_Picture::OnPictureShow() {
 }
 
 
+bool Sprite_Picture::GetDamage(Rect&) {
+	return false;
+}
+
 void Sprite_Picture::Draw(Bitmap& dst) {
 	const auto& pic = Main_Data::game_pictures->GetPicture(pic_id);
 	const auto& data = pic.data;
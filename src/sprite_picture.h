@@ -36,6 +36,9 @@ public:
 
 	void Draw(Bitmap& dst) override;
 
+	/** The drawing state is calculated in Draw, damage is not tracked */
+	bool GetDamage(Rect& damage) override;
+
 	void OnPictureShow();
 
 	/** @return Width of a single spritesheet frame or the entire width if the picture has no spritesheet */
@@ -60,6 +60,10 @@ Sprite_Timer::Sprite_Timer(int which) :
 Sprite_Timer::~Sprite_Timer() {
 }
 
+bool Sprite_Timer::GetDamage(Rect&) {
+	return false;
+}
+
 void Sprite_Timer::Draw(Bitmap& dst) {
 	if (!Main_Data::game_party->GetTimerVisible(which, Game_Battle::IsBattleRunning())) {
 		return;
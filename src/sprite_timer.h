@@ -38,6 +38,9 @@ public:
 protected:
 	void Draw(Bitmap& dst) override;
 
+	/** The drawing state is calculated in Draw, damage is not tracked */
+	bool GetDamage(Rect& damage) override;
+
 	int which = 0;
 
 	Rect digits[5];
@@ -128,6 +128,10 @@ void Sprite_Weapon::OnBattleWeaponReady(FileRequestResult* result, int32_t weapo
 	SetSrcRect(Rect(0, weapon_index * 64, 64, 64));
 }
 
+bool Sprite_Weapon::GetDamage(Rect&) {
+	return false;
+}
+
 void Sprite_Weapon::Draw(Bitmap& dst) {
 	if (!attacking) {
 		return;
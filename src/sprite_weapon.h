@@ -54,6 +54,9 @@ public:
 
 	void Draw(Bitmap& dst) override;
 
+	/** The drawing state is calculated in Draw, damage is not tracked */
+	bool GetDamage(Rect& damage) override;
+
 protected:
 	void CreateSprite();
 	void OnBattleWeaponReady(FileRequestResult* result, int32_t weapon_index);
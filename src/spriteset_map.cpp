@@ -21,6 +21,7 @@
 #include "dynrpg.h"
 #include "game_map.h"
 #include "main_data.h"
+#include "map_cache.h"
 #include "sprite_airshipshadow.h"
 #include "sprite_character.h"
 #include "game_character.h"
@@ -30,8 +31,12 @@
 #include "bitmap.h"
 #include "player.h"
 #include "drawable_list.h"
+#include <lcf/data.h>
+#include <lcf/reader_util.h>
 
 Spriteset_Map::Spriteset_Map() {
+	Prefetch();
+
 	panorama = std::make_unique<Plane>();
 	panorama->SetZ(Priority_Background);
 
@@ -81,6 +86,40 @@ void Spriteset_Map::Refresh() {
 	}
 }
 
+void Spriteset_Map::Prefetch() {
+	Cache::Prefetch(Cache::Material::Chipset, Game_Map::GetChipsetName());
+	Cache::Prefetch(Cache::Material::Panorama, Game_Map::Parallax::GetName());
+
+	for (Game_Event& ev : Game_Map::GetEvents()) {
+		Cache::Prefetch(Cache::Material::Charset, ev.GetSpriteName());
+	}
+
+	Cache::Prefetch(Cache::Material::Charset, Main_Data::game_player->GetSpriteName());
+}
+
+void Spriteset_Map::Prefetch(int map_id) {
+	auto map = MapCache::Peek(map_id);
+	if (!map) {
+		return;
+	}
+
+	auto* chipset = lcf::ReaderUtil::GetElement(lcf::Data::chipsets, map->chipset_id);
+	if (chipset) {
+		Cache::Prefetch(Cache::Material::Chipset, chipset->chipset_name);
+	}
+
+	if (map->parallax_flag) {
+		Cache::Prefetch(Cache::Material::Panorama, map->parallax_name);
+	}
+
+	// The active pages are unknown until the map is loaded
+	for (const auto& ev : map->events) {
+		for (const auto& page : ev.pages) {
+			Cache::Prefetch(Cache::Material::Charset, page.character_name);
+		}
+	}
+}
+
 // Update
 void Spriteset_Map::Update() {
 	Tone new_tone = Main_Data::game_screen->GetTone();
@@ -46,6 +46,23 @@ public:
 
 	void Update();
 
+	/**
+	 * Starts decoding the chipset, panorama and charsets of the current map
+	 * in the background. Call this after a new map was loaded and before
+	 * the sprites are created.
+	 */
+	static void Prefetch();
+
+	/**
+	 * Starts decoding the chipset, panorama and charsets of a map that is
+	 * about to be entered, e.g. while the screen is erased by a teleport.
+	 * Only done when the map is already in the MapCache, a map is never
+	 * parsed for this.
+	 *
+	 * @param map_id id of the map
+	 */
+	static void Prefetch(int map_id);
+
 	/**
 	 * Notifies that the map's chipset has changed.
 	 */
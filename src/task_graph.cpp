@@ -0,0 +1,149 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include <cassert>
+#include "task_graph.h"
+#include "instrumentation.h"
+#include "output.h"
+
+namespace {
+	using clock_type = std::chrono::steady_clock;
+	using ms = std::chrono::duration<double, std::milli>;
+}
+
+TaskGraph::TaskGraph(WorkerPool& pool) : pool(pool) {
+}
+
+TaskGraph::TaskId TaskGraph::Add(const char* name, Affinity affinity, std::initializer_list<TaskId> deps, Task task) {
+	const TaskId id = static_cast<TaskId>(nodes.size());
+
+	nodes.push_back({ name, affinity, std::move(task), {}, static_cast<int>(deps.size()), 0 });
+	for (TaskId dep : deps) {
+		assert(dep >= 0 && dep < id && "Dependency must be added before the task");
+		nodes[dep].dependents.push_back(id);
+	}
+
+	return id;
+}
+
+void TaskGraph::Run() {
+	const int total = static_cast<int>(nodes.size());
+
+	run_begin = clock_type::now();
+	timeline.assign(nodes.size(), TimelineEntry());
+	main_queue.clear();
+	finished = 0;
+
+	std::vector<TaskId> ready;
+	for (TaskId id = 0; id < total; ++id) {
+		nodes[id].pending = nodes[id].num_deps;
+		if (nodes[id].pending == 0) {
+			ready.push_back(id);
+		}
+	}
+	Dispatch(ready);
+
+#ifdef HAVE_THREADS
+	std::unique_lock<std::mutex> lock(mutex);
+	while (finished < total) {
+		cv.wait(lock, [&]() { return finished == total || !main_queue.empty(); });
+
+		while (!main_queue.empty()) {
+			TaskId id = main_queue.front();
+			main_queue.pop_front();
+
+			lock.unlock();
+			Execute(id);
+			lock.lock();
+		}
+	}
+#else
+	// Worker tasks were already executed by Dispatch
+	while (!main_queue.empty()) {
+		TaskId id = main_queue.front();
+		main_queue.pop_front();
+		Execute(id);
+	}
+	assert(finished == total);
+#endif
+
+	duration_ms = ms(clock_type::now() - run_begin).count();
+}
+
+void TaskGraph::Dispatch(const std::vector<TaskId>& ready) {
+	for (TaskId id : ready) {
+		if (nodes[id].affinity == Affinity::Worker) {
+			pool.Push([this, id]() { Execute(id); });
+		} else {
+#ifdef HAVE_THREADS
+			std::lock_guard<std::mutex> lock(mutex);
+			main_queue.push_back(id);
+			cv.notify_all();
+#else
+			main_queue.push_back(id);
+#endif
+		}
+	}
+}
+
+void TaskGraph::Execute(TaskId id) {
+	auto& node = nodes[id];
+
+	const auto begin = clock_type::now();
+	{
+		Instrumentation::Zone zone(node.name);
+		node.task();
+	}
+	const auto end = clock_type::now();
+
+	// Every task writes only its own entry, Run reads them after all tasks finished
+	timeline[id] = { node.name, node.affinity, ms(begin - run_begin).count(), ms(end - run_begin).count() };
+
+	std::vector<TaskId> ready;
+	{
+#ifdef HAVE_THREADS
+		std::lock_guard<std::mutex> lock(mutex);
+#endif
+		for (TaskId dep : node.dependents) {
+			if (--nodes[dep].pending == 0) {
+				ready.push_back(dep);
+			}
+		}
+
+		++finished;
+#ifdef HAVE_THREADS
+		// Notify while locked: Run can return (and destroy the graph) as soon as the lock is released
+		if (finished == static_cast<int>(nodes.size())) {
+			cv.notify_all();
+		}
+#endif
+	}
+
+	if (!ready.empty()) {
+		Dispatch(ready);
+	}
+}
+
+void TaskGraph::LogTimeline(StringView title) const {
+	Output::Debug("{}: {} tasks in {:.1f} ms ({} worker threads)", title, timeline.size(), duration_ms, pool.GetThreadCount());
+
+	for (const auto& entry : timeline) {
+		Output::Debug("  {:7.1f} - {:7.1f} ms {} ({})", entry.begin_ms, entry.end_ms, entry.name,
+			entry.affinity == Affinity::Main ? "main" : "worker");
+	}
+}
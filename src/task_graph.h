@@ -0,0 +1,142 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_TASK_GRAPH_H
+#define EP_TASK_GRAPH_H
+
+// Headers
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <vector>
+#include "string_view.h"
+#include "worker_pool.h"
+
+#ifdef HAVE_THREADS
+#include <condition_variable>
+#include <mutex>
+#endif
+
+/**
+ * Executes a set of named tasks with dependencies between them.
+ *
+ * Worker tasks are pushed to a WorkerPool as soon as all their dependencies
+ * finished, main tasks are executed by the thread calling Run. This allows
+ * mixing work that must stay on the main thread (filesystem caches, game
+ * state) with work that can run in the background (parsing, decoding).
+ *
+ * The start and end time of every task is recorded for a timeline.
+ * Without thread support all tasks run on the calling thread in dependency order.
+ */
+class TaskGraph {
+public:
+	using TaskId = int;
+	using Task = std::function<void()>;
+
+	/** Thread a task is executed on */
+	enum class Affinity {
+		Worker,
+		Main
+	};
+
+	/** Execution time of a task, relative to the start of Run */
+	struct TimelineEntry {
+		const char* name = nullptr;
+		Affinity affinity = Affinity::Worker;
+		double begin_ms = 0.0;
+		double end_ms = 0.0;
+	};
+
+	/**
+	 * Creates an empty graph.
+	 *
+	 * @param pool pool executing the worker tasks
+	 */
+	explicit TaskGraph(WorkerPool& pool = WorkerPool::Shared());
+
+	TaskGraph(const TaskGraph&) = delete;
+	TaskGraph& operator=(const TaskGraph&) = delete;
+
+	/**
+	 * Adds a task to the graph.
+	 * Dependencies must be tasks that were added before, this prevents cycles.
+	 *
+	 * @param name name of the task, must be a string literal
+	 * @param affinity thread the task is executed on
+	 * @param deps tasks that must finish before this task starts
+	 * @param task function to execute
+	 * @return id of the task
+	 */
+	TaskId Add(const char* name, Affinity affinity, std::initializer_list<TaskId> deps, Task task);
+
+	/**
+	 * Executes all tasks and blocks until they finished.
+	 * Main tasks are executed by the calling thread while waiting.
+	 */
+	void Run();
+
+	/** @return timeline of the last Run, indexed by TaskId */
+	const std::vector<TimelineEntry>& GetTimeline() const;
+
+	/** @return duration of the last Run in milliseconds */
+	double GetDuration() const;
+
+	/**
+	 * Writes the timeline of the last Run to the debug log.
+	 *
+	 * @param title headline of the log
+	 */
+	void LogTimeline(StringView title) const;
+
+private:
+	struct Node {
+		const char* name;
+		Affinity affinity;
+		Task task;
+		std::vector<TaskId> dependents;
+		int num_deps = 0;
+		int pending = 0;
+	};
+
+	void Dispatch(const std::vector<TaskId>& ready);
+	void Execute(TaskId id);
+
+	WorkerPool& pool;
+	std::vector<Node> nodes;
+	std::vector<TimelineEntry> timeline;
+	std::chrono::steady_clock::time_point run_begin;
+	double duration_ms = 0.0;
+
+	/** ready main tasks */
+	std::deque<TaskId> main_queue;
+	int finished = 0;
+#ifdef HAVE_THREADS
+	std::mutex mutex;
+	std::condition_variable cv;
+#endif
+};
+
+inline const std::vector<TaskGraph::TimelineEntry>& TaskGraph::GetTimeline() const {
+	return timeline;
+}
+
+inline double TaskGraph::GetDuration() const {
+	return duration_ms;
+}
+
+#endif
@@ -16,6 +16,7 @@
  */
 
 // Headers
+#include <algorithm>
 #include <cstring>
 #include <cmath>
 #include "tilemap_layer.h"
@@ -205,6 +206,93 @@ static uint32_t MakeAbTileHash(int id, int anim_step) {
 	return static_cast<uint32_t>((id + (anim_step << 12)) | (4 << 24));
 }
 
+void TilemapLayer::DrawMapTile(Bitmap& dst, const TileData& tile, int x, int y, int animation_step_ab, int animation_step_c) {
+	if (layer == 0) {
+		// If lower layer
+		bool allow_fast_blit = (tile.z == TileBelow);
+
+		if (tile.ID >= BLOCK_E && tile.ID < BLOCK_E + BLOCK_E_TILES) {
+			int id = substitutions[tile.ID - BLOCK_E];
+			// If Block E
+
+			int row, col;
+
+			// Get the tile coordinates from chipset
+			if (id < 96) {
+				// If from first column of the block
+				col = 12 + id % 6;
+				row = id / 6;
+			} else {
+				// If from second column of the block
+				col = 18 + (id - 96) % 6;
+				row = (id - 96) / 6;
+			}
+
+			auto tone_hash = MakeETileHash(id);
+			DrawTile(dst, *chipset, *chipset_effect, x, y, row, col, tone_hash, allow_fast_blit);
+		} else if (tile.ID >= BLOCK_C && tile.ID < BLOCK_D) {
+			// If Block C
+
+			// Get the tile coordinates from chipset
+			int col = 3 + (tile.ID - BLOCK_C) / 50;
+			int row = 4 + animation_step_c;
+
+			auto tone_hash = MakeCTileHash(tile.ID, animation_step_c);
+			DrawTile(dst, *chipset, *chipset_effect, x, y, row, col, tone_hash, allow_fast_blit);
+		} else if (tile.ID < BLOCK_C) {
+			// If Blocks A1, A2, B
+
+			// Draw the tile from autotile cache
+			TileXY pos = GetCachedAutotileAB(tile.ID, animation_step_ab);
+
+			int col = pos.x;
+			int row = pos.y;
+
+			// Create tone changed tile
+			auto tone_hash = MakeAbTileHash(tile.ID,  animation_step_ab);
+			DrawTile(dst, *autotiles_ab_screen, *autotiles_ab_screen_effect, x, y, row, col, tone_hash, allow_fast_blit);
+		} else {
+			// If blocks D1-D12
+
+			// Draw the tile from autotile cache
+			TileXY pos = GetCachedAutotileD(tile.ID);
+
+			int col = pos.x;
+			int row = pos.y;
+
+			auto tone_hash = MakeDTileHash(tile.ID);
+			DrawTile(dst, *autotiles_d_screen, *autotiles_d_screen_effect, x, y, row, col, tone_hash, allow_fast_blit);
+		}
+	} else {
+		// If upper layer
+
+		// Check that block F is being drawn
+		if (tile.ID >= BLOCK_F && tile.ID < BLOCK_F + BLOCK_F_TILES) {
+			int id = substitutions[tile.ID - BLOCK_F];
+			int row, col;
+
+			// Get the tile coordinates from chipset
+			if (id < 48) {
+				// If from first column of the block
+				col = 18 + id % 6;
+				row = 8 + id / 6;
+			} else {
+				// If from second column of the block
+				col = 24 + (id - 48) % 6;
+				row = (id - 48) / 6;
+			}
+
+			auto tone_hash = MakeFTileHash(id);
+			DrawTile(dst, *chipset, *chipset_effect, x, y, row, col, tone_hash);
+		}
+	}
+}
+
+bool TilemapLayer::IsAnimatedTile(const TileData& tile) const {
+	// Blocks A1, A2, B and C
+	return layer == 0 && tile.ID < BLOCK_D;
+}
+
 void TilemapLayer::Draw(Bitmap& dst, uint8_t z_order, int render_ox, int render_oy) {
 	// Get the number of tiles that can be displayed on window
 	int tiles_x = (int)ceil(Player::screen_width / (float)TILE_SIZE);
@@ -250,115 +338,207 @@ void TilemapLayer::Draw(Bitmap& dst, uint8_t z_order, int render_ox, int render_
 	const int mod_ox = mod(ox - render_ox, TILE_SIZE);
 	const int mod_oy = mod(oy - render_oy, TILE_SIZE);
 
-	for (int y = 0; y < tiles_y; y++) {
-		for (int x = 0; x < tiles_x; x++) {
+	if (frames == tone_change_frame) {
+		// The tone is changing (e.g. during a tint screen), every change invalidates
+		// the chunks. Draw the tiles directly to avoid rendering the chunks every frame.
+		for (int y = 0; y < tiles_y; y++) {
+			for (int x = 0; x < tiles_x; x++) {
 
-			// Get the real maps tile coordinates
-			int map_x = div_ox + x;
-			int map_y = div_oy + y;
-			if (loop_h) map_x = mod(map_x, width);
-			if (loop_v) map_y = mod(map_y, height);
+				// Get the real maps tile coordinates
+				int map_x = div_ox + x;
+				int map_y = div_oy + y;
+				if (loop_h) map_x = mod(map_x, width);
+				if (loop_v) map_y = mod(map_y, height);
 
-			int map_draw_x = x * TILE_SIZE - mod_ox;
-			int map_draw_y = y * TILE_SIZE - mod_oy;
+				int map_draw_x = x * TILE_SIZE - mod_ox;
+				int map_draw_y = y * TILE_SIZE - mod_oy;
 
-			bool out_of_bounds =
-				map_x < 0 || map_x >= width ||
-				map_y < 0 || map_y >= height;
+				bool out_of_bounds =
+					map_x < 0 || map_x >= width ||
+					map_y < 0 || map_y >= height;
+
+				if (out_of_bounds) {
+					continue;
+				}
 
-			if (out_of_bounds) {
+				// Get the tile data
+				TileData &tile = GetDataCache(map_x, map_y);
+
+				// Draw the sublayer if its z is being draw now
+				if (z_order == tile.z) {
+					DrawMapTile(dst, tile, map_draw_x, map_draw_y, animation_step_ab, animation_step_c);
+				}
+			}
+		}
+		return;
+	}
+
+	if (width <= 0 || height <= 0) {
+		return;
+	}
+
+	// Blit the visible parts of the chunks. The screen is split into runs of tiles
+	// that belong to the same chunk, this also handles looping maps.
+	const bool use_fast_blit = fast_blit && z_order == TileBelow;
+	const int end_x = div_ox + tiles_x;
+	const int end_y = div_oy + tiles_y;
+
+	for (int ty = div_oy; ty < end_y;) {
+		int map_y = loop_v ? mod(ty, height) : ty;
+		if (map_y < 0) {
+			ty = 0;
+			continue;
+		}
+		if (map_y >= height) {
+			break;
+		}
+
+		int chunk_y = map_y / CHUNK_TILES;
+		int run_h = std::min(std::min((chunk_y + 1) * CHUNK_TILES, height) - map_y, end_y - ty);
+
+		for (int tx = div_ox; tx < end_x;) {
+			int map_x = loop_h ? mod(tx, width) : tx;
+			if (map_x < 0) {
+				tx = 0;
 				continue;
 			}
+			if (map_x >= width) {
+				break;
+			}
+
+			int chunk_x = map_x / CHUNK_TILES;
+			int run_w = std::min(std::min((chunk_x + 1) * CHUNK_TILES, width) - map_x, end_x - tx);
+
+			Chunk& chunk = GetChunk(chunk_x, chunk_y, z_order);
 
-			// Get the tile data
-			TileData &tile = GetDataCache(map_x, map_y);
-
-			// Draw the sublayer if its z is being draw now
-			if (z_order == tile.z) {
-				if (layer == 0) {
-					// If lower layer
-					bool allow_fast_blit = (tile.z == TileBelow);
-
-					if (tile.ID >= BLOCK_E && tile.ID < BLOCK_E + BLOCK_E_TILES) {
-						int id = substitutions[tile.ID - BLOCK_E];
-						// If Block E
-
-						int row, col;
-
-						// Get the tile coordinates from chipset
-						if (id < 96) {
-							// If from first column of the block
-							col = 12 + id % 6;
-							row = id / 6;
-						} else {
-							// If from second column of the block
-							col = 18 + (id - 96) % 6;
-							row = (id - 96) / 6;
-						}
-
-						auto tone_hash = MakeETileHash(id);
-						DrawTile(dst, *chipset, *chipset_effect, map_draw_x, map_draw_y, row, col, tone_hash, allow_fast_blit);
-					} else if (tile.ID >= BLOCK_C && tile.ID < BLOCK_D) {
-						// If Block C
-
-						// Get the tile coordinates from chipset
-						int col = 3 + (tile.ID - BLOCK_C) / 50;
-						int row = 4 + animation_step_c;
-
-						auto tone_hash = MakeCTileHash(tile.ID, animation_step_c);
-						DrawTile(dst, *chipset, *chipset_effect, map_draw_x, map_draw_y, row, col, tone_hash, allow_fast_blit);
-					} else if (tile.ID < BLOCK_C) {
-						// If Blocks A1, A2, B
-
-						// Draw the tile from autotile cache
-						TileXY pos = GetCachedAutotileAB(tile.ID, animation_step_ab);
-
-						int col = pos.x;
-						int row = pos.y;
-
-						// Create tone changed tile
-						auto tone_hash = MakeAbTileHash(tile.ID,  animation_step_ab);
-						DrawTile(dst, *autotiles_ab_screen, *autotiles_ab_screen_effect, map_draw_x, map_draw_y, row, col, tone_hash, allow_fast_blit);
-					} else {
-						// If blocks D1-D12
-
-						// Draw the tile from autotile cache
-						TileXY pos = GetCachedAutotileD(tile.ID);
-
-						int col = pos.x;
-						int row = pos.y;
-
-						auto tone_hash = MakeDTileHash(tile.ID);
-						DrawTile(dst, *autotiles_d_screen, *autotiles_d_screen_effect, map_draw_x, map_draw_y, row, col, tone_hash, allow_fast_blit);
-					}
+			int draw_x = (tx - div_ox) * TILE_SIZE - mod_ox;
+			int draw_y = (ty - div_oy) * TILE_SIZE - mod_oy;
+
+			if (chunk.bitmap) {
+				Rect rect((map_x - chunk_x * CHUNK_TILES) * TILE_SIZE, (map_y - chunk_y * CHUNK_TILES) * TILE_SIZE,
+					run_w * TILE_SIZE, run_h * TILE_SIZE);
+
+				if (use_fast_blit) {
+					dst.BlitFast(draw_x, draw_y, *chunk.bitmap, rect, 255);
 				} else {
-					// If upper layer
-
-					// Check that block F is being drawn
-					if (tile.ID >= BLOCK_F && tile.ID < BLOCK_F + BLOCK_F_TILES) {
-						int id = substitutions[tile.ID - BLOCK_F];
-						int row, col;
-
-						// Get the tile coordinates from chipset
-						if (id < 48) {
-							// If from first column of the block
-							col = 18 + id % 6;
-							row = 8 + id / 6;
-						} else {
-							// If from second column of the block
-							col = 24 + (id - 48) % 6;
-							row = (id - 48) / 6;
-						}
-
-						auto tone_hash = MakeFTileHash(id);
-						DrawTile(dst, *chipset, *chipset_effect, map_draw_x, map_draw_y, row, col, tone_hash);
-					}
+					dst.Blit(draw_x, draw_y, *chunk.bitmap, rect, 255);
 				}
 			}
+
+			for (const auto& anim: chunk.animated) {
+				if (anim.x < map_x || anim.x >= map_x + run_w || anim.y < map_y || anim.y >= map_y + run_h) {
+					continue;
+				}
+
+				DrawMapTile(dst, GetDataCache(anim.x, anim.y),
+					draw_x + (anim.x - map_x) * TILE_SIZE, draw_y + (anim.y - map_y) * TILE_SIZE,
+					animation_step_ab, animation_step_c);
+			}
+
+			tx += run_w;
+		}
+
+		ty += run_h;
+	}
+}
+
+TilemapLayer::Chunk& TilemapLayer::GetChunk(int chunk_x, int chunk_y, uint8_t z_order) {
+	int sublayer = z_order >= TileAbove ? 1 : 0;
+	Chunk& chunk = chunks[(sublayer * chunks_h + chunk_y) * chunks_w + chunk_x];
+
+	chunk.last_use = ++chunk_use_counter;
+	if (!chunk.rendered) {
+		RenderChunk(chunk, chunk_x, chunk_y, z_order);
+	}
+
+	return chunk;
+}
+
+void TilemapLayer::RenderChunk(Chunk& chunk, int chunk_x, int chunk_y, uint8_t z_order) {
+	const int tile_x = chunk_x * CHUNK_TILES;
+	const int tile_y = chunk_y * CHUNK_TILES;
+	const int w = std::min(CHUNK_TILES, width - tile_x);
+	const int h = std::min(CHUNK_TILES, height - tile_y);
+
+	chunk.animated.clear();
+	chunk.rendered = true;
+
+	bool has_static = false;
+	for (int y = tile_y; y < tile_y + h; ++y) {
+		for (int x = tile_x; x < tile_x + w; ++x) {
+			const TileData& tile = GetDataCache(x, y);
+			if (tile.z != z_order) {
+				continue;
+			}
+
+			if (IsAnimatedTile(tile)) {
+				chunk.animated.push_back({ static_cast<uint16_t>(x), static_cast<uint16_t>(y) });
+			} else {
+				has_static = true;
+			}
+		}
+	}
+
+	if (!has_static) {
+		if (chunk.bitmap) {
+			chunk.bitmap.reset();
+			--chunk_bitmaps;
+		}
+		return;
+	}
+
+	if (!chunk.bitmap) {
+		if (chunk_bitmaps >= MAX_CHUNK_BITMAPS) {
+			// Free the least recently used chunk
+			Chunk* oldest = nullptr;
+			for (auto& c: chunks) {
+				if (c.bitmap && &c != &chunk && (!oldest || c.last_use < oldest->last_use)) {
+					oldest = &c;
+				}
+			}
+			if (oldest) {
+				oldest->bitmap.reset();
+				oldest->animated.clear();
+				oldest->rendered = false;
+				--chunk_bitmaps;
+			}
+		}
+
+		chunk.bitmap = Bitmap::Create(CHUNK_TILES * TILE_SIZE, CHUNK_TILES * TILE_SIZE, true);
+		++chunk_bitmaps;
+	}
+
+	chunk.bitmap->Clear();
+
+	for (int y = tile_y; y < tile_y + h; ++y) {
+		for (int x = tile_x; x < tile_x + w; ++x) {
+			const TileData& tile = GetDataCache(x, y);
+			if (tile.z != z_order || IsAnimatedTile(tile)) {
+				continue;
+			}
+
+			DrawMapTile(*chunk.bitmap, tile, (x - tile_x) * TILE_SIZE, (y - tile_y) * TILE_SIZE, 0, 0);
 		}
 	}
 }
 
+void TilemapLayer::InvalidateChunks() {
+	chunks_w = (width + CHUNK_TILES - 1) / CHUNK_TILES;
+	chunks_h = (height + CHUNK_TILES - 1) / CHUNK_TILES;
+
+	if (chunks.size() != static_cast<size_t>(chunks_w * chunks_h * 2)) {
+		chunks.clear();
+		chunks.resize(chunks_w * chunks_h * 2);
+		chunk_bitmaps = 0;
+		return;
+	}
+
+	// Keep the bitmaps, they are reused when the chunk is rendered again
+	for (auto& chunk: chunks) {
+		chunk.rendered = false;
+	}
+}
+
 TilemapLayer::TileXY TilemapLayer::GetCachedAutotileAB(short ID, short animID) {
 	short block = ID / 1000;
 	short b_subtile = (ID - block * 1000) / 50;
@@ -407,6 +587,8 @@ void TilemapLayer::CreateTileCache(const std::vector<short>& nmap_data) {
 			GetDataCache(x, y) = tile;
 		}
 	}
+
+	InvalidateChunks();
 }
 
 void TilemapLayer::GenerateAutotileAB(short ID, short animID) {
@@ -612,6 +794,7 @@ void TilemapLayer::SetChipset(BitmapRef const& nchipset) {
 	chipset = nchipset;
 	chipset_effect = Bitmap::Create(chipset->width(), chipset->height());
 	chipset_tone_tiles.clear();
+	InvalidateChunks();
 
 	if (autotiles_ab_next != 0 && autotiles_d_screen != nullptr && layer == 0) {
 		autotiles_ab_screen = GenerateAutotiles(autotiles_ab_next, autotiles_ab_map);
@@ -697,6 +880,7 @@ void TilemapLayer::SetTone(Tone tone) {
 	}
 
 	this->tone = tone;
+	tone_change_frame = Main_Data::game_system ? Main_Data::game_system->GetFrameCounter() : -1;
 
 	if (autotiles_d_screen_effect) {
 		autotiles_d_screen_effect->Clear();
@@ -708,4 +892,5 @@ void TilemapLayer::SetTone(Tone tone) {
 		chipset_effect->Clear();
 	}
 	chipset_tone_tiles.clear();
+	InvalidateChunks();
 }
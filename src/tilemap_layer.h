@@ -98,6 +98,12 @@ public:
 
 	void SetTone(Tone tone);
 
+	/** Tiles per side of a pre-rendered chunk */
+	static constexpr int CHUNK_TILES = 16;
+
+	/** Maximum number of chunk bitmaps per layer, the least recently used ones are freed */
+	static constexpr int MAX_CHUNK_BITMAPS = 24;
+
 private:
 	BitmapRef chipset;
 	BitmapRef chipset_effect;
@@ -157,6 +163,40 @@ private:
 
 	std::vector<TileData> data_cache_vec;
 
+	void DrawMapTile(Bitmap& dst, const TileData& tile, int x, int y, int animation_step_ab, int animation_step_c);
+	bool IsAnimatedTile(const TileData& tile) const;
+
+	struct ChunkTile {
+		uint16_t x;
+		uint16_t y;
+	};
+
+	/**
+	 * A block of CHUNK_TILES x CHUNK_TILES tiles of one sublayer.
+	 * The static tiles are pre-rendered into the bitmap, the animated
+	 * tiles (A, B and C blocks) are drawn on top of it every frame.
+	 */
+	struct Chunk {
+		/** Static tiles, nullptr when there are none */
+		BitmapRef bitmap;
+		/** Map coordinates of the animated tiles */
+		std::vector<ChunkTile> animated;
+		uint32_t last_use = 0;
+		bool rendered = false;
+	};
+
+	Chunk& GetChunk(int chunk_x, int chunk_y, uint8_t z_order);
+	void RenderChunk(Chunk& chunk, int chunk_x, int chunk_y, uint8_t z_order);
+	void InvalidateChunks();
+
+	std::vector<Chunk> chunks;
+	int chunks_w = 0;
+	int chunks_h = 0;
+	int chunk_bitmaps = 0;
+	uint32_t chunk_use_counter = 0;
+	/** Frame of the last tone change. Tiles are drawn directly while the tone is changing */
+	int tone_change_frame = -1;
+
 	TilemapSubLayer lower_layer;
 	TilemapSubLayer upper_layer;
 
@@ -174,6 +174,11 @@ void Transition::SetAttributesTransitions() {
 	}
 }
 
+bool Transition::GetDamage(Rect& damage) {
+	damage = Rect();
+	return !IsActive();
+}
+
 void Transition::Draw(Bitmap& dst) {
 	if (!IsActive())
 		return;
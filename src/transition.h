@@ -110,6 +110,12 @@ public:
 	void Draw(Bitmap& dst) override;
 	void Update();
 
+	/**
+	 * Nothing is drawn while the transition is inactive.
+	 * Active transitions always redraw the whole screen.
+	 */
+	bool GetDamage(Rect& damage) override;
+
 	bool IsActive() const;
 	bool IsErasedNotActive() const;
 
@@ -167,6 +167,39 @@ void Window::Draw(Bitmap& dst) {
 	}
 }
 
+bool Window::GetDamage(Rect& damage) {
+	DamageState state;
+	Rect bounds;
+
+	if (IsVisible() && width > 0 && height > 0) {
+		state.windowskin = windowskin.get();
+		state.windowskin_revision = windowskin ? windowskin->GetRevision() : 0;
+		state.contents = contents.get();
+		state.contents_revision = contents ? contents->GetRevision() : 0;
+		state.stretch = stretch;
+		state.cursor_rect = cursor_rect;
+		state.cursor_first_frame = cursor_frame <= 10;
+		state.pause_visible = pause && pause_frame < pause_animation_frames;
+		state.arrows = up_arrow | (down_arrow << 1) | (left_arrow << 2) | (right_arrow << 3);
+		state.ox = ox;
+		state.oy = oy;
+		state.border_x = border_x;
+		state.border_y = border_y;
+		state.opacity = opacity;
+		state.frame_opacity = frame_opacity;
+		state.back_opacity = back_opacity;
+		state.contents_opacity = contents_opacity;
+		state.animation_frames = animation_frames;
+		state.animation_count = static_cast<int>(animation_count);
+
+		// The rotated left and right arrows reach slightly outside of the window
+		bounds = Rect(x - 16, y - 16, width + 32, height + 32);
+	}
+
+	damage = UpdateDamage(damage_state, state, damage_bounds, bounds);
+	return true;
+}
+
 void Window::RefreshBackground() {
 	background_needs_refresh = false;
 
@@ -19,6 +19,7 @@
 #define EP_WINDOW_H
 
 // Headers
+#include <tuple>
 #include "system.h"
 #include "drawable.h"
 #include "rect.h"
@@ -32,6 +33,8 @@ public:
 
 	void Draw(Bitmap& dst) override;
 
+	bool GetDamage(Rect& damage) override;
+
 	virtual void Update();
 	BitmapRef const& GetWindowskin() const;
 	void SetWindowskin(BitmapRef const& nwindowskin);
@@ -115,6 +118,42 @@ private:
 		background, frame_down,
 		frame_up, frame_left, frame_right, cursor1, cursor2;
 
+	/** Everything that affects the output of Draw, for damage tracking */
+	struct DamageState {
+		const Bitmap* windowskin = nullptr;
+		uint32_t windowskin_revision = 0;
+		const Bitmap* contents = nullptr;
+		uint32_t contents_revision = 0;
+		bool stretch = true;
+		Rect cursor_rect;
+		bool cursor_first_frame = true;
+		bool pause_visible = false;
+		int arrows = 0;
+		int ox = 0;
+		int oy = 0;
+		int border_x = 0;
+		int border_y = 0;
+		int opacity = 0;
+		int frame_opacity = 0;
+		int back_opacity = 0;
+		int contents_opacity = 0;
+		int animation_frames = 0;
+		int animation_count = 0;
+
+		auto Tie() const {
+			return std::tie(windowskin, windowskin_revision, contents, contents_revision, stretch, cursor_rect,
+				cursor_first_frame, pause_visible, arrows, ox, oy, border_x, border_y, opacity, frame_opacity,
+				back_opacity, contents_opacity, animation_frames, animation_count);
+		}
+
+		bool operator==(const DamageState& other) const {
+			return Tie() == other.Tie();
+		}
+	};
+
+	DamageState damage_state;
+	Rect damage_bounds;
+
 	void RefreshBackground();
 	void RefreshFrame();
 	void RefreshCursor();
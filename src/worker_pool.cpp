@@ -0,0 +1,115 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include <algorithm>
+#include "worker_pool.h"
+
+#ifdef HAVE_THREADS
+
+WorkerPool::WorkerPool(int num_threads) {
+	if (num_threads <= 0) {
+		// Keep one core for the main thread
+		num_threads = std::clamp(static_cast<int>(std::thread::hardware_concurrency()) - 1, 1, 4);
+	}
+
+	threads.reserve(num_threads);
+	for (int i = 0; i < num_threads; ++i) {
+		threads.emplace_back(&WorkerPool::ThreadFunction, this);
+	}
+}
+
+WorkerPool::~WorkerPool() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stop = true;
+	}
+	task_cv.notify_all();
+
+	for (auto& thread : threads) {
+		thread.join();
+	}
+}
+
+void WorkerPool::Push(Task task) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		tasks.push_back(std::move(task));
+	}
+	task_cv.notify_one();
+}
+
+void WorkerPool::WaitIdle() {
+	std::unique_lock<std::mutex> lock(mutex);
+	idle_cv.wait(lock, [this]() { return tasks.empty() && busy == 0; });
+}
+
+int WorkerPool::GetThreadCount() const {
+	return static_cast<int>(threads.size());
+}
+
+void WorkerPool::ThreadFunction() {
+	std::unique_lock<std::mutex> lock(mutex);
+
+	while (true) {
+		task_cv.wait(lock, [this]() { return stop || !tasks.empty(); });
+
+		if (tasks.empty()) {
+			// stop is set and all work is done
+			return;
+		}
+
+		Task task = std::move(tasks.front());
+		tasks.pop_front();
+		++busy;
+
+		lock.unlock();
+		task();
+		lock.lock();
+
+		--busy;
+		if (busy == 0 && tasks.empty()) {
+			idle_cv.notify_all();
+		}
+	}
+}
+
+#else
+
+WorkerPool::WorkerPool(int) {
+}
+
+WorkerPool::~WorkerPool() {
+}
+
+void WorkerPool::Push(Task task) {
+	task();
+}
+
+void WorkerPool::WaitIdle() {
+}
+
+int WorkerPool::GetThreadCount() const {
+	return 0;
+}
+
+#endif
+
+WorkerPool& WorkerPool::Shared() {
+	static WorkerPool pool;
+	return pool;
+}
@@ -0,0 +1,92 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_WORKER_POOL_H
+#define EP_WORKER_POOL_H
+
+// Headers
+#include <deque>
+#include <functional>
+#include <vector>
+
+#ifdef HAVE_THREADS
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+/**
+ * A small pool of worker threads that executes tasks in FIFO order.
+ * On platforms without thread support (HAVE_THREADS not defined) every task
+ * is executed immediately by the calling thread.
+ *
+ * Tasks must not access game state, the filesystem caches or the graphics
+ * and audio subsystems. They only transform data that is owned by the task.
+ */
+class WorkerPool {
+public:
+	using Task = std::function<void()>;
+
+	/**
+	 * Creates the pool and starts the worker threads.
+	 *
+	 * @param num_threads amount of threads, 0 picks a value based on the hardware concurrency
+	 */
+	explicit WorkerPool(int num_threads = 0);
+
+	/** Waits for all queued tasks and stops the threads */
+	~WorkerPool();
+
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+
+	/**
+	 * Enqueues a task.
+	 *
+	 * @param task task to execute on a worker thread
+	 */
+	void Push(Task task);
+
+	/** Blocks until the queue is empty and no task is running */
+	void WaitIdle();
+
+	/** @return amount of worker threads, 0 when tasks run on the calling thread */
+	int GetThreadCount() const;
+
+	/**
+	 * The pool shared by the engine subsystems (image decoding, loading...).
+	 * It is created on first use.
+	 *
+	 * @return the shared pool
+	 */
+	static WorkerPool& Shared();
+
+private:
+#ifdef HAVE_THREADS
+	void ThreadFunction();
+
+	std::vector<std::thread> threads;
+	std::deque<Task> tasks;
+	std::mutex mutex;
+	std::condition_variable task_cv;
+	std::condition_variable idle_cv;
+	int busy = 0;
+	bool stop = false;
+#endif
+};
+
+#endif
@@ -0,0 +1,75 @@
+#include "audio_mixer.h"
+#include "doctest.h"
+#include <vector>
+
+using Format = AudioDecoderBase::Format;
+
+TEST_SUITE_BEGIN("AudioMixer");
+
+TEST_CASE("MixS16Stereo") {
+	std::vector<float> mix(4, 0.0f);
+	int16_t src[] = { 16384, -16384, 32767, -32768 };
+
+	AudioMixer::Mix(mix.data(), reinterpret_cast<const uint8_t*>(src), 2, Format::S16, 2, 1.0f);
+	CHECK_EQ(mix[0], doctest::Approx(0.5f));
+	CHECK_EQ(mix[1], doctest::Approx(-0.5f));
+	CHECK_EQ(mix[3], doctest::Approx(-1.0f));
+
+	AudioMixer::Mix(mix.data(), reinterpret_cast<const uint8_t*>(src), 2, Format::S16, 2, 0.5f);
+	CHECK_EQ(mix[0], doctest::Approx(0.75f));
+	CHECK_EQ(mix[1], doctest::Approx(-0.75f));
+}
+
+TEST_CASE("MixUnsigned") {
+	std::vector<float> mix(2, 0.0f);
+	uint8_t src[] = { 128, 0 };
+
+	AudioMixer::Mix(mix.data(), src, 1, Format::U8, 2, 1.0f);
+	CHECK_EQ(mix[0], doctest::Approx(0.0f));
+	CHECK_EQ(mix[1], doctest::Approx(-1.0f));
+}
+
+TEST_CASE("MixMonoToBothChannels") {
+	std::vector<float> mix = { 0.25f, -0.25f, 0.0f, 0.0f };
+	float src[] = { 0.5f, -0.5f };
+
+	AudioMixer::Mix(mix.data(), reinterpret_cast<const uint8_t*>(src), 2, Format::F32, 1, 1.0f);
+	CHECK_EQ(mix[0], doctest::Approx(0.75f));
+	CHECK_EQ(mix[1], doctest::Approx(0.25f));
+	CHECK_EQ(mix[2], doctest::Approx(-0.5f));
+	CHECK_EQ(mix[3], doctest::Approx(-0.5f));
+}
+
+TEST_CASE("MixUsesFirstTwoChannels") {
+	std::vector<float> mix(2, 0.0f);
+	int8_t src[] = { 64, -64, 127, 127 };
+
+	AudioMixer::Mix(mix.data(), reinterpret_cast<const uint8_t*>(src), 1, Format::S8, 4, 1.0f);
+	CHECK_EQ(mix[0], doctest::Approx(0.5f));
+	CHECK_EQ(mix[1], doctest::Approx(-0.5f));
+}
+
+TEST_CASE("CompressWithoutOverload") {
+	float mix[] = { 0.5f, -0.5f, 1.0f, -1.0f };
+	int16_t out[4];
+
+	AudioMixer::Compress(out, mix, 4, 1.0f);
+	CHECK_EQ(out[0], 16384);
+	CHECK_EQ(out[1], -16384);
+	CHECK_EQ(out[2], 32767);
+	CHECK_EQ(out[3], -32768);
+}
+
+TEST_CASE("CompressOverload") {
+	float mix[] = { 0.5f, 2.0f, -2.0f };
+	int16_t out[3];
+
+	AudioMixer::Compress(out, mix, 3, 2.0f);
+	// Below the threshold samples are unchanged
+	CHECK_EQ(out[0], 16384);
+	// The maximum reaches full scale
+	CHECK_EQ(out[1], 32767);
+	CHECK_EQ(out[2], -32768);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,202 @@
+#include "audio_secache.h"
+#include "system.h"
+#include "doctest.h"
+#include <sstream>
+#include <string>
+
+#ifdef WANT_DRWAV
+
+namespace {
+	void PutLE(std::string& out, uint32_t value, int bytes) {
+		for (int i = 0; i < bytes; ++i) {
+			out.push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+		}
+	}
+
+	/** Creates a stream of a silent 16 bit mono WAV file */
+	Filesystem_Stream::InputStream MakeWav(const std::string& name, size_t data_bytes) {
+		std::string wav;
+		wav += "RIFF";
+		PutLE(wav, 36 + data_bytes, 4);
+		wav += "WAVEfmt ";
+		PutLE(wav, 16, 4);
+		PutLE(wav, 1, 2);
+		PutLE(wav, 1, 2);
+		PutLE(wav, 22050, 4);
+		PutLE(wav, 22050 * 2, 4);
+		PutLE(wav, 2, 2);
+		PutLE(wav, 16, 2);
+		wav += "data";
+		PutLE(wav, data_bytes, 4);
+		wav.append(data_bytes, '\0');
+
+		return Filesystem_Stream::InputStream(new std::stringbuf(wav, std::ios_base::in), name);
+	}
+
+	std::unique_ptr<AudioSeCache> Load(const std::string& name, size_t data_bytes) {
+		auto se = AudioSeCache::GetCachedSe(name);
+		if (!se) {
+			se = AudioSeCache::Create(MakeWav(name, data_bytes), name);
+		}
+		return se;
+	}
+}
+
+TEST_SUITE_BEGIN("AudioSeCache");
+
+TEST_CASE("HitAndMiss") {
+	AudioSeCache::Clear();
+	auto before = AudioSeCache::GetStats();
+
+	REQUIRE_FALSE(AudioSeCache::GetCachedSe("se1"));
+
+	auto se = Load("se1", 1000);
+	REQUIRE(se);
+	se->CreateSeDecoder();
+
+	auto stats = AudioSeCache::GetStats();
+	CHECK_EQ(stats.misses, before.misses + 1);
+	CHECK_EQ(stats.hits, before.hits);
+	CHECK_EQ(stats.entries, 1u);
+	CHECK_EQ(stats.bytes, se->GetSeData()->buffer.size());
+
+	auto cached = AudioSeCache::GetCachedSe("se1");
+	REQUIRE(cached);
+	cached->CreateSeDecoder();
+
+	stats = AudioSeCache::GetStats();
+	CHECK_EQ(stats.misses, before.misses + 1);
+	CHECK_EQ(stats.hits, before.hits + 1);
+	CHECK_EQ(stats.entries, 1u);
+
+	AudioSeCache::Clear();
+	CHECK_FALSE(AudioSeCache::GetCachedSe("se1"));
+	CHECK_EQ(AudioSeCache::GetStats().bytes, 0u);
+}
+
+TEST_CASE("EvictsLeastRecentlyUsed") {
+	AudioSeCache::Clear();
+	const size_t budget = AudioSeCache::GetStats().budget;
+	const size_t size = budget / 3;
+
+	Load("se1", size)->CreateSeDecoder();
+	Load("se2", size)->CreateSeDecoder();
+	// se1 becomes the most recently used, se2 is evicted first
+	Load("se1", size)->CreateSeDecoder();
+
+	auto evictions = AudioSeCache::GetStats().evictions;
+	Load("se3", size)->CreateSeDecoder();
+	Load("se4", size)->CreateSeDecoder();
+
+	auto stats = AudioSeCache::GetStats();
+	CHECK_EQ(stats.evictions, evictions + 1);
+	CHECK_LE(stats.bytes, budget);
+	CHECK_EQ(stats.entries, 3u);
+
+	CHECK(AudioSeCache::GetCachedSe("se1"));
+	CHECK_FALSE(AudioSeCache::GetCachedSe("se2"));
+	CHECK(AudioSeCache::GetCachedSe("se3"));
+	CHECK(AudioSeCache::GetCachedSe("se4"));
+
+	AudioSeCache::Clear();
+}
+
+TEST_CASE("KeepsPlayingSamples") {
+	AudioSeCache::Clear();
+	const size_t budget = AudioSeCache::GetStats().budget;
+	const size_t size = budget / 3;
+
+	// The decoder holds the sample like a playing channel
+	auto playing = Load("se1", size)->CreateSeDecoder();
+	Load("se2", size)->CreateSeDecoder();
+	Load("se3", size)->CreateSeDecoder();
+	Load("se4", size)->CreateSeDecoder();
+
+	CHECK(AudioSeCache::GetCachedSe("se1"));
+	CHECK_FALSE(AudioSeCache::GetCachedSe("se2"));
+	CHECK_LE(AudioSeCache::GetStats().bytes, budget);
+
+	AudioSeCache::Clear();
+}
+
+#ifdef USE_AUDIO_RESAMPLER
+TEST_CASE("ConvertedFormat") {
+	AudioSeCache::Clear();
+
+	// 500 samples, 16 bit mono at 22050 Hz
+	auto se = Load("se1", 1000);
+	auto conv = se->GetConvertedSeData(100, 44100, AudioDecoder::Format::S16, 2);
+	REQUIRE(conv);
+	CHECK_EQ(conv->frequency, 44100);
+	CHECK(conv->format == AudioDecoder::Format::S16);
+	CHECK_EQ(conv->channels, 2);
+	CHECK_EQ(conv->pitch, 100);
+
+	// Twice the rate and two channels, the resampler may drop a few samples
+	CHECK_EQ(conv->buffer.size() % 4, 0u);
+	CHECK_GE(conv->buffer.size(), 3000u);
+	CHECK_LE(conv->buffer.size(), 4400u);
+
+	int frequency;
+	AudioDecoder::Format format;
+	int channels;
+	AudioSeDecoder dec(conv);
+	dec.GetFormat(frequency, format, channels);
+	CHECK_EQ(frequency, 44100);
+	CHECK(format == AudioDecoder::Format::S16);
+	CHECK_EQ(channels, 2);
+
+	// A higher pitch plays faster
+	auto high = se->GetConvertedSeData(200, 44100, AudioDecoder::Format::S16, 2);
+	REQUIRE(high);
+	CHECK_EQ(high->pitch, 200);
+	CHECK_LT(high->buffer.size(), conv->buffer.size());
+
+	// The unconverted sample is kept
+	auto data = se->GetSeData();
+	CHECK_EQ(data->frequency, 22050);
+	CHECK_EQ(data->channels, 1);
+	CHECK_EQ(data->buffer.size(), 1000u);
+
+	AudioSeCache::Clear();
+}
+
+TEST_CASE("ConvertedDataIsShared") {
+	AudioSeCache::Clear();
+	const auto conversions = AudioSeCache::GetStats().conversions;
+
+	// Every play of an SE uses its own AudioSeCache
+	auto first = Load("se1", 1000)->GetConvertedSeData(100, 44100, AudioDecoder::Format::S16, 2);
+	auto second = Load("se1", 1000)->GetConvertedSeData(100, 44100, AudioDecoder::Format::S16, 2);
+	REQUIRE(first);
+	CHECK_EQ(first.get(), second.get());
+
+	auto stats = AudioSeCache::GetStats();
+	CHECK_EQ(stats.conversions, conversions + 1);
+	CHECK_EQ(stats.entries, 1u);
+	CHECK_EQ(stats.bytes, 1000u + first->buffer.size());
+
+	// Other pitches and formats are converted separately
+	auto pitched = Load("se1", 1000)->GetConvertedSeData(150, 44100, AudioDecoder::Format::S16, 2);
+	auto mono = Load("se1", 1000)->GetConvertedSeData(100, 44100, AudioDecoder::Format::S16, 1);
+	REQUIRE(pitched);
+	REQUIRE(mono);
+	CHECK_NE(pitched.get(), first.get());
+	CHECK_NE(mono.get(), first.get());
+	CHECK_EQ(AudioSeCache::GetStats().conversions, conversions + 3);
+
+	AudioSeCache::Clear();
+}
+#else
+TEST_CASE("NoConversionWithoutResampler") {
+	AudioSeCache::Clear();
+
+	CHECK_FALSE(Load("se1", 1000)->GetConvertedSeData(100, 44100, AudioDecoder::Format::S16, 2));
+
+	AudioSeCache::Clear();
+}
+#endif
+
+TEST_SUITE_END();
+
+#endif
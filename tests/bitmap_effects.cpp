@@ -0,0 +1,75 @@
+#include "bitmap.h"
+#include "pixel_format.h"
+#include "doctest.h"
+#include <cstring>
+
+TEST_SUITE_BEGIN("BitmapEffects");
+
+namespace {
+
+BitmapRef MakeSource(int width, int height) {
+	auto bm = Bitmap::Create(width, height, true);
+	auto* pixels = reinterpret_cast<uint32_t*>(bm->pixels());
+	const int next_row = bm->pitch() / sizeof(uint32_t);
+
+	for (int y = 0; y < height; ++y) {
+		for (int x = 0; x < width; ++x) {
+			// Fully transparent, opaque and translucent pixels
+			uint8_t a = (x % 3 == 0) ? 0 : (x % 3 == 1) ? 255 : 128;
+			uint8_t c = static_cast<uint8_t>((x * 7 + y * 13) % 256 * a / 255);
+			pixels[y * next_row + x] = Bitmap::pixel_format.rgba_to_uint32_t(c, c / 2, a - c / 3, a);
+		}
+	}
+
+	return bm;
+}
+
+// The way Cache::SpriteEffect creates the effect bitmap
+void DrawReference(Bitmap& dst, int x, int y, const Bitmap& src, const Rect& rect,
+		const Tone& tone, const Color& flash, bool flip_x, bool flip_y, const Opacity& opacity) {
+	auto effect = Bitmap::Create(rect.width, rect.height, true);
+	effect->ToneBlit(0, 0, src, rect, tone, Opacity::Opaque());
+	effect->BlendBlit(0, 0, *effect, effect->GetRect(), flash, Opacity::Opaque());
+	effect->Flip(flip_x, flip_y);
+
+	dst.Blit(x, y, *effect, effect->GetRect(), opacity);
+}
+
+void Check(int x, int y, bool flip_x, bool flip_y, const Opacity& opacity) {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+
+	auto src = MakeSource(32, 24);
+	const Rect rect(4, 2, 20, 18);
+	const Tone tone(200, 50, 255, 64);
+	const Color flash(255, 0, 0, 128);
+
+	auto expected = Bitmap::Create(40, 40, Color(0, 64, 0, 255));
+	DrawReference(*expected, x, y, *src, rect, tone, flash, flip_x, flip_y, opacity);
+
+	auto actual = Bitmap::Create(40, 40, Color(0, 64, 0, 255));
+	BitmapRef scratch;
+	actual->EffectsToneBlit(x, y, *src, rect, tone, flash, flip_x, flip_y, opacity, Bitmap::BlendMode::Default, scratch);
+
+	REQUIRE_EQ(std::memcmp(expected->pixels(), actual->pixels(), expected->pitch() * expected->height()), 0);
+}
+
+}
+
+TEST_CASE("EffectsToneBlit") {
+	Check(10, 10, false, false, Opacity::Opaque());
+}
+
+TEST_CASE("EffectsToneBlitFlip") {
+	Check(10, 10, true, false, Opacity::Opaque());
+	Check(10, 10, false, true, Opacity::Opaque());
+	Check(10, 10, true, true, Opacity(160));
+}
+
+TEST_CASE("EffectsToneBlitCropped") {
+	Check(-5, 30, false, false, Opacity::Opaque());
+	Check(-5, 30, true, true, Opacity::Opaque());
+	Check(30, -7, true, false, Opacity(255, 96, 6));
+	Check(-3, 35, false, true, Opacity(255, 96, 6));
+}
+
+TEST_SUITE_END();
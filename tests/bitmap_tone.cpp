@@ -0,0 +1,141 @@
+#include "bitmap_tone.h"
+#include "doctest.h"
+#include <vector>
+
+namespace {
+
+// Reference implementation, same as the scalar code of Bitmap::ToneBlit
+uint8_t HardLight(int tone, int c) {
+	int res = 0;
+	if (tone <= 128)
+		res = (2 * tone * c) / 255;
+	else
+		res = 255 - 2 * (255 - tone) * (255 - c) / 255;
+	return res > 255 ? 255 : res < 0 ? 0 : res;
+}
+
+uint32_t RefTone(uint32_t pixel, const Tone& tone, ImageOpacity opacity, const DynamicFormat& f) {
+	const int rs = f.r.shift, gs = f.g.shift, bs = f.b.shift, as = f.a.shift;
+	int r = (pixel >> rs) & 0xFF;
+	int g = (pixel >> gs) & 0xFF;
+	int b = (pixel >> bs) & 0xFF;
+	int a = (pixel >> as) & 0xFF;
+
+	const bool apply_sat = tone.gray != 128;
+	const bool apply_tone = (tone.red != 128 || tone.green != 128 || tone.blue != 128);
+
+	if (opacity != ImageOpacity::Opaque && a == 0) {
+		return pixel;
+	}
+
+	if (apply_sat) {
+		int sat = BitmapTone::GetSaturation(tone);
+		int lum = (7471 * b + 38470 * g + 19595 * r) >> 16;
+		auto scale = [&](int c) {
+			int v = (lum * 1024 + (c - lum) * sat) >> 10;
+			return v > 255 ? 255 : v < 0 ? 0 : v;
+		};
+		r = scale(r);
+		g = scale(g);
+		b = scale(b);
+	}
+
+	if (apply_tone) {
+		r = HardLight(tone.red, r);
+		g = HardLight(tone.green, g);
+		b = HardLight(tone.blue, b);
+		if (opacity == ImageOpacity::Alpha_8Bit) {
+			r = r * a / 255;
+			g = g * a / 255;
+			b = b * a / 255;
+		}
+	}
+
+	return ((uint32_t)r << rs) | ((uint32_t)g << gs) | ((uint32_t)b << bs) | ((uint32_t)a << as);
+}
+
+void CheckTone(const DynamicFormat& format, ImageOpacity opacity, const Tone& tone) {
+	auto fn = BitmapTone::GetRowFunction(format, opacity, tone);
+#if defined(__GNUC__) || defined(__clang__)
+	REQUIRE(fn != nullptr);
+#else
+	if (fn == nullptr) {
+		return;
+	}
+#endif
+
+	// Odd width to cover the remainder handling
+	std::vector<uint32_t> pixels(1021);
+	uint32_t seed = 12345;
+	for (auto& px: pixels) {
+		seed = seed * 1103515245 + 12345;
+		px = seed;
+	}
+	pixels[0] &= ~(0xFFu << format.a.shift);
+	pixels[1] |= 0xFFu << format.a.shift;
+
+	auto expected = pixels;
+	for (auto& px: expected) {
+		px = RefTone(px, tone, opacity, format);
+	}
+
+	fn(pixels.data(), static_cast<int>(pixels.size()), tone);
+
+	for (size_t i = 0; i < pixels.size(); ++i) {
+		REQUIRE_EQ(pixels[i], expected[i]);
+	}
+}
+
+const DynamicFormat formats[] = {
+	format_R8G8B8A8_a().format(),
+	format_B8G8R8A8_a().format(),
+	format_A8R8G8B8_a().format(),
+	format_A8B8G8R8_a().format()
+};
+
+const ImageOpacity opacities[] = {
+	ImageOpacity::Opaque,
+	ImageOpacity::Alpha_1Bit,
+	ImageOpacity::Alpha_8Bit
+};
+
+}
+
+TEST_SUITE_BEGIN("BitmapTone");
+
+TEST_CASE("NoKernelForNeutralTone") {
+	REQUIRE(BitmapTone::GetRowFunction(formats[0], ImageOpacity::Opaque, Tone()) == nullptr);
+}
+
+TEST_CASE("NoKernelFor16Bit") {
+	REQUIRE(BitmapTone::GetRowFunction(DynamicFormat(16, 5, 11, 6, 5, 5, 0, 0, 0, PF::NoAlpha), ImageOpacity::Opaque, Tone(0, 0, 0, 0)) == nullptr);
+}
+
+TEST_CASE("ColorTone") {
+	for (auto& format: formats) {
+		for (auto opacity: opacities) {
+			CheckTone(format, opacity, Tone(255, 128, 0, 128));
+			CheckTone(format, opacity, Tone(129, 127, 200, 128));
+		}
+	}
+}
+
+TEST_CASE("Saturation") {
+	for (auto& format: formats) {
+		for (auto opacity: opacities) {
+			CheckTone(format, opacity, Tone(128, 128, 128, 0));
+			CheckTone(format, opacity, Tone(128, 128, 128, 255));
+		}
+	}
+}
+
+TEST_CASE("SaturationAndColorTone") {
+	for (auto& format: formats) {
+		for (auto opacity: opacities) {
+			CheckTone(format, opacity, Tone(50, 180, 255, 64));
+			CheckTone(format, opacity, Tone(0, 0, 0, 200));
+		}
+	}
+}
+
+TEST_SUITE_END();
@@ -22,6 +22,23 @@ class TestFrame : public Drawable {
 		void Draw(Bitmap&) override {}
 };
 
+class TestTracked : public Drawable {
+	public:
+		TestTracked(Drawable::Z_t z = 0) : Drawable(z, Drawable::Flags::Global) {}
+		void Draw(Bitmap&) override {}
+		bool GetDamage(Rect& damage) override {
+			Rect bounds = IsVisible() ? rect : Rect();
+			damage = UpdateDamage(last_color, color, last_rect, bounds);
+			return true;
+		}
+
+		Rect rect;
+		int color = 0;
+	private:
+		Rect last_rect;
+		int last_color = 0;
+};
+
 }
 
 TEST_CASE("Default") {
@@ -350,4 +367,57 @@ TEST_CASE("TakeFromPred") {
 	REQUIRE(list2.IsDirty());
 }
 
+TEST_CASE("CollectDamage") {
+	DrawableList default_list;
+	DrawableMgr::SetLocalList(&default_list);
+
+	DrawableList list;
+
+	TestTracked t1(1);
+	t1.rect = Rect(0, 0, 8, 8);
+	TestTracked t2(2);
+	t2.rect = Rect(16, 16, 8, 8);
+
+	list.Append(&t1);
+	list.Append(&t2);
+
+	// Adding drawables redraws everything
+	Rect damage;
+	REQUIRE_FALSE(list.CollectDamage(damage));
+
+	damage = Rect();
+	REQUIRE(list.CollectDamage(damage));
+	REQUIRE(damage.IsEmpty());
+
+	t1.color = 1;
+	damage = Rect();
+	REQUIRE(list.CollectDamage(damage));
+	REQUIRE_EQ(damage, Rect(0, 0, 8, 8));
+
+	t1.rect = Rect(4, 0, 8, 8);
+	t2.SetVisible(false);
+	damage = Rect();
+	REQUIRE(list.CollectDamage(damage));
+	REQUIRE_EQ(damage, Rect(0, 0, 24, 24));
+
+	damage = Rect();
+	REQUIRE(list.CollectDamage(damage));
+	REQUIRE(damage.IsEmpty());
+
+	// Untracked drawables redraw everything while visible and one frame after
+	TestSprite s1(3);
+	list.Append(&s1);
+	REQUIRE_FALSE(list.CollectDamage(damage));
+	REQUIRE_FALSE(list.CollectDamage(damage));
+	s1.SetVisible(false);
+	REQUIRE_FALSE(list.CollectDamage(damage));
+	damage = Rect();
+	REQUIRE(list.CollectDamage(damage));
+	REQUIRE(damage.IsEmpty());
+
+	list.Take(&s1);
+	REQUIRE_FALSE(list.CollectDamage(damage));
+	REQUIRE(list.CollectDamage(damage));
+}
+
 TEST_SUITE_END();
@@ -183,6 +183,25 @@ TEST_CASE("easyrpg dynrpg invoke") {
 	DynRpg::Invoke("@unknownfunc 1, 2, 3");
 }
 
+TEST_CASE("Cached invoke resolves tokens on every call") {
+	const MockActor m;
+
+	std::vector<int32_t> vars = {0, 5, 2};
+	Main_Data::game_variables->SetData(vars);
+	Main_Data::game_variables->SetWarning(0);
+
+	DynRpg::Invoke("@easyrpg_add 1, V2, VV3");
+	CHECK(Main_Data::game_variables->Get(1) == 10);
+
+	Main_Data::game_variables->Set(2, 7);
+	DynRpg::Invoke("@easyrpg_add 1, V2, VV3");
+	CHECK(Main_Data::game_variables->Get(1) == 14);
+
+	Main_Data::game_variables->Set(3, 1);
+	DynRpg::Invoke("@easyrpg_add 1, V2, VV3");
+	CHECK(Main_Data::game_variables->Get(1) == 21);
+}
+
 TEST_CASE("Incompatible changes") {
 	const MockActor m; // disable log
 
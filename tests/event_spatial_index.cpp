@@ -0,0 +1,75 @@
+#include "event_spatial_index.h"
+#include "doctest.h"
+#include <vector>
+
+static std::vector<int> GetSlots(const EventSpatialIndex& index, int x, int y) {
+	std::vector<int> slots;
+	for (int slot = index.GetNext(x, y, -1); slot >= 0; slot = index.GetNext(x, y, slot)) {
+		slots.push_back(slot);
+	}
+	return slots;
+}
+
+TEST_SUITE_BEGIN("EventSpatialIndex");
+
+TEST_CASE("Empty") {
+	EventSpatialIndex index;
+
+	REQUIRE_EQ(index.GetSlotCount(), 0);
+	REQUIRE_FALSE(index.IsInGrid(0, 0));
+	REQUIRE_EQ(index.GetNext(0, 0, -1), -1);
+}
+
+TEST_CASE("SortedBySlot") {
+	EventSpatialIndex index;
+	index.Reset(20, 15, 4);
+
+	index.Update(3, 5, 5);
+	index.Update(1, 5, 5);
+	index.Update(2, 6, 5);
+	index.Update(0, 5, 5);
+
+	REQUIRE_EQ(GetSlots(index, 5, 5), std::vector<int>{ 0, 1, 3 });
+	REQUIRE_EQ(GetSlots(index, 6, 5), std::vector<int>{ 2 });
+	REQUIRE(GetSlots(index, 7, 5).empty());
+	REQUIRE_EQ(index.GetNext(5, 5, 1), 3);
+}
+
+TEST_CASE("Move") {
+	EventSpatialIndex index;
+	index.Reset(20, 15, 3);
+
+	index.Update(0, 1, 1);
+	index.Update(1, 1, 1);
+	index.Update(2, 1, 1);
+
+	index.Update(1, 2, 1);
+	REQUIRE_EQ(GetSlots(index, 1, 1), std::vector<int>{ 0, 2 });
+	REQUIRE_EQ(GetSlots(index, 2, 1), std::vector<int>{ 1 });
+
+	index.Update(1, 1, 1);
+	REQUIRE_EQ(GetSlots(index, 1, 1), std::vector<int>{ 0, 1, 2 });
+	REQUIRE(GetSlots(index, 2, 1).empty());
+}
+
+TEST_CASE("OutsideOfGrid") {
+	EventSpatialIndex index;
+	index.Reset(20, 15, 2);
+
+	index.Update(0, 3, 3);
+	index.Update(0, -1, 3);
+	index.Update(1, 20, 0);
+
+	REQUIRE(GetSlots(index, 3, 3).empty());
+	REQUIRE_FALSE(index.IsInGrid(-1, 3));
+	REQUIRE_EQ(index.GetNext(-1, 3, -1), -1);
+
+	index.Update(0, 19, 14);
+	REQUIRE_EQ(GetSlots(index, 19, 14), std::vector<int>{ 0 });
+
+	// Invalid slots are ignored
+	index.Update(2, 0, 0);
+	REQUIRE(GetSlots(index, 0, 0).empty());
+}
+
+TEST_SUITE_END();
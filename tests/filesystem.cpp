@@ -1,4 +1,11 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
 #include "filesystem.h"
+#include "filesystem_native.h"
+#include "platform.h"
 #include "filefinder.h"
 #include "main_data.h"
 #include "doctest.h"
@@ -88,4 +95,70 @@ TEST_CASE("FindFile") {
 	Player::escape_symbol = "";
 }
 
+TEST_CASE("AssetIndex") {
+	Player::escape_symbol = "\\";
+
+	auto native = std::make_shared<NativeFilesystem>("", FilesystemView());
+	auto fs = native->Subtree(EP_TEST_PATH "/game");
+	REQUIRE(fs.ListDirectory("Charset"));
+
+	std::stringstream index;
+	int written = native->SaveIndex(index);
+	CHECK(written >= 1);
+
+	// Restore into a filesystem that never listed the directories
+	auto native_restored = std::make_shared<NativeFilesystem>("", FilesystemView());
+	CHECK(native_restored->LoadIndex(index) == written);
+
+	auto fs_restored = native_restored->Subtree(EP_TEST_PATH "/game");
+	auto charset = fs_restored.ListDirectory("cHaRsEt");
+	REQUIRE(charset);
+	CHECK(charset->size() == 1);
+	CHECK((*charset)[0].second.name == "chara1.png");
+	CHECK(fs_restored.FindFile("charSET/CharA1.png") == fs.FindFile("charSET/CharA1.png"));
+
+	// Already cached directories are not replaced
+	index.clear();
+	index.seekg(0);
+	CHECK(native_restored->LoadIndex(index) == 0);
+
+	std::stringstream corrupted("EPDIRIDX garbage");
+	CHECK(native_restored->LoadIndex(corrupted) == -1);
+
+	Player::escape_symbol = "";
+}
+
+TEST_CASE("AssetIndexSkipsDirectoriesModifiedAfterListing") {
+	using namespace std::chrono_literals;
+
+	const std::string root = EP_TEST_OUTPUT_PATH "/asset_index";
+	REQUIRE(Platform::File(root + "/stable").MakeDirectory(false));
+	REQUIRE(Platform::File(root + "/touched").MakeDirectory(false));
+
+	// Modification times have a resolution of one second
+	std::this_thread::sleep_for(2s);
+
+	auto native_stable = std::make_shared<NativeFilesystem>("", FilesystemView());
+	REQUIRE(native_stable->Subtree(root).ListDirectory("stable"));
+
+	auto native_touched = std::make_shared<NativeFilesystem>("", FilesystemView());
+	REQUIRE(native_touched->Subtree(root).ListDirectory("touched"));
+
+	// Added right after the listing, in the same second
+	const std::string new_file = root + "/touched/new.txt";
+	std::ofstream(new_file) << "new";
+
+	// Saving later must still detect the modification
+	std::this_thread::sleep_for(2s);
+
+	// Both wrote the listing of the root, only one wrote the listed directory
+	std::stringstream index;
+	int written_stable = native_stable->SaveIndex(index);
+	int written_touched = native_touched->SaveIndex(index);
+	CHECK(written_stable >= 1);
+	CHECK(written_touched == written_stable - 1);
+
+	std::remove(new_file.c_str());
+}
+
 TEST_SUITE_END();
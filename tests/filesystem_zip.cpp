@@ -1,12 +1,157 @@
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <zlib.h>
 #include "filesystem.h"
 #include "filefinder.h"
 #include "main_data.h"
+#include "platform.h"
 #include "doctest.h"
 #include "player.h"
 
 #define ZIP_PATH EP_TEST_PATH "/filesystem/test.zip"
 #define ZIP_FOLDER_PATH EP_TEST_PATH "/filesystem/folder.zip"
 
+namespace {
+	void PutLE(std::string& out, uint32_t value, int bytes) {
+		for (int i = 0; i < bytes; ++i) {
+			out.push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+		}
+	}
+
+	/** Archive in the build directory, deleted when the test ends */
+	struct TempZip {
+		std::string path;
+
+		explicit TempZip(const std::string& name) : path(EP_TEST_OUTPUT_PATH "/" + name + ".zip") {}
+
+		~TempZip() {
+			std::remove(path.c_str());
+		}
+	};
+
+	/** Writes a zip archive with a single entry "large" */
+	void WriteLargeZip(const TempZip& zip_file, const std::string& data, bool compress) {
+		std::string payload = data;
+		if (compress) {
+			z_stream strm = {};
+			deflateInit2(&strm, Z_BEST_SPEED, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+			payload.resize(deflateBound(&strm, data.size()));
+			strm.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+			strm.avail_in = data.size();
+			strm.next_out = reinterpret_cast<Bytef*>(&payload[0]);
+			strm.avail_out = payload.size();
+			deflate(&strm, Z_FINISH);
+			payload.resize(strm.total_out);
+			deflateEnd(&strm);
+		}
+
+		const std::string name = "large";
+		uint32_t crc = crc32(0, reinterpret_cast<const Bytef*>(data.data()), data.size());
+		uint16_t method = compress ? 8 : 0;
+
+		std::string zip;
+		PutLE(zip, 0x04034b50, 4);
+		PutLE(zip, 20, 2);
+		PutLE(zip, 0, 2);
+		PutLE(zip, method, 2);
+		PutLE(zip, 0, 4);
+		PutLE(zip, crc, 4);
+		PutLE(zip, payload.size(), 4);
+		PutLE(zip, data.size(), 4);
+		PutLE(zip, name.size(), 2);
+		PutLE(zip, 0, 2);
+		zip += name;
+		zip += payload;
+
+		uint32_t cd_offset = zip.size();
+		PutLE(zip, 0x02014b50, 4);
+		PutLE(zip, 20, 2);
+		PutLE(zip, 20, 2);
+		PutLE(zip, 0, 2);
+		PutLE(zip, method, 2);
+		PutLE(zip, 0, 4);
+		PutLE(zip, crc, 4);
+		PutLE(zip, payload.size(), 4);
+		PutLE(zip, data.size(), 4);
+		PutLE(zip, name.size(), 2);
+		PutLE(zip, 0, 2);
+		PutLE(zip, 0, 2);
+		PutLE(zip, 0, 2);
+		PutLE(zip, 0, 2);
+		PutLE(zip, 0, 4);
+		PutLE(zip, 0, 4);
+		zip += name;
+		uint32_t cd_size = zip.size() - cd_offset;
+
+		PutLE(zip, 0x06054b50, 4);
+		PutLE(zip, 0, 2);
+		PutLE(zip, 0, 2);
+		PutLE(zip, 1, 2);
+		PutLE(zip, 1, 2);
+		PutLE(zip, cd_size, 4);
+		PutLE(zip, cd_offset, 4);
+		PutLE(zip, 0, 2);
+
+		std::ofstream(zip_file.path, std::ios::binary).write(zip.data(), zip.size());
+	}
+
+	std::string MakeLargeData() {
+		// Mildly compressible text, large enough to be streamed
+		std::string data;
+		uint32_t seed = 12345;
+		while (data.size() < 3 * 1024 * 1024) {
+			seed = seed * 1103515245 + 12345;
+			data += "line " + std::to_string(data.size()) + " " + std::to_string(seed >> 16) + "\n";
+		}
+		return data;
+	}
+
+	void CheckLargeEntry(bool compress) {
+		const std::string data = MakeLargeData();
+		const TempZip zip_file(compress ? "easyrpg_large_deflate" : "easyrpg_large_plain");
+		WriteLargeZip(zip_file, data, compress);
+
+		{
+			auto fs = FileFinder::Root().Create(zip_file.path);
+			REQUIRE(fs);
+			CHECK(fs.GetFilesize("large") == static_cast<int64_t>(data.size()));
+
+			auto is = fs.OpenInputStream("large");
+			REQUIRE(is);
+
+			if (!compress && Platform::MappedFile::IsSupported()) {
+				// Stored entries of a mapped archive are not copied
+				auto view = is.GetData();
+				CHECK(view.size() == data.size());
+			}
+
+			std::string out(data.size(), '\0');
+			is.read(&out[0], out.size());
+			CHECK(is.gcount() == static_cast<std::streamsize>(data.size()));
+			CHECK(out == data);
+
+			// Backward and forward seeks across the whole entry
+			is.clear();
+			std::vector<std::streamoff> offsets = { 17, 2'900'000, 1'000'000, 700'000, 0, 2'100'000, 1'999'000 };
+			for (auto off : offsets) {
+				is.seekg(off, std::ios_base::beg);
+				char buf[64];
+				is.read(buf, sizeof(buf));
+				REQUIRE(is.gcount() == sizeof(buf));
+				CHECK(std::string(buf, sizeof(buf)) == data.substr(off, sizeof(buf)));
+			}
+
+			is.seekg(-10, std::ios_base::end);
+			std::string tail(10, '\0');
+			is.read(&tail[0], tail.size());
+			CHECK(tail == data.substr(data.size() - 10));
+			CHECK(is.get() == EOF);
+		}
+	}
+}
+
 TEST_SUITE_BEGIN("Filesystem ZIP");
 
 TEST_CASE("Create") {
@@ -67,4 +212,12 @@ TEST_CASE("File IO error") {
 	CHECK(!fs.OpenOutputStream("not_supported"));
 }
 
+TEST_CASE("Large file reading: Deflate") {
+	CheckLargeEntry(true);
+}
+
+TEST_CASE("Large file reading: Plain") {
+	CheckLargeEntry(false);
+}
+
 TEST_SUITE_END();
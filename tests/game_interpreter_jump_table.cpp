@@ -0,0 +1,68 @@
+#include "game_interpreter_jump_table.h"
+#include "doctest.h"
+
+using Cmd = lcf::rpg::EventCommand::Code;
+
+static lcf::rpg::EventCommand MakeCommand(Cmd code, int indent, std::vector<int32_t> params = {}) {
+	lcf::rpg::EventCommand com;
+	com.code = static_cast<int>(code);
+	com.indent = indent;
+	com.parameters = lcf::DBArray<int32_t>(params.begin(), params.end());
+	return com;
+}
+
+static std::vector<lcf::rpg::EventCommand> MakeList() {
+	return {
+		MakeCommand(Cmd::Label, 0, { 1 }),          // 0
+		MakeCommand(Cmd::Loop, 0),                  // 1
+		MakeCommand(Cmd::ConditionalBranch, 1),     // 2
+		MakeCommand(Cmd::BreakLoop, 2),             // 3
+		MakeCommand(Cmd::END, 2),                   // 4
+		MakeCommand(Cmd::ElseBranch, 1),            // 5
+		MakeCommand(Cmd::Label, 2, { 2 }),          // 6
+		MakeCommand(Cmd::END, 2),                   // 7
+		MakeCommand(Cmd::EndBranch, 1),             // 8
+		MakeCommand(Cmd::END, 1),                   // 9
+		MakeCommand(Cmd::EndLoop, 0),               // 10
+		MakeCommand(Cmd::Label, 0, { 1 }),          // 11
+		MakeCommand(Cmd::END, 0),                   // 12
+	};
+}
+
+TEST_SUITE_BEGIN("Game_Interpreter_JumpTable");
+
+TEST_CASE("FindLabel") {
+	Game_Interpreter_JumpTable table(MakeList());
+
+	REQUIRE_EQ(table.GetSize(), 13);
+	REQUIRE_EQ(table.FindLabel(1), 0);
+	REQUIRE_EQ(table.FindLabel(2), 6);
+	REQUIRE_EQ(table.FindLabel(3), -1);
+}
+
+TEST_CASE("FindNext") {
+	Game_Interpreter_JumpTable table(MakeList());
+
+	REQUIRE_EQ(table.FindNext(2, { Cmd::ElseBranch, Cmd::EndBranch }, 1), 5);
+	REQUIRE_EQ(table.FindNext(5, { Cmd::ElseBranch, Cmd::EndBranch }, 1), 8);
+	REQUIRE_EQ(table.FindNext(3, { Cmd::EndLoop }, 0), 10);
+	REQUIRE_EQ(table.FindNext(1, { Cmd::ShowChoice }, 0), 13);
+}
+
+TEST_CASE("FindPrev") {
+	Game_Interpreter_JumpTable table(MakeList());
+
+	REQUIRE_EQ(table.FindPrev(10, Cmd::Loop, 0), 1);
+	// Leaving the scope returns the less indented command
+	REQUIRE_EQ(table.FindPrev(8, Cmd::Loop, 1), 1);
+	REQUIRE_EQ(table.FindPrev(0, Cmd::Loop, 0), -1);
+}
+
+TEST_CASE("FindNextEndLoop") {
+	Game_Interpreter_JumpTable table(MakeList());
+
+	REQUIRE_EQ(table.FindNextEndLoop(3), 10);
+	REQUIRE_EQ(table.FindNextEndLoop(10), 13);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,152 @@
+#include "game_map.h"
+#include "game_event.h"
+#include "game_party.h"
+#include "game_switches.h"
+#include "game_variables.h"
+#include "main_data.h"
+#include "doctest.h"
+
+#include "mock_game.h"
+
+TEST_SUITE_BEGIN("Game_Map_Refresh");
+
+namespace {
+
+// Keeps the pages of all events inactive while it is off
+constexpr int blocked_switch = 100;
+
+enum EventId {
+	eSwitch = 1,
+	eVariable,
+	eItem
+};
+
+lcf::rpg::Event MakeEvent(int id) {
+	lcf::rpg::Event event;
+	event.ID = id;
+	event.x = id;
+	event.pages.push_back({});
+
+	auto& page = event.pages.back();
+	page.ID = 1;
+	auto& cond = page.condition;
+	cond.flags.switch_b = true;
+	cond.switch_b_id = blocked_switch;
+	return event;
+}
+
+// The events depend on switch 1, variable 1 and item 1
+void SetupMap() {
+	lcf::Data::items.resize(2);
+	lcf::Data::items[0].ID = 1;
+	lcf::Data::items[1].ID = 2;
+
+	auto map = MakeMockMap(MockMap::ePass40x30);
+	map->events.clear();
+
+	map->events.push_back(MakeEvent(eSwitch));
+	map->events.back().pages[0].condition.flags.switch_a = true;
+	map->events.back().pages[0].condition.switch_a_id = 1;
+
+	map->events.push_back(MakeEvent(eVariable));
+	map->events.back().pages[0].condition.flags.variable = true;
+	map->events.back().pages[0].condition.variable_id = 1;
+	map->events.back().pages[0].condition.variable_value = 100;
+
+	map->events.push_back(MakeEvent(eItem));
+	map->events.back().pages[0].condition.flags.item = true;
+	map->events.back().pages[0].condition.item_id = 1;
+
+	Game_Map::Setup(std::move(map));
+	Game_Map::Refresh();
+}
+
+/**
+ * Refreshes the map and returns the events that were refreshed.
+ * Refreshing an event without an active page makes it passable, so the
+ * flag is cleared before the refresh.
+ */
+std::vector<int> Refresh() {
+	for (int id = eSwitch; id <= eItem; ++id) {
+		Game_Map::GetEvent(id)->SetThrough(false);
+	}
+
+	Game_Map::Refresh();
+
+	std::vector<int> refreshed;
+	for (int id = eSwitch; id <= eItem; ++id) {
+		if (Game_Map::GetEvent(id)->GetThrough()) {
+			refreshed.push_back(id);
+		}
+	}
+	return refreshed;
+}
+
+}
+
+TEST_CASE("FirstRefreshEvaluatesAllEvents") {
+	MockGame mg(MockMap::ePass40x30);
+	SetupMap();
+
+	for (int id = eSwitch; id <= eItem; ++id) {
+		REQUIRE(Game_Map::GetEvent(id)->GetThrough());
+		REQUIRE_EQ(Game_Map::GetEvent(id)->GetActivePage(), nullptr);
+	}
+}
+
+TEST_CASE("SwitchRefreshesDependentEvents") {
+	MockGame mg(MockMap::ePass40x30);
+	SetupMap();
+
+	Main_Data::game_switches->Set(1, true);
+	REQUIRE_EQ(Refresh(), std::vector<int>{ eSwitch });
+
+	// Nothing changed since the last refresh
+	REQUIRE(Refresh().empty());
+
+	// All events depend on the blocked switch, only eSwitch meets all conditions
+	Main_Data::game_switches->Set(blocked_switch, true);
+	Game_Map::Refresh();
+	REQUIRE_NE(Game_Map::GetEvent(eSwitch)->GetActivePage(), nullptr);
+	REQUIRE_EQ(Game_Map::GetEvent(eVariable)->GetActivePage(), nullptr);
+	REQUIRE_EQ(Game_Map::GetEvent(eItem)->GetActivePage(), nullptr);
+
+	Main_Data::game_switches->Set(1, false);
+	Game_Map::Refresh();
+	REQUIRE_EQ(Game_Map::GetEvent(eSwitch)->GetActivePage(), nullptr);
+}
+
+TEST_CASE("VariableRefreshesDependentEvents") {
+	MockGame mg(MockMap::ePass40x30);
+	SetupMap();
+
+	Main_Data::game_variables->Set(1, 5);
+	REQUIRE_EQ(Refresh(), std::vector<int>{ eVariable });
+
+	// Setting the same value is not a change
+	Main_Data::game_variables->Set(1, 5);
+	REQUIRE(Refresh().empty());
+}
+
+TEST_CASE("ItemRefreshesDependentEvents") {
+	MockGame mg(MockMap::ePass40x30);
+	SetupMap();
+
+	Main_Data::game_party->AddItem(1, 1);
+	REQUIRE_EQ(Refresh(), std::vector<int>{ eItem });
+
+	Main_Data::game_party->RemoveItem(1, 1);
+	REQUIRE_EQ(Refresh(), std::vector<int>{ eItem });
+}
+
+TEST_CASE("UnrelatedChangeRefreshesNothing") {
+	MockGame mg(MockMap::ePass40x30);
+	SetupMap();
+
+	Main_Data::game_switches->Set(2, true);
+	Main_Data::game_variables->Set(2, 5);
+	Main_Data::game_party->AddItem(2, 1);
+	REQUIRE(Refresh().empty());
+}
+
+TEST_SUITE_END();
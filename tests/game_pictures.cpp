@@ -0,0 +1,96 @@
+#include "game_pictures.h"
+#include "test_mock_actor.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("Game_Pictures");
+
+static Game_Pictures::ShowParams MakeShowParams(int x) {
+	Game_Pictures::ShowParams params;
+	params.position_x = x;
+	return params;
+}
+
+static Game_Pictures::MoveParams MakeMoveParams(int x, int duration) {
+	Game_Pictures::MoveParams params;
+	params.position_x = x;
+	params.duration = duration;
+	return params;
+}
+
+TEST_CASE("MoveReachesTarget") {
+	const MockActor m;
+
+	Game_Pictures pictures;
+	pictures.Show(1, MakeShowParams(0));
+	pictures.Move(1, MakeMoveParams(100, -4));
+
+	auto& pic = pictures.GetPicture(1);
+	for (int i = 0; i < 3; ++i) {
+		pictures.Update(false);
+		REQUIRE_EQ(pic.data.current_x, doctest::Approx(25 * (i + 1)));
+	}
+
+	pictures.Update(false);
+	REQUIRE_EQ(pic.data.current_x, 100);
+	REQUIRE_EQ(pic.data.time_left, 0);
+	REQUIRE(pic.IsIdle());
+	REQUIRE_FALSE(pic.needs_update);
+}
+
+TEST_CASE("RotationKeepsPictureActive") {
+	const MockActor m;
+
+	auto params = MakeShowParams(0);
+	params.effect_mode = lcf::rpg::SavePicture::Effect_rotation;
+	params.effect_power = 10;
+
+	Game_Pictures pictures;
+	pictures.Show(1, params);
+
+	auto& pic = pictures.GetPicture(1);
+	for (int i = 0; i < 5; ++i) {
+		pictures.Update(false);
+	}
+	REQUIRE(pic.needs_update);
+	REQUIRE_EQ(pic.data.current_rotation, 50);
+}
+
+TEST_CASE("IdlePicturesCountFrames") {
+	const MockActor m;
+
+	Game_Pictures pictures;
+	pictures.Show(1, MakeShowParams(0));
+	pictures.Show(3, MakeShowParams(0));
+
+	for (int i = 0; i < 10; ++i) {
+		pictures.Update(false);
+	}
+	// Pictures are not on the battle layer
+	pictures.Update(true);
+
+	REQUIRE_FALSE(pictures.GetPicture(1).needs_update);
+
+	auto save = pictures.GetSaveData();
+	REQUIRE_EQ(save[0].frames, 10);
+	REQUIRE_EQ(save[2].frames, 10);
+
+	pictures.Move(1, MakeMoveParams(10, 0));
+	pictures.Update(false);
+	REQUIRE_EQ(pictures.GetPicture(1).data.frames, 11);
+	REQUIRE_EQ(pictures.GetSaveData()[0].frames, 11);
+}
+
+TEST_CASE("IdlePicturesCountNoFramesIn2k3Legacy") {
+	const MockActor m(Player::EngineRpg2k3);
+
+	Game_Pictures pictures;
+	pictures.Show(1, MakeShowParams(0));
+
+	for (int i = 0; i < 10; ++i) {
+		pictures.Update(false);
+	}
+
+	REQUIRE_EQ(pictures.GetSaveData()[0].frames, 0);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,95 @@
+#include "glyph_atlas.h"
+#include "bitmap.h"
+#include "pixel_format.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("GlyphAtlas");
+
+static Font::GlyphRet MakeGlyph(int width, int height, int advance) {
+	Font::GlyphRet ret;
+	ret.bitmap = Bitmap::Create(width, height, Color(255, 255, 255, 255));
+	ret.advance = { advance, 0 };
+	return ret;
+}
+
+TEST_CASE("FindInserted") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	GlyphAtlas atlas(32, 32);
+
+	const auto key = GlyphAtlas::MakeKey(U'A', false, 12);
+	Font::GlyphRet ret;
+	REQUIRE_FALSE(atlas.Find(key, ret));
+
+	auto glyph = MakeGlyph(6, 12, 6);
+	REQUIRE(atlas.Insert(key, glyph));
+	REQUIRE_EQ(glyph.rect, Rect(0, 0, 6, 12));
+
+	REQUIRE(atlas.Find(key, ret));
+	REQUIRE_EQ(ret.bitmap, glyph.bitmap);
+	REQUIRE_EQ(ret.rect, glyph.rect);
+	REQUIRE_EQ(ret.advance, Point(6, 0));
+	REQUIRE_EQ(ret.bitmap->GetColorAt(ret.rect.x, ret.rect.y), Color(255, 255, 255, 255));
+
+	// Other size or shaped glyph index are different glyphs
+	REQUIRE_FALSE(atlas.Find(GlyphAtlas::MakeKey(U'A', false, 16), ret));
+	REQUIRE_FALSE(atlas.Find(GlyphAtlas::MakeKey(U'A', true, 12), ret));
+
+	auto stats = atlas.GetStats();
+	REQUIRE_EQ(stats.hits, 1);
+	REQUIRE_EQ(stats.misses, 3);
+	REQUIRE_EQ(stats.entries, 1);
+}
+
+TEST_CASE("EvictsLeastRecentlyUsedShelf") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	// Two shelves of 12 pixel glyphs with two glyphs each
+	GlyphAtlas atlas(24, 24);
+
+	for (char32_t ch = U'A'; ch < U'E'; ++ch) {
+		auto glyph = MakeGlyph(12, 12, 12);
+		REQUIRE(atlas.Insert(GlyphAtlas::MakeKey(ch, false, 12), glyph));
+	}
+
+	// The shelf with A and B becomes the most recently used
+	Font::GlyphRet ret;
+	REQUIRE(atlas.Find(GlyphAtlas::MakeKey(U'A', false, 12), ret));
+
+	auto glyph = MakeGlyph(12, 12, 12);
+	REQUIRE(atlas.Insert(GlyphAtlas::MakeKey(U'E', false, 12), glyph));
+	REQUIRE_EQ(glyph.rect, Rect(0, 12, 12, 12));
+
+	REQUIRE(atlas.Find(GlyphAtlas::MakeKey(U'A', false, 12), ret));
+	REQUIRE(atlas.Find(GlyphAtlas::MakeKey(U'B', false, 12), ret));
+	REQUIRE_FALSE(atlas.Find(GlyphAtlas::MakeKey(U'C', false, 12), ret));
+	REQUIRE_FALSE(atlas.Find(GlyphAtlas::MakeKey(U'D', false, 12), ret));
+
+	auto stats = atlas.GetStats();
+	REQUIRE_EQ(stats.evictions, 1);
+	REQUIRE_EQ(stats.entries, 3);
+}
+
+TEST_CASE("TooLarge") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	GlyphAtlas atlas(16, 16);
+
+	auto glyph = MakeGlyph(24, 24, 24);
+	REQUIRE_FALSE(atlas.Insert(GlyphAtlas::MakeKey(U'A', false, 24), glyph));
+	REQUIRE_EQ(atlas.GetStats().entries, 0);
+}
+
+TEST_CASE("Sizes") {
+	GlyphAtlas atlas(16, 16);
+
+	const auto key = GlyphAtlas::MakeKey(U'A', false, 12);
+	Rect size;
+	REQUIRE_FALSE(atlas.FindSize(key, size));
+
+	atlas.InsertSize(key, Rect(0, 0, 6, 12));
+	REQUIRE(atlas.FindSize(key, size));
+	REQUIRE_EQ(size, Rect(0, 0, 6, 12));
+
+	atlas.Clear();
+	REQUIRE_FALSE(atlas.FindSize(key, size));
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,68 @@
+#include "instrumentation.h"
+#include "doctest.h"
+#include <cstring>
+
+#ifdef HAVE_THREADS
+#include <thread>
+#endif
+
+TEST_SUITE_BEGIN("Instrumentation");
+
+namespace {
+const Instrumentation::ZoneSummary* FindZone(const std::vector<Instrumentation::ZoneSummary>& summary, const char* name) {
+	for (const auto& zone: summary) {
+		if (std::strcmp(zone.name, name) == 0) {
+			return &zone;
+		}
+	}
+	return nullptr;
+}
+}
+
+TEST_CASE("NestedZones") {
+	Instrumentation::SetProfilerEnabled(true);
+
+	Instrumentation::FrameBegin();
+	{
+		Instrumentation::Zone outer("Outer");
+		Instrumentation::Zone inner("Inner");
+	}
+	Instrumentation::FrameEnd();
+
+	auto summary = Instrumentation::GetProfilerSummary(1);
+	REQUIRE_EQ(summary.size(), 3);
+	REQUIRE_EQ(std::strcmp(summary[0].name, "Frame"), 0);
+	REQUIRE_EQ(FindZone(summary, "Outer")->depth, 0);
+	REQUIRE_EQ(FindZone(summary, "Inner")->depth, 1);
+
+	Instrumentation::SetProfilerEnabled(false);
+}
+
+#ifdef HAVE_THREADS
+TEST_CASE("NestedZonesOnOtherThread") {
+	Instrumentation::SetProfilerEnabled(true);
+
+	Instrumentation::FrameBegin();
+	{
+		Instrumentation::Zone main_zone("Main");
+		std::thread worker([]() {
+			Instrumentation::Zone outer("WorkerOuter");
+			Instrumentation::Zone inner("WorkerInner");
+		});
+		worker.join();
+	}
+	Instrumentation::FrameEnd();
+
+	auto summary = Instrumentation::GetProfilerSummary(1);
+	REQUIRE_EQ(summary.size(), 4);
+	REQUIRE_EQ(FindZone(summary, "Main")->depth, 0);
+	REQUIRE_EQ(FindZone(summary, "WorkerOuter")->depth, 0);
+	REQUIRE_EQ(FindZone(summary, "WorkerInner")->depth, 1);
+	// Zones of other threads are listed after the main thread
+	REQUIRE_EQ(std::strcmp(summary[1].name, "Main"), 0);
+
+	Instrumentation::SetProfilerEnabled(false);
+}
+#endif
+
+TEST_SUITE_END();
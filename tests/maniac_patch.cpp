@@ -0,0 +1,112 @@
+#include "maniac_patch.h"
+#include "game_interpreter.h"
+#include "doctest.h"
+#include <algorithm>
+#include <cstring>
+
+TEST_SUITE_BEGIN("ManiacPatch");
+
+namespace {
+
+// Packs the op code bytes like they are stored in the event command
+std::vector<int32_t> Pack(std::vector<uint8_t> bytes) {
+	while (bytes.size() % 4 != 0) {
+		bytes.push_back(0);
+	}
+	std::vector<int32_t> ops(bytes.size() / 4);
+	std::memcpy(ops.data(), bytes.data(), bytes.size());
+	return ops;
+}
+
+constexpr uint8_t U8 = 1;
+constexpr uint8_t U16 = 2;
+constexpr uint8_t S32 = 3;
+constexpr uint8_t Var = 8;
+constexpr uint8_t Negate = 24;
+constexpr uint8_t Add = 48;
+constexpr uint8_t Sub = 49;
+constexpr uint8_t Mul = 50;
+constexpr uint8_t Div = 51;
+constexpr uint8_t Less = 62;
+constexpr uint8_t Ternary = 72;
+constexpr uint8_t Function = 78;
+constexpr uint8_t FnPow = 7;
+constexpr uint8_t FnMin = 12;
+
+}
+
+TEST_CASE("ConstantFolding") {
+	Game_Interpreter ip;
+
+	// (1 + 2) * -3
+	auto ops = Pack({ Mul, Add, U8, 1, U8, 2, Negate, U8, 3 });
+	auto expr = ManiacPatch::CompileExpression(MakeSpan(ops));
+	REQUIRE_EQ(expr.code.size(), 1);
+	REQUIRE_EQ(expr.code[0].op, ManiacPatch::Expression::OpCode::Push);
+	REQUIRE_EQ(expr.code[0].value, -9);
+
+	REQUIRE_EQ(ManiacPatch::EvaluateExpression(expr, ip), -9);
+	REQUIRE_EQ(ManiacPatch::ParseExpression(MakeSpan(ops), ip), -9);
+	REQUIRE_EQ(ManiacPatch::InterpretExpression(MakeSpan(ops), ip), -9);
+}
+
+TEST_CASE("FunctionArguments") {
+	Game_Interpreter ip;
+
+	// pow(2, 10) - min(300, 0x1234)
+	auto ops = Pack({ Sub, Function, FnPow, 2, U8, 2, U8, 10, Function, FnMin, 2, U16, 0x2C, 0x01, U16, 0x34, 0x12 });
+	REQUIRE_EQ(ManiacPatch::ParseExpression(MakeSpan(ops), ip), 1024 - 300);
+	REQUIRE_EQ(ManiacPatch::InterpretExpression(MakeSpan(ops), ip), 1024 - 300);
+}
+
+TEST_CASE("TernaryAndDivision") {
+	Game_Interpreter ip;
+
+	// 1 < 2 ? 7 / 0 : 3
+	auto ops = Pack({ Ternary, Less, U8, 1, U8, 2, Div, U8, 7, U8, 0, U8, 3 });
+	REQUIRE_EQ(ManiacPatch::ParseExpression(MakeSpan(ops), ip), 7);
+	REQUIRE_EQ(ManiacPatch::InterpretExpression(MakeSpan(ops), ip), 7);
+}
+
+TEST_CASE("VariablesAreNotFolded") {
+	// v[5] + (1 + 2)
+	auto ops = Pack({ Add, Var, U8, 5, Add, U8, 1, U8, 2 });
+	auto expr = ManiacPatch::CompileExpression(MakeSpan(ops));
+
+	using OpCode = ManiacPatch::Expression::OpCode;
+	REQUIRE_EQ(expr.code.size(), 4);
+	REQUIRE_EQ(expr.code[0].op, OpCode::Push);
+	REQUIRE_EQ(expr.code[1].op, OpCode::Var);
+	REQUIRE_EQ(expr.code[2].op, OpCode::Push);
+	REQUIRE_EQ(expr.code[2].value, 3);
+	REQUIRE_EQ(expr.code[3].op, OpCode::Add);
+	REQUIRE_GE(expr.stack_size, 2);
+}
+
+TEST_CASE("Truncated") {
+	Game_Interpreter ip;
+
+	// The last byte of the S32 is missing
+	auto ops = Pack({ S32, 1, 2, 3 });
+	REQUIRE_EQ(ManiacPatch::ParseExpression(MakeSpan(ops), ip), 0);
+	REQUIRE_EQ(ManiacPatch::InterpretExpression(MakeSpan(ops), ip), 0);
+}
+
+TEST_CASE("CacheDetectsChangedCommand") {
+	Game_Interpreter ip;
+
+	auto ops = Pack({ Add, U8, 1, U8, 2 });
+	REQUIRE_EQ(ManiacPatch::ParseExpression(MakeSpan(ops), ip), 3);
+
+	// Same memory, other expression
+	const auto* data = ops.data();
+	auto other = Pack({ Sub, U8, 1, U8, 2 });
+	REQUIRE_EQ(other.size(), ops.size());
+	std::copy(other.begin(), other.end(), ops.begin());
+	REQUIRE_EQ(ops.data(), data);
+	REQUIRE_EQ(ManiacPatch::ParseExpression(MakeSpan(ops), ip), -1);
+
+	ManiacPatch::ClearExpressionCache();
+}
+
+TEST_SUITE_END();
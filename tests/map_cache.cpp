@@ -0,0 +1,85 @@
+#include "map_cache.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("MapCache");
+
+static lcf::rpg::Map MakeMap(int width) {
+	lcf::rpg::Map map;
+	map.width = width;
+	map.height = 15;
+	return map;
+}
+
+static lcf::rpg::EventCommand MakeTeleport(int map_id) {
+	lcf::rpg::EventCommand com;
+	com.code = static_cast<int>(lcf::rpg::EventCommand::Code::Teleport);
+	std::vector<int32_t> params = { map_id, 1, 2, 0 };
+	com.parameters = lcf::DBArray<int32_t>(params.begin(), params.end());
+	return com;
+}
+
+TEST_CASE("GetReturnsCopy") {
+	MapCache::Clear();
+
+	REQUIRE_FALSE(MapCache::Get(1));
+
+	MapCache::Add(1, MakeMap(20));
+	REQUIRE(MapCache::Contains(1));
+
+	auto map = MapCache::Get(1);
+	REQUIRE(map);
+	REQUIRE_EQ(map->width, 20);
+
+	// Modifying the returned map does not change the cache
+	map->width = 30;
+	auto map2 = MapCache::Get(1);
+	REQUIRE(map2);
+	REQUIRE_EQ(map2->width, 20);
+
+	MapCache::Clear();
+	REQUIRE_FALSE(MapCache::Contains(1));
+}
+
+TEST_CASE("EvictsLeastRecentlyUsed") {
+	MapCache::Clear();
+
+	for (int i = 1; i <= MapCache::max_entries; ++i) {
+		MapCache::Add(i, MakeMap(i));
+	}
+
+	// Map 1 becomes the most recently used, map 2 is evicted next
+	REQUIRE(MapCache::Get(1));
+	MapCache::Add(MapCache::max_entries + 1, MakeMap(1));
+
+	REQUIRE(MapCache::Contains(1));
+	REQUIRE_FALSE(MapCache::Contains(2));
+	REQUIRE(MapCache::Contains(MapCache::max_entries + 1));
+	REQUIRE_EQ(MapCache::GetStats().entries, MapCache::max_entries);
+
+	MapCache::Clear();
+}
+
+TEST_CASE("TeleportTargets") {
+	lcf::rpg::Map map;
+
+	lcf::rpg::Event ev;
+	lcf::rpg::EventPage page;
+	page.event_commands.push_back(MakeTeleport(3));
+	page.event_commands.push_back(MakeTeleport(5));
+	// Teleport to the same map
+	page.event_commands.push_back(MakeTeleport(7));
+	page.event_commands.push_back(MakeTeleport(3));
+	ev.pages.push_back(page);
+	map.events.push_back(ev);
+
+	lcf::rpg::Event ev2;
+	lcf::rpg::EventPage page2;
+	page2.event_commands.push_back(MakeTeleport(2));
+	ev2.pages.push_back(page2);
+	map.events.push_back(ev2);
+
+	auto targets = MapCache::GetTeleportTargets(map, 7);
+	REQUIRE_EQ(targets, std::vector<int>{ 3, 5, 2 });
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,108 @@
+#include "system.h"
+
+#ifdef WANT_FMMIDI
+
+#include "midisynth.h"
+#include "doctest.h"
+#include <vector>
+
+using namespace midisynth;
+
+TEST_SUITE_BEGIN("MidiSynth");
+
+TEST_CASE("RenderMatchesGetNext") {
+	for (int alg = 0; alg < 8; ++alg) {
+		for (int flags = 0; flags < 8; ++flags) {
+			int ams = (flags & 1) ? 2 : 0;
+			FMPARAMETER p = { alg, 5, 3,
+				{ 31, 5, 2, 7, 3, 10, 1, 2, 1, ams },
+				{ 28, 4, 3, 6, 2, 20, 0, 1, 2, ams },
+				{ 25, 3, 1, 8, 4, 5, 2, 3, 0, 0 },
+				{ 30, 6, 2, 9, 1, 0, 1, 1, 0, ams }
+			};
+
+			fm_sound_generator per_sample(p, 60, 1.0f);
+			fm_sound_generator batched(p, 60, 1.0f);
+			for (auto* gen: { &per_sample, &batched }) {
+				gen->set_rate(44100);
+				if (flags & 2) {
+					gen->set_vibrato(0.5f, 5);
+				}
+				if (flags & 4) {
+					gen->set_tremolo(60, 4);
+				}
+			}
+
+			// Covers attack, decay, release and sound off
+			std::vector<int> expected(3000);
+			std::vector<int> actual(3000);
+			for (size_t i = 0; i < expected.size(); i += 100) {
+				if (i == 1000) {
+					per_sample.key_off();
+					batched.key_off();
+				} else if (i == 2000) {
+					per_sample.sound_off();
+					batched.sound_off();
+				}
+				for (size_t j = i; j < i + 100; ++j) {
+					expected[j] = per_sample.get_next();
+				}
+				batched.render(&actual[i], 100);
+			}
+
+			CAPTURE(alg);
+			CAPTURE(flags);
+			CHECK(expected == actual);
+		}
+	}
+}
+
+TEST_CASE("VoiceLimit") {
+	fm_note_factory factory;
+	synthesizer synth(&factory);
+	synth.set_voice_limit(8);
+
+	for (int i = 0; i < 40; ++i) {
+		synth.note_on(i % 8, 40 + i, 100);
+		REQUIRE(synth.get_num_notes() <= 8);
+	}
+	CHECK_EQ(synth.get_num_notes(), 8);
+
+	std::vector<int_least16_t> out(2 * 1024);
+	CHECK_EQ(synth.synthesize(out.data(), 1024, 44100), 8);
+}
+
+TEST_CASE("VoiceStealPrefersReleasedNotes") {
+	fm_note_factory factory;
+	synthesizer synth(&factory);
+	synth.set_voice_limit(2);
+
+	synth.note_on(0, 60, 100);
+	synth.note_on(1, 62, 100);
+	synth.note_off(0, 60, 64);
+	synth.note_on(1, 64, 100);
+
+	CHECK_EQ(synth.get_channel(0)->get_num_notes(), 0);
+	CHECK_EQ(synth.get_channel(1)->get_num_notes(), 2);
+}
+
+TEST_CASE("PoolExhaustion") {
+	fm_note_factory factory;
+	synthesizer synth(&factory);
+	synth.set_voice_limit(1000);
+
+	for (int i = 0; i < 300; ++i) {
+		synth.note_on(i % 8, i % 128, 100);
+	}
+	CHECK_EQ(synth.get_num_notes(), 128);
+
+	synth.all_sound_off_immediately();
+	CHECK_EQ(synth.get_num_notes(), 0);
+
+	synth.note_on(0, 60, 100);
+	CHECK_EQ(synth.get_num_notes(), 1);
+}
+
+TEST_SUITE_END();
+
+#endif
@@ -42,6 +42,28 @@ TEST_CASE("GetSize") {
 	CHECK(Platform::File(bad).GetSize() == -1);
 }
 
+TEST_CASE("GetModificationTime") {
+	CHECK(Platform::File(onekb).GetModificationTime() > 0);
+	CHECK(Platform::File(folder).GetModificationTime() > 0);
+	CHECK(Platform::File(bad).GetModificationTime() == -1);
+}
+
+TEST_CASE("MappedFile") {
+	if (!Platform::MappedFile::IsSupported()) {
+		CHECK(!Platform::MappedFile(onekb));
+		return;
+	}
+
+	Platform::MappedFile file(onekb);
+	REQUIRE(file);
+	CHECK(file.GetSize() == 1024);
+	CHECK(file.GetData() != nullptr);
+
+	CHECK(!Platform::MappedFile(empty));
+	CHECK(!Platform::MappedFile(folder));
+	CHECK(!Platform::MappedFile(bad));
+}
+
 TEST_CASE("ReadDirectory") {
 	Platform::Directory dir(EP_TEST_PATH "/platform");
 
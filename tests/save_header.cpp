@@ -0,0 +1,63 @@
+#include <sstream>
+#include <lcf/lsd/reader.h>
+#include "save_header.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("SaveHeader");
+
+static lcf::rpg::Save make_save() {
+	lcf::rpg::Save save;
+	save.title.timestamp = 44000.5;
+	save.title.hero_name = "Alex";
+	save.title.hero_level = 12;
+	save.title.hero_hp = 345;
+	save.title.face1_name = "Actor1";
+	save.title.face1_id = 3;
+	save.title.face4_name = "Actor2";
+	save.title.face4_id = 7;
+	save.system.save_count = 5;
+	save.party_location.map_id = 2;
+	return save;
+}
+
+static std::string write_save(const lcf::rpg::Save& save) {
+	std::stringstream ss;
+	REQUIRE(lcf::LSD_Reader::Save(ss, save, lcf::EngineVersion::e2k3, "1252"));
+	return ss.str();
+}
+
+TEST_CASE("ReadTitle") {
+	auto save = make_save();
+	std::istringstream is(write_save(save));
+
+	auto title = SaveHeader::ReadTitle(is, "1252");
+	REQUIRE(title);
+	REQUIRE_EQ(*title, save.title);
+}
+
+TEST_CASE("ReadTitleIgnoresRestOfSave") {
+	auto save = make_save();
+	auto data = write_save(save);
+
+	// The save is broken but the title in front of it is intact
+	std::istringstream is(data.substr(0, data.size() - 1));
+
+	auto title = SaveHeader::ReadTitle(is, "1252");
+	REQUIRE(title);
+	REQUIRE_EQ(title->hero_name, "Alex");
+}
+
+TEST_CASE("ReadTitleInvalid") {
+	std::istringstream empty("");
+	REQUIRE_FALSE(SaveHeader::ReadTitle(empty, "1252"));
+
+	std::istringstream not_a_save(std::string("\x0b" "LcfMapUnit\x01\x00", 14));
+	REQUIRE_FALSE(SaveHeader::ReadTitle(not_a_save, "1252"));
+
+	// Truncated inside the title
+	auto data = write_save(make_save());
+	std::istringstream truncated(data.substr(0, 20));
+	REQUIRE_FALSE(SaveHeader::ReadTitle(truncated, "1252"));
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,64 @@
+#include "simulation_thread.h"
+#include "output.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("SimulationThread");
+
+TEST_CASE("RunsStepsUntilFalse") {
+	SimulationThread::Init();
+
+	int count = 0;
+	SimulationThread::Run([&count]() { return ++count < 5; });
+
+	REQUIRE_EQ(SimulationThread::Wait(), 4);
+	REQUIRE_EQ(count, 5);
+	REQUIRE(SimulationThread::TakeError().empty());
+
+	SimulationThread::Quit();
+}
+
+TEST_CASE("AbortStopsBatch") {
+	SimulationThread::Init();
+
+	int count = 0;
+	SimulationThread::Run([&count]() {
+		if (++count == 3) {
+			SimulationThread::Abort("step failed");
+		}
+		return true;
+	});
+
+	REQUIRE_EQ(SimulationThread::Wait(), 2);
+	REQUIRE_EQ(count, 3);
+	REQUIRE_EQ(SimulationThread::TakeError(), "step failed");
+	REQUIRE(SimulationThread::TakeError().empty());
+
+	SimulationThread::Quit();
+}
+
+#ifdef HAVE_THREADS
+TEST_CASE("ErrorIsRaisedOnMainThread") {
+	SimulationThread::Init();
+
+	bool ran_on_main_thread = false;
+	SimulationThread::Run([&ran_on_main_thread]() -> bool {
+		SimulationThread::RunOnMainThread([&ran_on_main_thread]() {
+			ran_on_main_thread = !SimulationThread::IsCurrentThread();
+		});
+		Output::Error("Event {} failed", 7);
+	});
+
+	REQUIRE_EQ(SimulationThread::Wait(), 0);
+	REQUIRE(ran_on_main_thread);
+	REQUIRE_EQ(SimulationThread::TakeError(), "Event 7 failed");
+
+	// The thread survives the error
+	int count = 0;
+	SimulationThread::Run([&count]() { return ++count < 2; });
+	REQUIRE_EQ(SimulationThread::Wait(), 1);
+
+	SimulationThread::Quit();
+}
+#endif
+
+TEST_SUITE_END();
@@ -0,0 +1,62 @@
+#include "task_graph.h"
+#include "doctest.h"
+#include <atomic>
+#include <thread>
+
+TEST_SUITE_BEGIN("TaskGraph");
+
+TEST_CASE("RunsInDependencyOrder") {
+	WorkerPool pool(2);
+	TaskGraph graph(pool);
+
+	std::atomic<int> a { 0 };
+	std::atomic<int> b { 0 };
+	int sum = 0;
+
+	auto ta = graph.Add("A", TaskGraph::Affinity::Worker, {}, [&]() { a = 1; });
+	auto tb = graph.Add("B", TaskGraph::Affinity::Worker, {}, [&]() { b = 2; });
+	auto tc = graph.Add("C", TaskGraph::Affinity::Main, { ta, tb }, [&]() { sum = a + b; });
+	graph.Add("D", TaskGraph::Affinity::Worker, { tc }, [&]() { sum *= 10; });
+
+	graph.Run();
+
+	REQUIRE_EQ(sum, 30);
+
+	const auto& timeline = graph.GetTimeline();
+	REQUIRE_EQ(timeline.size(), 4);
+	REQUIRE(timeline[tc].begin_ms >= timeline[ta].end_ms);
+	REQUIRE(timeline[tc].begin_ms >= timeline[tb].end_ms);
+	REQUIRE(timeline[3].begin_ms >= timeline[tc].end_ms);
+	REQUIRE(graph.GetDuration() >= timeline[3].end_ms);
+}
+
+TEST_CASE("MainTasksRunOnCallingThread") {
+	WorkerPool pool(2);
+	TaskGraph graph(pool);
+
+	const auto caller = std::this_thread::get_id();
+	std::atomic<int> on_caller { 0 };
+
+	auto count_main = [&]() { on_caller += std::this_thread::get_id() == caller; };
+
+	auto last = graph.Add("Main", TaskGraph::Affinity::Main, {}, count_main);
+	for (int i = 0; i < 7; ++i) {
+		auto worker = graph.Add("Worker", TaskGraph::Affinity::Worker, {}, []() {});
+		last = graph.Add("Main", TaskGraph::Affinity::Main, { worker, last }, count_main);
+	}
+
+	graph.Run();
+
+	REQUIRE_EQ(on_caller.load(), 8);
+}
+
+TEST_CASE("EmptyGraph") {
+	WorkerPool pool(1);
+	TaskGraph graph(pool);
+
+	graph.Run();
+
+	REQUIRE(graph.GetTimeline().empty());
+}
+
+TEST_SUITE_END();
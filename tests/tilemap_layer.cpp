@@ -0,0 +1,165 @@
+#include "tilemap_layer.h"
+#include "bitmap.h"
+#include "drawable_list.h"
+#include "drawable_mgr.h"
+#include "game_map.h"
+#include "map_data.h"
+#include "pixel_format.h"
+#include "player.h"
+#include "doctest.h"
+#include <cstring>
+
+#include "mock_game.h"
+
+TEST_SUITE_BEGIN("TilemapLayer");
+
+namespace {
+
+constexpr int map_w = 40;
+constexpr int map_h = 30;
+
+BitmapRef MakeChipset() {
+	// Every tile of the chipset has its own color
+	auto chipset = Bitmap::Create(480, 256, true);
+	for (int y = 0; y < 256 / TILE_SIZE; ++y) {
+		for (int x = 0; x < 480 / TILE_SIZE; ++x) {
+			chipset->FillRect(Rect(x * TILE_SIZE, y * TILE_SIZE, TILE_SIZE, TILE_SIZE),
+				Color(x * 8, y * 16, (x + y) * 4, 255));
+		}
+	}
+	chipset->CheckPixels(Bitmap::Flag_Chipset);
+	return chipset;
+}
+
+// Static (D, E) and animated (A, B, C) tiles
+std::vector<short> MakeMapData() {
+	std::vector<short> data(map_w * map_h);
+	for (int i = 0; i < map_w * map_h; ++i) {
+		switch (i % 4) {
+			case 0:
+				data[i] = BLOCK_E + i % BLOCK_E_TILES;
+				break;
+			case 1:
+				data[i] = BLOCK_D + (i / 4 % BLOCK_D_TILES) * BLOCK_D_STRIDE + i % BLOCK_D_STRIDE;
+				break;
+			case 2:
+				data[i] = BLOCK_C + (i / 4 % BLOCK_C_TILES) * BLOCK_C_STRIDE;
+				break;
+			default:
+				data[i] = (i / 4 % BLOCK_A_TILES) * BLOCK_A_STRIDE + i % 47;
+				break;
+		}
+	}
+	return data;
+}
+
+std::unique_ptr<TilemapLayer> MakeLayer(std::vector<short> data, int ox, int oy) {
+	auto layer = std::make_unique<TilemapLayer>(0);
+	layer->SetWidth(map_w);
+	layer->SetHeight(map_h);
+	layer->SetChipset(MakeChipset());
+	layer->SetMapData(std::move(data));
+	layer->SetOx(ox);
+	layer->SetOy(oy);
+	return layer;
+}
+
+BitmapRef DrawChunked(TilemapLayer& layer) {
+	auto dst = Bitmap::Create(Player::screen_width, Player::screen_height, Color(0, 0, 0, 255));
+	layer.Draw(*dst, TilemapLayer::TileBelow, 0, 0);
+	return dst;
+}
+
+// In the frame of a tone change the tiles are drawn one by one without the chunks
+BitmapRef DrawPerTile(TilemapLayer& layer) {
+	layer.SetTone(Tone(128, 128, 128, 0));
+	layer.SetTone(Tone());
+	return DrawChunked(layer);
+}
+
+bool Equal(const Bitmap& l, const Bitmap& r) {
+	return std::memcmp(l.pixels(), r.pixels(), l.pitch() * l.height()) == 0;
+}
+
+void SetupMap(int scroll_type) {
+	auto map = MakeMockMap(MockMap::ePass40x30);
+	map->scroll_type = scroll_type;
+	Game_Map::Setup(std::move(map));
+}
+
+}
+
+TEST_CASE("ChunksMatchTiles") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	DrawableList list;
+	DrawableMgr::SetLocalList(&list);
+	MockGame mg(MockMap::ePass40x30);
+
+	SUBCASE("inside the map") {
+		auto chunked = MakeLayer(MakeMapData(), 3 * TILE_SIZE + 5, 2 * TILE_SIZE + 7);
+		auto per_tile = MakeLayer(MakeMapData(), 3 * TILE_SIZE + 5, 2 * TILE_SIZE + 7);
+
+		REQUIRE(Equal(*DrawChunked(*chunked), *DrawPerTile(*per_tile)));
+	}
+
+	SUBCASE("across the map border") {
+		auto chunked = MakeLayer(MakeMapData(), (map_w - 8) * TILE_SIZE + 3, -4 * TILE_SIZE - 9);
+		auto per_tile = MakeLayer(MakeMapData(), (map_w - 8) * TILE_SIZE + 3, -4 * TILE_SIZE - 9);
+
+		REQUIRE(Equal(*DrawChunked(*chunked), *DrawPerTile(*per_tile)));
+	}
+}
+
+TEST_CASE("ChunksOfLoopingMap") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	DrawableList list;
+	DrawableMgr::SetLocalList(&list);
+	MockGame mg(MockMap::ePass40x30);
+	SetupMap(lcf::rpg::Map::ScrollType_both);
+
+	// The screen shows the right and bottom edge and wraps to the left and top edge
+	const int ox = (map_w - 5) * TILE_SIZE + 8;
+	const int oy = (map_h - 3) * TILE_SIZE + 4;
+	auto chunked = MakeLayer(MakeMapData(), ox, oy);
+	auto per_tile = MakeLayer(MakeMapData(), ox, oy);
+
+	auto actual = DrawChunked(*chunked);
+	REQUIRE(Equal(*actual, *DrawPerTile(*per_tile)));
+
+	// Tile (0, 0) is drawn after the wrap
+	auto expected = Bitmap::Create(TILE_SIZE, TILE_SIZE, true);
+	expected->Blit(0, 0, *MakeChipset(), Rect(12 * TILE_SIZE, 0, TILE_SIZE, TILE_SIZE), 255);
+	REQUIRE_EQ(actual->GetColorAt(5 * TILE_SIZE - 8, 3 * TILE_SIZE - 4), expected->GetColorAt(0, 0));
+}
+
+TEST_CASE("ChunksInvalidatedByTileChange") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	DrawableList list;
+	DrawableMgr::SetLocalList(&list);
+	MockGame mg(MockMap::ePass40x30);
+
+	auto layer = MakeLayer(MakeMapData(), 0, 0);
+	auto before = DrawChunked(*layer);
+
+	SUBCASE("new map data") {
+		auto data = MakeMapData();
+		data[5 * map_w + 4] = BLOCK_E + 20;
+		layer->SetMapData(data);
+
+		auto after = DrawChunked(*layer);
+		REQUIRE_FALSE(Equal(*before, *after));
+		REQUIRE(Equal(*after, *DrawPerTile(*MakeLayer(data, 0, 0))));
+	}
+
+	SUBCASE("tile substitution") {
+		// Tile (0, 0) is BLOCK_E + 0
+		REQUIRE_GT(Game_Map::SubstituteDown(0, 20), 0);
+		layer->OnSubstitute();
+
+		auto after = DrawChunked(*layer);
+		REQUIRE_FALSE(Equal(*before, *after));
+		REQUIRE(Equal(*after, *DrawPerTile(*MakeLayer(MakeMapData(), 0, 0))));
+	}
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,38 @@
+#include "worker_pool.h"
+#include "doctest.h"
+#include <atomic>
+
+TEST_SUITE_BEGIN("WorkerPool");
+
+TEST_CASE("RunsAllTasks") {
+	WorkerPool pool(2);
+	std::atomic<int> sum { 0 };
+
+	for (int i = 1; i <= 100; ++i) {
+		pool.Push([&sum, i]() { sum += i; });
+	}
+	pool.WaitIdle();
+
+	REQUIRE_EQ(sum.load(), 5050);
+}
+
+TEST_CASE("DestructorFinishesTasks") {
+	std::atomic<int> count { 0 };
+	{
+		WorkerPool pool(3);
+		for (int i = 0; i < 20; ++i) {
+			pool.Push([&count]() { ++count; });
+		}
+	}
+
+	REQUIRE_EQ(count.load(), 20);
+}
+
+TEST_CASE("WaitIdleOnEmptyPool") {
+	WorkerPool pool(1);
+	pool.WaitIdle();
+
+	REQUIRE(pool.GetThreadCount() <= 1);
+}
+
+TEST_SUITE_END();